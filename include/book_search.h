@@ -0,0 +1,49 @@
+#ifndef BOOK_SEARCH_H
+#define BOOK_SEARCH_H
+
+#include <stddef.h>
+#include "progress.h"
+#include "tablecraft.h"
+
+typedef struct {
+    int row;          /* stored row index in the table */
+    int col;
+    char *text;       /* formatted cell text */
+} BookSearchHit;
+
+typedef struct {
+    char *id;
+    char *name;
+    BookSearchHit *hits;
+    int hit_count;    /* hits kept (at most the per-table cap) */
+    int match_count;  /* all matching cells in the table */
+    char *error;      /* non-NULL when the table could not be loaded */
+    int active;       /* searched in memory: the table passed as active */
+} BookSearchTable;
+
+typedef struct {
+    BookSearchTable *tables; /* manifest order */
+    int table_count;
+    int total_matches;
+} BookSearchResult;
+
+/* Casefolded (text_fold) substring search over every table of the .ttbx
+   book at book_path. Tables are loaded one at a time per worker thread and freed as
+   soon as they are scanned, so at most one table per worker is resident.
+   active (may be NULL) is searched in place instead of its saved copy
+   (active_id), so unsaved edits are found without writing the book; it comes
+   first when the book has no copy of it yet. The caller must not change it
+   during the call. Fails when there is no table to search.
+   Progress is reported from the calling thread only. */
+int book_search_run(const char *book_path,
+                    const Table *active,
+                    const char *active_id,
+                    const char *query,
+                    int max_hits_per_table,
+                    const ProgressReporter *progress,
+                    BookSearchResult *out,
+                    char *err,
+                    size_t err_sz);
+void book_search_result_free(BookSearchResult *result);
+
+#endif /* BOOK_SEARCH_H */
@@ -0,0 +1,30 @@
+#ifndef CELL_ARENA_H
+#define CELL_ARENA_H
+
+#include <stddef.h>
+
+/* Bump allocator for table cells that are created and dropped together
+   (a seek-mode window). Cells are never freed one by one: the whole arena
+   is reset or freed. A Table whose cells may live in an arena records it in
+   Table.arena, and code that drops cells goes through cell_free. */
+typedef struct CellArena CellArena;
+
+/* chunk_size is the first chunk's size; later chunks double up to a cap. */
+CellArena *cell_arena_create(size_t chunk_size);
+void cell_arena_free(CellArena *a);
+/* Forgets every cell but keeps the largest chunk for reuse. */
+void cell_arena_reset(CellArena *a);
+
+/* Pointer-aligned; NULL when out of memory. */
+void *cell_arena_alloc(CellArena *a, size_t size);
+/* Copies len bytes of s and terminates them. */
+char *cell_arena_strndup(CellArena *a, const char *s, size_t len);
+
+int cell_arena_owns(const CellArena *a, const void *p);
+/* Bytes reserved by the arena's chunks. */
+size_t cell_arena_bytes(const CellArena *a);
+
+/* Frees a cell unless it lives in a (a may be NULL). */
+void cell_free(const CellArena *a, void *p);
+
+#endif /* CELL_ARENA_H */
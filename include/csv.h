@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include "tablecraft.h"
 #include "progress.h"
+#include "seekdb.h"
 
 // Load a CSV file into a new Table.
 // If infer_types is true, column types are inferred from data; otherwise all are TYPE_STR.
@@ -16,8 +17,32 @@ Table *csv_load_with_progress(const char *path,
                               size_t err_sz,
                               const ProgressReporter *progress);
 
+// Stream a CSV file into table (created if missing) of an open seekdb without
+// holding the rows in memory. Types are inferred from the first rows only;
+// key names the integer row-id column added for seek views. Returns the
+// number of rows loaded, or -1 and fills err.
+long long csv_stream_to_seekdb(const char *path,
+                               bool infer_types,
+                               seekdb *s,
+                               const char *table,
+                               const char *key,
+                               char *err,
+                               size_t err_sz,
+                               const ProgressReporter *progress);
+
+// Rough peak memory csv_load would need for path, from its size and first
+// rows; 0 when unknown. Used to pick between RAM and the seek view.
+unsigned long long csv_estimate_load_bytes(const char *path);
+
 // Save a Table to CSV at path. Returns 0 on success.
 int csv_save(const Table *table, const char *path, char *err, size_t err_sz);
 
+// Write the current view of s (filter and order included, the row-id key
+// left out) to path, a row at a time from seekdb_scan, so memory stays flat
+// however many rows there are. Fields with commas, quotes or line breaks
+// are quoted. Returns the number of rows written, or -1 and fills err.
+long long csv_export_seekdb(seekdb *s, const char *path, char *err, size_t err_sz,
+                            const ProgressReporter *progress);
+
 #endif // CSV_H
 
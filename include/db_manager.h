@@ -3,6 +3,8 @@
 
 #include <stddef.h>
 #include "tablecraft.h"
+#include "progress.h"
+#include "seekdb.h"
 
 // Opaque manager for SQLite database connections
 typedef struct DbManager DbManager;
@@ -34,11 +36,18 @@ int  db_table_exists(DbManager *db, const char *name);
 
 // Load table from SQLite into a new Table (caller frees via free_table)
 Table* db_load_table(DbManager *db, const char *name, char *err, size_t err_sz);
+// Rough memory db_load_table would need for the table; 0 when unknown
+unsigned long long db_estimate_table_bytes(DbManager *db, const char *name);
 
 // Persist current Table into SQLite (drops/recreates table to match schema)
 int  db_save_table(DbManager *db, const Table *t, char *err, size_t err_sz);
 int  db_export_table_path(const Table *t, const char *path, char *err, size_t err_sz);
 int  db_export_book_path(const char *book_path, const char *path, char *err, size_t err_sz);
+// Copy the current view of s (filter and order included, the row-id key left
+// out) into table_name of a new database at path, a row at a time from
+// seekdb_scan. Returns the number of rows written, or -1 and fills err.
+long long db_export_seekdb(seekdb *s, const char *table_name, const char *path, char *err, size_t err_sz,
+                           const ProgressReporter *progress);
 
 // Search mode is handled in the UI; no DB search API here.
 
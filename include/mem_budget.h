@@ -0,0 +1,24 @@
+#ifndef MEM_BUDGET_H
+#define MEM_BUDGET_H
+
+#include <stddef.h>
+
+/* Process-wide memory budget (a user setting): how much a table loaded
+   into RAM may take before it opens in the seek view instead, and what
+   SQLite caches are sized from. 0 MB means automatic: half of the memory
+   currently available. */
+void mem_budget_set_mb(int mb);
+int mem_budget_mb(void);
+
+/* Budget in bytes; the automatic one is re-read on every call. */
+unsigned long long mem_budget_bytes(void);
+
+/* MemAvailable from /proc/meminfo, else free physical pages; 0 when
+   neither is known. */
+unsigned long long mem_available_bytes(void);
+
+/* 1 when a load estimated at bytes fits the budget; an unknown budget or
+   estimate (0) counts as fitting. */
+int mem_budget_fits(unsigned long long bytes);
+
+#endif /* MEM_BUDGET_H */
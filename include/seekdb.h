@@ -23,46 +23,263 @@ typedef struct seekdb seekdb;
 typedef bool (*seekdb_row_cb)(void *user, sqlite3_stmt *row);
 
 /* Open existing DB (connected mode) if path is SQLite; otherwise create a temp spill DB.
-   - mode: AUTO picks low-ram settings on small machines; override with LOW_RAM or NORMAL.
+   A spill starts on tmpfs ($XDG_RUNTIME_DIR, else /dev/shm) and is copied to
+   disk (build/, else $TMPDIR or /tmp) with the backup API once a bulk load
+   (seekdb_ingest_*) grows it past the in-memory limit (see seekdb_tuning).
+   - mode: AUTO sizes the page cache and mmap from the memory budget (mem_budget.h);
+     LOW_RAM and NORMAL use fixed small / larger caches.
    - err/errlen: optional error buffer (can be NULL). */
 seekdb*  seekdb_open(const char *path_or_null, seekdb_mode_t mode, char *err, size_t errlen);
 
+/* Process-wide SQLite tuning (the seekdb_* settings), applied to
+   connections opened afterwards; a 0 field keeps the mode's default.
+   - cache_mb: page cache per connection.
+   - mmap_mb: memory-mapped reads of the database file; <0 turns them off
+     (AUTO maps part of the memory budget, the other modes none).
+   - page_size: for newly created spill databases, a power of two in
+     512..65536; existing files keep theirs.
+   - spill_mem_mb: how large a spill may grow on tmpfs before it moves to
+     disk; 0 takes 1/4 of the memory budget (at most 1 GiB, and at most half
+     the free tmpfs space), <0 puts spills straight on disk. */
+typedef struct {
+    int cache_mb;
+    int mmap_mb;
+    int page_size;
+    int spill_mem_mb;
+} seekdb_tuning;
+
+void     seekdb_set_tuning(const seekdb_tuning *t);
+void     seekdb_get_tuning(seekdb_tuning *out);
+
+/* Second, read-only connection to the same database file with a copy of the
+   current view (filter, order, key), for reads on another thread; the source
+   must have a view set. WAL lets it read while the source writes. Later
+   set_view calls on the source are not mirrored: open a new reader instead.
+   Not for in-memory databases. Close with seekdb_close. */
+seekdb*  seekdb_open_reader(const seekdb *s, char *err, size_t errlen);
+
 /* Create a table if needed; columns is raw SQL like: "id INTEGER, name TEXT, ...".
    Returns 0 on success, <0 on error. */
 int      seekdb_ensure_table(seekdb *s, const char *table, const char *columns_sql, char *err, size_t errlen);
 
+/* Same from column names (quoted here) and declared types (NULL for none). */
+int      seekdb_ensure_table_columns(seekdb *s, const char *table, const char *const *names, const char *const *decls,
+                                     int count, char *err, size_t errlen);
+
 /* Ensure stable integer key for keyset pagination (adds column + index if missing).
    Returns 0 on success, <0 on error. */
 int      seekdb_ensure_stable_key(seekdb *s, const char *table, const char *key, char *err, size_t errlen);
 
 /* Define/refresh the working VIEW for filter/sort (no data copy).
    order_sql should be your ORDER BY list (without the keyword). The key is auto-appended if missing.
+   Paging seeks on (order terms..., key) in view order; an index on those terms
+   ("_ttb_ord_<table>_<hash>") is created on first use. NULLs sort below
+   every value: first ascending, last descending.
    Returns 0 on success, <0 on error. */
 int      seekdb_set_view(seekdb *s, const char *base_table, const char *where_sql, const char *order_sql,
                          const char *key, char *err, size_t errlen);
 
-/* Windowed reads (seek-only): deliver rows to callback.
+/* Filter/sort specs for seekdb_set_view_spec. Operators follow the table view:
+   contains/equals casefold text (text_fold), regex is case-insensitive, and
+   the ordering operators compare raw values (numerically on numeric columns). */
+typedef enum {
+    SEEKDB_FILTER_CONTAINS = 0,
+    SEEKDB_FILTER_EQUALS,
+    SEEKDB_FILTER_GT,
+    SEEKDB_FILTER_LT,
+    SEEKDB_FILTER_GTE,
+    SEEKDB_FILTER_LTE,
+    SEEKDB_FILTER_REGEX
+} seekdb_filter_op;
+
+typedef struct {
+    const char      *column;
+    seekdb_filter_op op;
+    const char      *value;
+} seekdb_filter;
+
+typedef struct {
+    const char *column;
+    int         desc;
+} seekdb_sort;
+
+/* seekdb_set_view from specs (filter/sort may be NULL). The filter value is
+   bound as a statement parameter, never spliced into SQL. Text columns sort
+   case-insensitively (ASCII NOCASE). Indexes that let the filter or sort seek
+   are created on first use and remembered for the session.
+   Returns 0 on success, <0 on error (bad regex, unknown column, ...). */
+int      seekdb_set_view_spec(seekdb *s, const char *base_table, const seekdb_filter *filter,
+                              const seekdb_sort *sort, const char *key, char *err, size_t errlen);
+
+/* Windowed reads (seek-only): deliver rows to callback. Statements are prepared
+   once per view and reused, so the row passed to cb is only valid during the call.
    - limit: maximum rows to deliver
-   - last_id/first_id: boundary IDs for after/before
+   - last_id/first_id: boundary IDs for after/before (rows that sort after/before them)
+   With a non-key order a boundary row that no longer exists yields 0 rows.
    Returns number of rows delivered, or <0 on error. */
 int      seekdb_seek_first (seekdb *s, int limit, seekdb_row_cb cb, void *user, char *err, size_t errlen);
 int      seekdb_seek_after (seekdb *s, long long last_id, int limit, seekdb_row_cb cb, void *user, char *err, size_t errlen);
 int      seekdb_seek_before(seekdb *s, long long first_id, int limit, seekdb_row_cb cb, void *user, char *err, size_t errlen);
 int      seekdb_seek_by_id (seekdb *s, long long target_id, int limit, seekdb_row_cb cb, void *user, char *err, size_t errlen);
 
-/* Utility: count rows in current view (may be slow on very large tables). */
+/* Exact row count of the current view. Runs COUNT(*) (slow on very large
+   tables) unless a count is cached: counts are kept until the next commit to
+   the database (by any connection) or view change. */
 long long seekdb_count(seekdb *s, char *err, size_t errlen);
 
+/* Row count without scanning: the cached count if there is one, else for an
+   unfiltered view an estimate from sqlite_stat1 or the table's rowid span.
+   *exact (optional) tells which. Returns <0 when unknown (a filtered view
+   nobody has counted yet). */
+long long seekdb_count_estimate(seekdb *s, int *exact);
+
+/* Caches rows as the exact count of the current view, e.g. one counted on a
+   reader in the background (see seekdb_checkpoints_rows). */
+void     seekdb_count_store(seekdb *s, long long rows);
+
+/* File of the database (a spill's too); "" for an in-memory one. */
+const char *seekdb_filename(const seekdb *s);
+
 /* Save ephemeral DB to a permanent file. */
 int      seekdb_save_as(seekdb *s, const char *dest_path, char *err, size_t errlen);
 
 /* Close and cleanup. */
 void     seekdb_close(seekdb *s);
 
-/* View metadata: returns a heap-allocated array of column names for current view.
+/* View metadata: returns a heap-allocated array of column names for current view
+   (every column of the base table, whatever the projection).
    Caller must free each name and the array itself. Returns count (>0) or <0 on error. */
 int      seekdb_get_view_columns(seekdb *s, char ***names_out, char *err, size_t errlen);
 
+/* Declared types of the view's columns, as in the base table's schema ("" for
+   none); same order and ownership as seekdb_get_view_columns. */
+int      seekdb_get_view_column_types(seekdb *s, char ***types_out, char *err, size_t errlen);
+
+/* Index of the view's key column in seekdb_get_view_columns, or <0. */
+int      seekdb_view_key_column(seekdb *s, char *err, size_t errlen);
+
+/* Every row of the current view in view order, with every column (as
+   seekdb_get_view_columns; the projection does not apply), from a single
+   statement, so the rows are one snapshot however long cb takes. Meant for
+   exports: run it on a reader to keep the writer free. The row passed to cb
+   is only valid during the call; cb returns false to stop.
+   Returns the number of rows delivered, or <0 on error (or interrupt). */
+long long seekdb_scan(seekdb *s, seekdb_row_cb cb, void *user, char *err, size_t errlen);
+
+/* Column count of the current view (cached with the names; no query runs).
+   Returns count or <0 on error. */
+int      seekdb_view_column_count(seekdb *s, char *err, size_t errlen);
+
+/* Restricts window reads (seekdb_seek_*) to some columns: cols are indexes
+   into seekdb_get_view_columns, and rows then hold exactly those columns in
+   that order (include the key to read ids). count 0 selects every column
+   again. The window statements are prepared for the current column set and
+   re-prepared when it changes; other statements are unaffected. The set is
+   kept across view changes on the same base table and copied to readers.
+   Returns 0 on success, <0 on error. */
+int      seekdb_set_projection(seekdb *s, const int *cols, int count, char *err, size_t errlen);
+
+/* Keyed writes to the current view's base table. Values are text (NULL
+   for SQL NULL) and take the column's affinity, so "42" lands as an
+   integer in an INTEGER column. Each call is a transaction of its own
+   unless made between seekdb_write_begin and seekdb_write_commit, which
+   batch any number of writes into one (calls nest; a failed write leaves
+   the batch open for the caller to commit or roll back). Indexes and the
+   FTS shadow index follow the rows; the cached count is kept when the
+   change to it is known (unfiltered views) and dropped otherwise.
+   Returns 0 on success, <0 on error. */
+int      seekdb_write_begin(seekdb *s, char *err, size_t errlen);
+int      seekdb_write_commit(seekdb *s, char *err, size_t errlen);
+void     seekdb_write_rollback(seekdb *s);
+
+/* Sets column col (an index into seekdb_get_view_columns) of row id. The
+   key column cannot be changed. */
+int      seekdb_update_cell(seekdb *s, long long id, int col, const char *value, char *err, size_t errlen);
+/* Adds a row with one value per view column (count must match); the key
+   slot is ignored and the row gets the next free key, stored in *id_out. */
+int      seekdb_insert_row(seekdb *s, const char *const *values, int count, long long *id_out,
+                           char *err, size_t errlen);
+int      seekdb_delete_row(seekdb *s, long long id, char *err, size_t errlen);
+
+/* Bulk load into an existing table (e.g. made with seekdb_ensure_table):
+   begin with the columns each row fills, append rows, then commit. Rows
+   go through one cached INSERT in transactions of many rows, with syncing
+   off while loading (a spill database also drops its journal, so an
+   aborted load may leave rows of earlier batches behind). When key is
+   given, rows get increasing integers in that column (added if missing)
+   and its unique index, like seekdb_ensure_stable_key's, is built once at
+   commit, as is the current view's order index when table is its base.
+   No other writes may run during a load.
+   append_row takes count values (NULL for SQL NULL), only read during the
+   call. commit returns the number of rows loaded, or <0 on error; abort
+   rolls back the batch in progress. */
+int      seekdb_ingest_begin(seekdb *s, const char *table, const char *const *columns, int count, const char *key,
+                             char *err, size_t errlen);
+int      seekdb_ingest_append_row(seekdb *s, const char *const *values, char *err, size_t errlen);
+long long seekdb_ingest_commit(seekdb *s, char *err, size_t errlen);
+void     seekdb_ingest_abort(seekdb *s);
+
+/* Value to load for text in a BOOLEAN column: "1" for "true", "0" for
+   "false" (any case), anything else unchanged, so a value the type was not
+   inferred for keeps its text instead of turning into false. */
+const char *seekdb_bool_value(const char *text);
+
+/* Whether a declared column type marks booleans: contains "BOOL" in any
+   case, as BOOLEAN does. Such columns have NUMERIC affinity, so check this
+   before the affinity rules. */
+int      seekdb_decl_is_bool(const char *decl);
+
+/* Full-text search over the current view's base table. A shadow FTS5 index
+   (trigram tokenizer, "_ttb_fts_<table>") is built on first use and kept in
+   sync by triggers afterwards. Index and triggers are TEMP objects of this
+   connection: the database file is not changed (read-only files work), and
+   each session builds the index again. Queries are case-insensitive
+   substring matches; queries shorter than three characters fall back to a
+   LIKE scan.
+   Returns 0 on success, <0 on error. */
+int      seekdb_fts_ensure(seekdb *s, char *err, size_t errlen);
+
+/* Matching key ids after last_id in view order (or before first_id, nearest
+   first). Rows outside the view filter are skipped. LLONG_MIN/LLONG_MAX (or a
+   boundary row that no longer exists) start from the first/last match.
+   Returns number of ids written (<= limit), or <0 on error. */
+int      seekdb_fts_search       (seekdb *s, const char *query, long long last_id, int limit, long long *ids_out,
+                                  char *err, size_t errlen);
+int      seekdb_fts_search_before(seekdb *s, const char *query, long long first_id, int limit, long long *ids_out,
+                                  char *err, size_t errlen);
+
+/* Number of view rows matching query, or <0 on error. */
+long long seekdb_fts_count(seekdb *s, const char *query, char *err, size_t errlen);
+
+/* Number of view rows that sort before row id (0-based position), or <0 on error. */
+long long seekdb_rank_of_id(seekdb *s, long long id, char *err, size_t errlen);
+
+/* Sparse position index over the current view: the key of every stride-th
+   row in view order, plus the row total. Building reads the whole view
+   (keys only), so run it on a reader (seekdb_open_reader) off the UI thread;
+   seekdb_interrupt aborts it. The index describes the view as it was when
+   built: rebuild after the view or its rows change. The ids are plain keys,
+   so an index built on a reader can be used with the source handle.
+   Returns NULL on error or when interrupted. */
+typedef struct seekdb_checkpoints seekdb_checkpoints;
+seekdb_checkpoints *seekdb_checkpoints_build(seekdb *s, int stride, char *err, size_t errlen);
+void      seekdb_checkpoints_free(seekdb_checkpoints *cp);
+/* Row total of the view when cp was built, or <0 for NULL. */
+long long seekdb_checkpoints_rows(const seekdb_checkpoints *cp);
+
+/* Key of the row at 0-based position pos: the nearest checkpoint, then at
+   most stride-1 rows skipped. Returns 1 when found, 0 past the end (or when
+   the checkpoint row is gone), <0 on error. */
+int       seekdb_id_at_position(seekdb *s, const seekdb_checkpoints *cp, long long pos, long long *id_out,
+                                char *err, size_t errlen);
+/* 0-based position of row id, like seekdb_rank_of_id but by bisecting the
+   checkpoints and counting at most stride rows. cp may be NULL (full count).
+   Returns <0 on error. */
+long long seekdb_position_of_id(seekdb *s, const seekdb_checkpoints *cp, long long id, char *err, size_t errlen);
+
+/* Aborts the query running on s; safe to call from another thread. */
+void      seekdb_interrupt(seekdb *s);
+
 #ifdef __cplusplus
 }
 #endif
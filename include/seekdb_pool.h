@@ -0,0 +1,47 @@
+#ifndef SEEKDB_POOL_H
+#define SEEKDB_POOL_H
+
+#include "seekdb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A few worker threads, each with its own read-only connection
+   (seekdb_open_reader) over the view of one writer, for background reads
+   (prefetch, counts, position index, export) that should not wait behind
+   the writer's window fetches. WAL lets them all read while it writes. */
+typedef struct seekdb_pool seekdb_pool;
+
+/* Runs on a worker with that worker's reader. reader is NULL when the job
+   is cancelled before it starts (seekdb_pool_cancel/reset/close): the job
+   only releases arg then. Jobs start in submission order. */
+typedef void (*seekdb_job_fn)(seekdb *reader, void *arg);
+
+/* Opens readers over the current view of s (which must have one) and
+   starts their workers. NULL on error. */
+seekdb_pool *seekdb_pool_open(const seekdb *s, int readers, char *err, size_t errlen);
+
+/* Queues a job. Returns its id (>0), or <0 on error. */
+long long seekdb_pool_submit(seekdb_pool *p, seekdb_job_fn fn, void *arg);
+
+/* Cancels a queued job, or interrupts the statement of a running one (its
+   seekdb calls fail with an interrupt error). No-op for finished jobs. */
+void seekdb_pool_cancel(seekdb_pool *p, long long id);
+
+/* The view of s changed: cancels every job and gives each worker a reader
+   over the new view before its next job. Returns <0 (and keeps the old
+   readers) when they cannot be opened. */
+int seekdb_pool_reset(seekdb_pool *p, const seekdb *s, char *err, size_t errlen);
+
+/* Blocks until no job is queued or running. */
+void seekdb_pool_wait(seekdb_pool *p);
+
+/* Cancels every job, joins the workers and closes the readers. */
+void seekdb_pool_close(seekdb_pool *p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEEKDB_POOL_H */
@@ -3,6 +3,8 @@
 
 #include <stdbool.h>
 
+#define SEEK_CACHE_DEFAULT_MB 16
+
 typedef struct {
     int table_name_color;
     int table_hint_color;
@@ -16,7 +18,15 @@ typedef struct {
     bool autosave_enabled;
     bool type_infer_enabled;
     bool low_ram_enabled;   // use seek-only paging for large tables
+    bool low_ram_auto;      // pick seek paging per table when it would exceed the memory budget
+    bool fold_accents;      // search/sort ignore accents (e.g. "e" matches "é")
     bool show_row_gutter;   // show row number gutter in grid
+    int seek_cache_mb;      // budget for cached seek-mode windows (0 = off)
+    int memory_budget_mb;   // RAM a loaded table may take (0 = half of available memory)
+    int seekdb_cache_mb;    // SQLite page cache per connection (0 = by mode/budget)
+    int seekdb_mmap_mb;     // memory-mapped reads (0 = by mode/budget, <0 = off)
+    int seekdb_page_size;   // page size of new spill databases (0 = SQLite default)
+    int seekdb_spill_mem_mb; // spill size kept in RAM before moving to disk (0 = by budget, <0 = disk only)
     int theme_id;
 } AppSettings;
 
@@ -10,7 +10,8 @@ typedef enum {
     FILTER_GT,
     FILTER_LT,
     FILTER_GTE,
-    FILTER_LTE
+    FILTER_LTE,
+    FILTER_REGEX
 } FilterOp;
 
 typedef struct {
@@ -25,6 +26,7 @@ typedef struct {
 
     int filter_active;
     int sort_active;
+    int pushed_down; /* the row source applies the spec (low-RAM seek view); rows pass through */
 
     int sort_col;
     int sort_desc;
@@ -0,0 +1,33 @@
+#ifndef TABLE_VTAB_H
+#define TABLE_VTAB_H
+
+#include <stddef.h>
+#include <sqlite3.h>
+#include "tablecraft.h"
+
+// Read-only SQLite virtual tables ("ttb_table" module) over in-memory
+// Tables: SQL reads the cells in place, nothing is copied into SQLite.
+// Columns are declared with their DataType's affinity (INTEGER, REAL,
+// BOOLEAN, TEXT) and rowid is the 1-based stored row; rowid ranges and
+// column equality are checked by the module before SQLite sees a row.
+// Rows and cells are read live, so edits between queries show up; after
+// adding, removing or retyping columns, attach the table again.
+
+// Tables attached on one connection; owned by the connection
+typedef struct TableVtabModule TableVtabModule;
+
+// Registers the module on db (once per connection). NULL on error.
+TableVtabModule *table_vtab_register(sqlite3 *db, char *err, size_t err_sz);
+// Creates temp.<name> over table; table must outlive it (until
+// table_vtab_detach or sqlite3_close). Names are case-insensitive, as in SQL.
+int   table_vtab_attach(TableVtabModule *m, const char *name, const Table *table, char *err, size_t err_sz);
+int   table_vtab_detach(TableVtabModule *m, const char *name, char *err, size_t err_sz);
+
+// Runs one read-only statement over the given tables (each attached under
+// its own name; tables without columns and later duplicates of a name are
+// skipped) on a private in-memory connection and returns the result as a
+// new Table named result_name (caller frees via free_table). NULL on error.
+Table *table_sql_query(const char *sql, const Table *const *tables, int count, const char *result_name,
+                       char *err, size_t err_sz);
+
+#endif // TABLE_VTAB_H
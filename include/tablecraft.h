@@ -13,6 +13,11 @@ typedef struct {
     char *name;
     DataType type;
     int color_pair_id;
+    // Casefolded search/sort keys for TYPE_STR cells, built on demand (see
+    // table_fold_keys_ensure). A NULL entry means the raw text is its own key.
+    char **fold_keys;
+    int fold_key_count;  // rows covered; 0 when not built
+    int fold_flags;      // text_fold flags the keys were built with
 } Column;
 
 typedef struct {
@@ -30,6 +35,9 @@ typedef struct {
     int capacity_columns;
     int capacity_rows;
     int dirty;
+    // Arena holding (some of) the cells, e.g. a seek-mode window; NULL when
+    // every cell is its own allocation. Drop cells with cell_free.
+    struct CellArena *arena;
 } Table;
 
 Table *create_table(const char *name);
@@ -40,6 +48,13 @@ int replace_table_contents(Table *dest, Table *src);
 int add_column(Table *table, const char *name, DataType type);
 int add_row(Table *table, const char **input_strings);
 
+int table_fold_keys_ensure(Table *table, int col);
+// Key for a TYPE_STR cell (NULL for empty cells or other types); only folded
+// once table_fold_keys_ensure has run for the column.
+const char *table_fold_key(const Table *table, int row, int col);
+void table_update_fold_key(Table *table, int row, int col); // after a cell edit
+void table_invalidate_fold_keys(Table *table, int col); // col < 0: every column
+
 const char *type_to_string(DataType type);
 DataType parse_type_from_string(const char *str);
 
@@ -0,0 +1,35 @@
+#ifndef TEXT_FOLD_H
+#define TEXT_FOLD_H
+
+#include <stddef.h>
+
+/* UTF-8 case folding for search and sort keys. Covers ASCII, Latin-1,
+   Latin Extended-A/Additional, Greek and Cyrillic; other code points and
+   invalid bytes pass through unchanged. Folded keys compare bytewise in
+   code point order. */
+enum {
+    TEXT_FOLD_STRIP_ACCENTS = 1 << 0  /* also map accented letters to their base */
+};
+
+/* Process-wide flags used for table keys and searches (a user setting). */
+void text_fold_set_default_flags(int flags);
+int text_fold_default_flags(void);
+
+/* Folds text into out (always NUL-terminated, truncated on a code point
+   boundary). Returns the folded length in bytes, even if truncated. */
+size_t text_fold_into(const char *text, int flags, char *out, size_t out_sz);
+/* Returns a malloc'd folded copy, or NULL when the key equals the input
+   (so callers can keep using the raw text) or on allocation failure. */
+char *text_fold_dup(const char *text, int flags, int *out_oom);
+
+/* Finds folded needle in text. hay_key is text already folded with the
+   same flags (NULL to fold on the fly). On a match returns 1 and maps the
+   hit back to a byte range of the raw text. */
+int text_fold_find(const char *text, const char *hay_key, const char *needle_key, int flags,
+                   int *match_start, int *match_len);
+/* Maps key_len bytes at key_start of text's folded key back to a byte
+   range of the raw text (whole code points). */
+void text_fold_map_range(const char *text, int flags, size_t key_start, size_t key_len,
+                         int *match_start, int *match_len);
+
+#endif /* TEXT_FOLD_H */
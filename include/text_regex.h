@@ -0,0 +1,21 @@
+#ifndef TEXT_REGEX_H
+#define TEXT_REGEX_H
+
+#include <stddef.h>
+
+/* Regular expressions compiled once to a Thompson NFA and simulated
+   breadth-first, so matching is linear in the text (no backtracking).
+   Syntax: literals, '.', [...] / [^...] classes, \d \w \s (and \D \W \S),
+   ( ), (?: ), |, *, +, ?, {m}, {m,}, {m,n}, ^ and $. Matches are
+   leftmost-longest. With icase, non-ASCII text and pattern literals are
+   casefolded like plain search (text_fold with the default flags taken at
+   compile time) and offsets map back to the raw text. A handle carries
+   scratch state: use one per thread. */
+typedef struct TextRegex TextRegex;
+
+TextRegex *text_regex_compile(const char *pattern, int icase, char *err, size_t err_sz);
+/* Returns 1 on a match (filling start/len when non-NULL), 0 otherwise. */
+int text_regex_search(TextRegex *re, const char *text, int *match_start, int *match_len);
+void text_regex_free(TextRegex *re);
+
+#endif /* TEXT_REGEX_H */
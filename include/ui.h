@@ -5,14 +5,17 @@
 #include "tablecraft.h"
 #include "table_view.h"
 #include "settings.h"
+#include "progress.h"
 
 // Global UI state (defined in ui_loop.c)
 extern int editing_mode;
 extern int cursor_row;
 extern int cursor_col;
 extern int search_mode; // 1 when search navigation is active
-extern int search_hit_count;   // total number of matches
-extern int search_hit_index;   // current match index (0-based)
+extern int search_hit_count;   // matches counted so far
+extern int search_count_done;  // 1 once search_hit_count is the final total
+extern int search_db_wide;     // 1 when search spans the seek-mode database (counts rows)
+extern int search_hit_index;   // current match index (0-based, -1 if unknown)
 extern int search_sel_start;   // start index of current match within cell
 extern int search_sel_len;     // length of current match
 extern char search_query[128]; // current search text (for highlighting)
@@ -26,6 +29,7 @@ extern int rows_visible;  // number of visible rows on current page
 extern int total_row_pages; // total row pages
 // Performance mode
 extern int low_ram_mode; // when 1, UI fetches windows via seekdb
+extern int low_ram_auto; // when 1, only tables over the memory budget (mem_budget.h) do
 extern int row_gutter_enabled; // show/hide row number gutter
 extern int footer_page;
 // Destructive selection modes inside edit mode
@@ -78,6 +82,7 @@ void show_table_menu(Table *table);
 void prompt_sort_rows(Table *table);
 void prompt_filter_rows(Table *table);
 void clear_table_view_prompt(Table *table);
+void prompt_goto_row(Table *table);
 UiMenuResult show_export_menu(Table *table);
 void prompt_rename_table(Table *table);
 UiMenuResult show_settings_menu(void);
@@ -94,11 +99,52 @@ int show_text_input_modal(const char *title,
 // Seek-mode helpers (for low-RAM browsing)
 int seek_mode_active(void);
 int seek_mode_open_for_table(const char *db_path, const char *table_name, Table *view, int page_size, char *err, size_t err_sz);
+// Stream a CSV file / the first XLSX worksheet into a spill database and
+// open the seek view over it
+int seek_mode_open_csv(const char *path, bool infer_types, Table *view, int page_size,
+                       const ProgressReporter *progress, char *err, size_t err_sz);
+int seek_mode_open_xlsx(const char *path, bool infer_types, Table *view, int page_size,
+                        const ProgressReporter *progress, char *err, size_t err_sz);
 int seek_mode_fetch_first(Table *view, int page_size, char *err, size_t err_sz);
 int seek_mode_fetch_next(Table *view, int page_size, char *err, size_t err_sz);
 int seek_mode_fetch_prev(Table *view, int page_size, char *err, size_t err_sz);
 long long seek_mode_row_base(void);
+// Whole-database search via the seekdb FTS index
+int seek_mode_search_prepare(char *err, size_t err_sz);
+long long seek_mode_search_count(const char *query, char *err, size_t err_sz);
+int seek_mode_search_jump(Table *view, const char *query, int dir, int page_size, int *wrapped, char *err, size_t err_sz);
 int seek_mode_last_count(void);
+// Filter/sort the seek view in SQLite from a TableView spec, then reload the first window
+int seek_mode_apply_view(Table *view, const TableView *spec, int page_size, char *err, size_t err_sz);
+// Row total from the checkpoint index (<0 while it is being built) and
+// jumps to a 1-based row number (clamped to the view)
+long long seek_mode_row_total(void);
+// Rows in the view without blocking: exact once counted in the background,
+// else an estimate (*exact = 0), <0 while unknown
+long long seek_mode_row_count(int *exact);
+int seek_mode_goto_row(Table *view, long long row, int page_size, char *err, size_t err_sz);
+// LRU cache of recently shown windows; shrinking the budget evicts at once
+void seek_mode_set_cache_budget(size_t bytes);
+void seek_mode_cache_stats(long long *hits, long long *misses, size_t *bytes);
+// Makes sure the current window holds columns [first, first+count);
+// returns 1 when it was refetched (redraw), 0 when nothing changed, -1 on error
+int seek_mode_show_columns(Table *view, int first, int count, int page_size, char *err, size_t err_sz);
+int seek_mode_column_loaded(int col);
+// Edits in the seek view, written through to SQLite by row key; the window
+// is patched in place. value NULL clears the cell. values holds one string
+// per column (the key's is ignored: new rows get the next key).
+int seek_mode_key_column(void);
+int seek_mode_set_cell(Table *view, int row, int col, const char *value, char *err, size_t err_sz);
+int seek_mode_insert_row(Table *view, int row, const char **values, char *err, size_t err_sz);
+int seek_mode_delete_row(Table *view, int row, char *err, size_t err_sz);
+// Export the whole seek view (filter and order, without the row key) row by
+// row on a background reader, forwarding progress; name is the sheet/table
+// name. Return the number of rows written, or -1 and fill err.
+long long seek_mode_export_csv(const char *path, const ProgressReporter *progress, char *err, size_t err_sz);
+long long seek_mode_export_xlsx(const char *name, const char *path, const ProgressReporter *progress,
+                                char *err, size_t err_sz);
+long long seek_mode_export_db(const char *name, const char *path, const ProgressReporter *progress,
+                              char *err, size_t err_sz);
 void seek_mode_close(void);
 
 // UI loop function
@@ -109,5 +155,7 @@ int ui_actual_row_for_visible(Table *table, int visible_row);
 int ui_rebuild_table_view(Table *table, char *err, size_t err_sz);
 int ui_table_view_is_active(void);
 int ui_format_cell_value(const Table *table, int row, int col, char *buf, size_t buf_sz);
+// Enter search navigation for query with the cursor on a known hit (visible row)
+void ui_search_select_cell(Table *table, const char *query, int row, int col);
 
 #endif // UI_H
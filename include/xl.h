@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include "tablecraft.h"
 #include "progress.h"
+#include "seekdb.h"
 
 Table *xl_load(const char *path, bool infer_types, char *err, size_t err_sz);
 Table *xl_load_with_progress(const char *path,
@@ -12,6 +13,32 @@ Table *xl_load_with_progress(const char *path,
                              char *err,
                              size_t err_sz,
                              const ProgressReporter *progress);
+/* Rough peak memory xl_load would need for path, from the archive's
+   uncompressed sizes; 0 when unknown. */
+unsigned long long xl_estimate_load_bytes(const char *path);
+/* Streams the first worksheet into table of an open seekdb, inflating and
+   parsing it a chunk at a time (shared strings are still read whole).
+   Types are inferred from the first rows; key as in csv_stream_to_seekdb.
+   Returns the number of rows loaded, or -1 and fills err. */
+long long xl_stream_to_seekdb(const char *path,
+                              bool infer_types,
+                              seekdb *s,
+                              const char *table,
+                              const char *key,
+                              char *err,
+                              size_t err_sz,
+                              const ProgressReporter *progress);
 int xl_save(const Table *table, const char *path, char *err, size_t err_sz);
+/* Writes the current view of s (filter and order included, the row-id key
+   left out) as a one-sheet workbook, a row at a time from seekdb_scan, so
+   memory stays flat: the sheet is stored, not compressed, and limited to
+   what one sheet and a 32-bit archive hold. Returns the number of rows
+   written, or -1 and fills err (removing the partial file). */
+long long xl_export_seekdb(seekdb *s,
+                           const char *sheet_name,
+                           const char *path,
+                           char *err,
+                           size_t err_sz,
+                           const ProgressReporter *progress);
 
 #endif /* XL_H */
@@ -0,0 +1,255 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "book_search.h"
+#include "tablecraft.h"
+#include "text_fold.h"
+#include "ttb_io.h"
+
+#define BOOK_SEARCH_MAX_WORKERS 8
+
+typedef struct {
+    const char *book_path;
+    char query_key[256]; /* query folded with fold_flags */
+    int fold_flags;
+    int max_hits;
+    const Table *active; /* scanned for the slot marked active */
+    BookSearchTable *tables;
+    int table_count;
+
+    pthread_mutex_t lock;
+    pthread_cond_t progress;
+    int next;   /* next table to claim */
+    int done;   /* tables finished */
+} SearchJob;
+
+static void set_err(char *err, size_t err_sz, const char *msg)
+{
+    if (!err || err_sz == 0 || !msg) return;
+    strncpy(err, msg, err_sz - 1);
+    err[err_sz - 1] = '\0';
+}
+
+/* Same text the grid shows, so hits agree with the in-table search. */
+static void format_cell(const Table *table, int row, int col, char *buf, size_t buf_sz)
+{
+    void *v = table->rows[row].values ? table->rows[row].values[col] : NULL;
+
+    buf[0] = '\0';
+    if (!v) return;
+    switch (table->columns[col].type) {
+        case TYPE_INT:
+            snprintf(buf, buf_sz, "%d", *(int *)v);
+            break;
+        case TYPE_FLOAT:
+            snprintf(buf, buf_sz, "%.2f", *(float *)v);
+            break;
+        case TYPE_BOOL:
+            snprintf(buf, buf_sz, "%s", (*(int *)v) ? "true" : "false");
+            break;
+        default:
+            snprintf(buf, buf_sz, "%s", (char *)v);
+            break;
+    }
+}
+
+static void scan_table(SearchJob *job, const Table *table, BookSearchTable *slot)
+{
+    char buf[128];
+
+    for (int r = 0; r < table->row_count; ++r) {
+        for (int c = 0; c < table->column_count; ++c) {
+            format_cell(table, r, c, buf, sizeof(buf));
+            if (buf[0] == '\0' || !text_fold_find(buf, NULL, job->query_key, job->fold_flags, NULL, NULL)) continue;
+            slot->match_count++;
+            if (slot->hit_count >= job->max_hits) continue;
+            if (!slot->hits) {
+                slot->hits = calloc((size_t)job->max_hits, sizeof(BookSearchHit));
+                if (!slot->hits) break;
+            }
+            slot->hits[slot->hit_count].row = r;
+            slot->hits[slot->hit_count].col = c;
+            slot->hits[slot->hit_count].text = strdup(buf);
+            slot->hit_count++;
+        }
+    }
+}
+
+static void search_one_table(SearchJob *job, BookSearchTable *slot)
+{
+    char err[256] = {0};
+    Table *table;
+
+    if (slot->active) {
+        scan_table(job, job->active, slot);
+        return;
+    }
+    table = ttbx_load_table(job->book_path, slot->id, err, sizeof(err));
+    if (!table) {
+        slot->error = strdup(err[0] ? err : "Failed to load table");
+        return;
+    }
+    scan_table(job, table, slot);
+    free_table(table);
+}
+
+static void *search_worker(void *arg)
+{
+    SearchJob *job = arg;
+
+    for (;;) {
+        int idx;
+
+        pthread_mutex_lock(&job->lock);
+        idx = (job->next < job->table_count) ? job->next++ : -1;
+        pthread_mutex_unlock(&job->lock);
+        if (idx < 0) break;
+
+        search_one_table(job, &job->tables[idx]);
+
+        pthread_mutex_lock(&job->lock);
+        job->done++;
+        pthread_cond_signal(&job->progress);
+        pthread_mutex_unlock(&job->lock);
+    }
+    return NULL;
+}
+
+static int worker_count_for(int table_count)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int n = (cpus > 0) ? (int)cpus : 1;
+
+    if (n > BOOK_SEARCH_MAX_WORKERS) n = BOOK_SEARCH_MAX_WORKERS;
+    if (n > table_count) n = table_count;
+    return n < 1 ? 1 : n;
+}
+
+int book_search_run(const char *book_path,
+                    const Table *active,
+                    const char *active_id,
+                    const char *query,
+                    int max_hits_per_table,
+                    const ProgressReporter *progress,
+                    BookSearchResult *out,
+                    char *err,
+                    size_t err_sz)
+{
+    TtbxManifest manifest;
+    SearchJob job;
+    pthread_t workers[BOOK_SEARCH_MAX_WORKERS];
+    int started = 0;
+    int reported = -1;
+    int saved_active = -1; /* manifest index of the active table's copy */
+    int first = 0;         /* slot of the first manifest table */
+
+    if (!book_path || !query || !out || max_hits_per_table <= 0) {
+        set_err(err, err_sz, "Invalid arguments");
+        return -1;
+    }
+    memset(out, 0, sizeof(*out));
+    if (ttbx_manifest_load(book_path, &manifest, err, err_sz) != 0) return -1;
+
+    for (int i = 0; active && active_id && *active_id && i < manifest.table_count; ++i) {
+        if (strcmp(manifest.tables[i].id, active_id) == 0) saved_active = i;
+    }
+    if (active && saved_active < 0) first = 1;
+    if (first + manifest.table_count == 0) {
+        ttbx_manifest_free(&manifest);
+        set_err(err, err_sz, "The book has no tables to search");
+        return -1;
+    }
+
+    out->tables = calloc((size_t)(first + manifest.table_count), sizeof(BookSearchTable));
+    if (!out->tables) {
+        ttbx_manifest_free(&manifest);
+        set_err(err, err_sz, "Out of memory");
+        return -1;
+    }
+    out->table_count = first + manifest.table_count;
+    if (first) {
+        /* Not saved to the book yet */
+        out->tables[0].id = strdup(active_id ? active_id : "");
+        out->tables[0].name = strdup(active->name ? active->name : "Active table");
+        out->tables[0].active = 1;
+    }
+    for (int i = 0; i < manifest.table_count; ++i) {
+        BookSearchTable *slot = &out->tables[first + i];
+        slot->id = strdup(manifest.tables[i].id);
+        slot->name = strdup(manifest.tables[i].name ? manifest.tables[i].name : manifest.tables[i].id);
+        slot->active = (i == saved_active);
+    }
+    ttbx_manifest_free(&manifest);
+    for (int i = 0; i < out->table_count; ++i) {
+        if (!out->tables[i].id || !out->tables[i].name) {
+            book_search_result_free(out);
+            set_err(err, err_sz, "Out of memory");
+            return -1;
+        }
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.book_path = book_path;
+    job.fold_flags = text_fold_default_flags();
+    text_fold_into(query, job.fold_flags, job.query_key, sizeof(job.query_key));
+    job.max_hits = max_hits_per_table;
+    job.active = active;
+    job.tables = out->tables;
+    job.table_count = out->table_count;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.progress, NULL);
+
+    int want = worker_count_for(job.table_count);
+    for (int i = 0; i < want; ++i) {
+        if (pthread_create(&workers[started], NULL, search_worker, &job) != 0) break;
+        started++;
+    }
+    if (started == 0) {
+        /* No threads available: scan on the calling thread instead. */
+        search_worker(&job);
+    }
+
+    pthread_mutex_lock(&job.lock);
+    for (;;) {
+        int done = job.done;
+        if (done != reported && progress && progress->update) {
+            char msg[96];
+            reported = done;
+            snprintf(msg, sizeof(msg), "Searched %d of %d tables", done, job.table_count);
+            pthread_mutex_unlock(&job.lock);
+            progress->update(progress->ctx, (double)done / (double)job.table_count, msg);
+            pthread_mutex_lock(&job.lock);
+            continue;
+        }
+        if (job.done >= job.table_count) break;
+        pthread_cond_wait(&job.progress, &job.lock);
+    }
+    pthread_mutex_unlock(&job.lock);
+
+    for (int i = 0; i < started; ++i) pthread_join(workers[i], NULL);
+    pthread_cond_destroy(&job.progress);
+    pthread_mutex_destroy(&job.lock);
+
+    for (int i = 0; i < out->table_count; ++i) {
+        out->total_matches += out->tables[i].match_count;
+    }
+    return 0;
+}
+
+void book_search_result_free(BookSearchResult *result)
+{
+    if (!result) return;
+    for (int i = 0; i < result->table_count; ++i) {
+        BookSearchTable *t = &result->tables[i];
+        for (int h = 0; h < t->hit_count; ++h) free(t->hits[h].text);
+        free(t->hits);
+        free(t->id);
+        free(t->name);
+        free(t->error);
+    }
+    free(result->tables);
+    memset(result, 0, sizeof(*result));
+}
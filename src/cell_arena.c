@@ -0,0 +1,125 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cell_arena.h"
+
+#define CELL_ARENA_ALIGN sizeof(void *)
+#define CELL_ARENA_MAX_CHUNK ((size_t)256 << 10)
+
+typedef struct CellChunk {
+    struct CellChunk *next; /* older chunk */
+    size_t size;
+    size_t used;
+    union { void *p; double d; long long ll; } data[]; /* aligned start */
+} CellChunk;
+
+struct CellArena {
+    CellChunk *head;  /* chunk being filled */
+    size_t next_size; /* size of the next regular chunk */
+    size_t bytes;
+};
+
+static CellChunk *chunk_new(size_t size)
+{
+    CellChunk *c = malloc(sizeof(CellChunk) + size);
+    if (!c) return NULL;
+    c->next = NULL;
+    c->size = size;
+    c->used = 0;
+    return c;
+}
+
+CellArena *cell_arena_create(size_t chunk_size)
+{
+    CellArena *a = calloc(1, sizeof(CellArena));
+    if (!a) return NULL;
+    a->next_size = chunk_size ? chunk_size : 4096;
+    return a;
+}
+
+void cell_arena_free(CellArena *a)
+{
+    if (!a) return;
+    while (a->head) {
+        CellChunk *next = a->head->next;
+        free(a->head);
+        a->head = next;
+    }
+    free(a);
+}
+
+void cell_arena_reset(CellArena *a)
+{
+    CellChunk *keep = NULL;
+
+    if (!a) return;
+    for (CellChunk *c = a->head, *next; c; c = next) {
+        next = c->next;
+        if (!keep || c->size > keep->size) {
+            free(keep);
+            keep = c;
+        } else {
+            free(c);
+        }
+    }
+    a->head = keep;
+    a->bytes = 0;
+    if (keep) {
+        keep->next = NULL;
+        keep->used = 0;
+        a->bytes = keep->size;
+    }
+}
+
+void *cell_arena_alloc(CellArena *a, size_t size)
+{
+    CellChunk *c = a->head;
+
+    size = (size + CELL_ARENA_ALIGN - 1) & ~(CELL_ARENA_ALIGN - 1);
+    if (!c || c->size - c->used < size) {
+        size_t want = a->next_size;
+        if (want < size) want = size; /* oversized cell: a chunk of its own */
+        c = chunk_new(want);
+        if (!c) return NULL;
+        c->next = a->head;
+        a->head = c;
+        a->bytes += want;
+        if (a->next_size < CELL_ARENA_MAX_CHUNK) a->next_size *= 2;
+    }
+    void *p = (char *)c->data + c->used;
+    c->used += size;
+    return p;
+}
+
+char *cell_arena_strndup(CellArena *a, const char *s, size_t len)
+{
+    char *out = cell_arena_alloc(a, len + 1);
+    if (!out) return NULL;
+    if (len) memcpy(out, s, len);
+    out[len] = '\0';
+    return out;
+}
+
+int cell_arena_owns(const CellArena *a, const void *p)
+{
+    uintptr_t at = (uintptr_t)p;
+
+    if (!a || !p) return 0;
+    for (const CellChunk *c = a->head; c; c = c->next) {
+        uintptr_t start = (uintptr_t)c->data;
+        if (at >= start && at < start + c->used) return 1;
+    }
+    return 0;
+}
+
+size_t cell_arena_bytes(const CellArena *a)
+{
+    return a ? a->bytes : 0;
+}
+
+void cell_free(const CellArena *a, void *p)
+{
+    if (!p || cell_arena_owns(a, p)) return;
+    free(p);
+}
@@ -264,6 +264,29 @@ Table* db_load_table(DbManager *db, const char *name, char *err, size_t err_sz)
     return t;
 }
 
+// Bytes per cell in a loaded Table: the allocation, its header and a short value
+#define DB_CELL_ESTIMATE 56
+
+unsigned long long db_estimate_table_bytes(DbManager *db, const char *name) {
+    if (!db || !db->conn || !name || !*name) return 0;
+    char **col_names = NULL; char **col_types = NULL; int col_count = 0;
+    if (fetch_columns(db, name, &col_names, &col_types, &col_count) != 0) return 0;
+    for (int i = 0; i < col_count; ++i) { free(col_names[i]); free(col_types[i]); }
+    free(col_names); free(col_types);
+
+    // MAX(rowid) is one b-tree seek; deleted rows only make it overshoot
+    char qname[512]; quote_ident(qname, sizeof(qname), name);
+    char sql[600]; snprintf(sql, sizeof(sql), "SELECT MAX(rowid) FROM %s;", qname);
+    sqlite3_stmt *st = NULL;
+    long long rows = 0;
+    if (sqlite3_prepare_v2(db->conn, sql, -1, &st, NULL) == SQLITE_OK && sqlite3_step(st) == SQLITE_ROW) {
+        rows = sqlite3_column_int64(st, 0);
+    }
+    sqlite3_finalize(st);
+    if (rows <= 0 || col_count <= 0) return 0;
+    return (unsigned long long)rows * (sizeof(Row) + (unsigned long long)col_count * (sizeof(void*) + DB_CELL_ESTIMATE));
+}
+
 static int fetch_columns(DbManager *db, const char *table, char ***names, char ***types, int *count) {
     *names = NULL; *types = NULL; *count = 0;
     char sql[512]; snprintf(sql, sizeof(sql), "PRAGMA table_info(\"%s\");", table);
@@ -428,6 +451,127 @@ int db_export_table_path(const Table *t, const char *path, char *err, size_t err
     return rc;
 }
 
+// Rows between progress reports of a seek-view export
+#define DB_EXPORT_REPORT_ROWS 4096
+
+typedef struct {
+    sqlite3 *out;
+    sqlite3_stmt *insert;
+    int cols;
+    int key_col;          // left out of the copy
+    long long rows;
+    long long total;      // <0 when unknown
+    const ProgressReporter *progress;
+} DbExport;
+
+static bool export_row(void *user, sqlite3_stmt *row) {
+    DbExport *x = (DbExport*)user;
+    int idx = 1;
+
+    sqlite3_reset(x->insert);
+    for (int j = 0; j < x->cols; ++j) {
+        if (j != x->key_col) sqlite3_bind_value(x->insert, idx++, sqlite3_column_value(row, j));
+    }
+    if (sqlite3_step(x->insert) != SQLITE_DONE) return false;
+    if (++x->rows % DB_EXPORT_REPORT_ROWS == 0 && x->progress && x->progress->update) {
+        char msg[96];
+        if (x->total > 0) snprintf(msg, sizeof(msg), "Exported %lld of %lld rows...", x->rows, x->total);
+        else snprintf(msg, sizeof(msg), "Exported %lld rows...", x->rows);
+        x->progress->update(x->progress->ctx, x->total > 0 ? 0.98 * (double)x->rows / (double)x->total : 0.0, msg);
+    }
+    return true;
+}
+
+long long db_export_seekdb(seekdb *s, const char *table_name, const char *path, char *err, size_t err_sz,
+                           const ProgressReporter *progress) {
+    DbExport x = {0};
+    char **names = NULL;
+    char **decls = NULL;
+    char *errmsg = NULL;
+    long long rows = -1;
+
+    if (!s || !table_name || !*table_name || !path || !*path) {
+        set_err(err, err_sz, "Invalid export path");
+        return -1;
+    }
+    x.cols = seekdb_get_view_columns(s, &names, err, err_sz);
+    if (x.cols <= 0) return -1;
+    if (seekdb_get_view_column_types(s, &decls, err, err_sz) != x.cols) goto done;
+    x.key_col = seekdb_view_key_column(s, NULL, 0);
+    x.total = seekdb_count_estimate(s, NULL);
+    x.progress = progress;
+
+    // The target is replaced, so it must not be the database being read
+    const char *source = seekdb_filename(s);
+    struct stat src_st, dst_st;
+    if (*source && stat(source, &src_st) == 0 && stat(path, &dst_st) == 0 &&
+        src_st.st_dev == dst_st.st_dev && src_st.st_ino == dst_st.st_ino) {
+        set_err(err, err_sz, "Cannot export over the database being viewed");
+        goto done;
+    }
+    unlink(path);
+    if (sqlite3_open(path, &x.out) != SQLITE_OK) {
+        set_err(err, err_sz, x.out ? sqlite3_errmsg(x.out) : "Failed to create database");
+        goto done;
+    }
+    // A fresh file nobody else sees until it is complete: no journal
+    sqlite3_exec(x.out, "PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF;", NULL, NULL, NULL);
+
+    // Same schema as db_save_table writes: declared types kept, booleans as INTEGER
+    sqlite3_str *create = sqlite3_str_new(x.out);
+    sqlite3_str *insert = sqlite3_str_new(x.out);
+    sqlite3_str_appendf(create, "CREATE TABLE \"%w\" (", table_name);
+    sqlite3_str_appendf(insert, "INSERT INTO \"%w\" VALUES (", table_name);
+    int first = 1;
+    for (int j = 0; j < x.cols; ++j) {
+        if (j == x.key_col) continue;
+        const char *decl = decls[j] ? decls[j] : "";
+        if (seekdb_decl_is_bool(decl)) decl = map_dtype(TYPE_BOOL);
+        sqlite3_str_appendf(create, "%s\"%w\" %s", first ? "" : ", ", names[j], decl);
+        sqlite3_str_appendf(insert, "%s?", first ? "" : ", ");
+        first = 0;
+    }
+    sqlite3_str_appendall(create, ");");
+    sqlite3_str_appendall(insert, ");");
+    char *create_sql = sqlite3_str_finish(create);
+    char *insert_sql = sqlite3_str_finish(insert);
+    if (!create_sql || !insert_sql) {
+        set_err(err, err_sz, "Out of memory");
+    } else if (sqlite3_exec(x.out, create_sql, NULL, NULL, &errmsg) != SQLITE_OK ||
+               sqlite3_exec(x.out, "BEGIN;", NULL, NULL, &errmsg) != SQLITE_OK) {
+        set_err(err, err_sz, errmsg ? errmsg : "CREATE TABLE failed");
+    } else if (sqlite3_prepare_v2(x.out, insert_sql, -1, &x.insert, NULL) != SQLITE_OK) {
+        set_err(err, err_sz, sqlite3_errmsg(x.out));
+    } else {
+        if (progress && progress->update) progress->update(progress->ctx, 0.0, "Exporting rows...");
+        rows = seekdb_scan(s, export_row, &x, err, err_sz);
+        if (rows >= 0 && rows != x.rows) {
+            set_err(err, err_sz, sqlite3_errmsg(x.out));
+            rows = -1;
+        }
+        if (rows >= 0 && sqlite3_exec(x.out, "COMMIT;", NULL, NULL, &errmsg) != SQLITE_OK) {
+            set_err(err, err_sz, errmsg ? errmsg : "COMMIT failed");
+            rows = -1;
+        }
+        if (rows >= 0 && progress && progress->update) progress->update(progress->ctx, 1.0, "Done");
+    }
+    sqlite3_free(errmsg);
+    sqlite3_free(create_sql);
+    sqlite3_free(insert_sql);
+
+done:
+    sqlite3_finalize(x.insert);
+    if (x.out) sqlite3_close(x.out);
+    if (rows < 0 && x.out) unlink(path);
+    for (int j = 0; j < x.cols; ++j) {
+        if (names) free(names[j]);
+        if (decls) free(decls[j]);
+    }
+    free(names);
+    free(decls);
+    return rows;
+}
+
 int db_export_book_path(const char *book_path, const char *path, char *err, size_t err_sz) {
     sqlite3 *conn = NULL;
     DbManager db = {0};
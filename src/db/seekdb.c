@@ -1,22 +1,159 @@
 #define _GNU_SOURCE
 #include "seekdb.h"
+#include "text_fold.h"
+#include "text_regex.h"
+#include "mem_budget.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <limits.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 
 /* --------------------------
    Internal state & helpers
    -------------------------- */
 
+/* Rows per transaction during a bulk load (seekdb_ingest_append_row) */
+#define INGEST_BATCH_ROWS 200000
+
+/* Rows between size checks of a tmpfs spill during a bulk load, and the
+   least tmpfs room worth starting a spill in (see memory_spill_dir) */
+#define SPILL_CHECK_ROWS 16384
+#define SPILL_MIN_MEMORY (16ULL << 20)
+
+/* Parameter slot for a spec filter value (see seekdb_set_view_spec); kept
+   clear of the ?1..?N boundary and limit parameters. */
+#define FILTER_PARAM 99
+#define FILTER_PARAM_SQL "?99"
+
+/* Statements cached per view (see stmt_get) */
+enum {
+    STMT_FIRST = 0,
+    STMT_AFTER,
+    STMT_BEFORE,
+    STMT_BY_ID,
+    STMT_BOUNDARY,
+    STMT_COUNT_ROWS,
+    STMT_RANK,
+    STMT_KEYS,
+    STMT_SCAN,          /* every column, whatever the projection */
+    STMT_NTH,
+    STMT_SORTS_FROM,
+    STMT_COUNT_BETWEEN,
+    STMT_DATA_VERSION,
+    STMT_UPDATE,        /* of column update_col */
+    STMT_NEXT_KEY,
+    STMT_INSERT,
+    STMT_DELETE,
+    STMT_FTS_AFTER,     /* FTS kinds come in index/LIKE pairs, see fts_stmt */
+    STMT_LIKE_AFTER,
+    STMT_FTS_BEFORE,
+    STMT_LIKE_BEFORE,
+    STMT_FTS_FIRST,
+    STMT_LIKE_FIRST,
+    STMT_FTS_LAST,
+    STMT_LIKE_LAST,
+    STMT_FTS_COUNT,
+    STMT_LIKE_COUNT,
+    STMT_KIND_COUNT
+};
+
 struct seekdb {
     sqlite3 *db;
-    char    *tmpdir;     /* NULL if connected mode */
+    char    *tmpdir;     /* NULL if connected mode (or a reader) */
+    unsigned long long spill_limit; /* bytes the spill may reach on tmpfs; 0 once on disk */
+    seekdb_mode_t mode;
     char    *view_name;  /* defaults to _ttb_view */
     char    *key_name;   /* defaults to _ttb_id */
+    char    *base_table; /* table behind the current view */
+    char    *where_sql;  /* view filter, NULL when unfiltered */
+    char    *filter_arg; /* value bound to FILTER_PARAM in every statement */
+
+    /* View ORDER BY split into sort expressions; the key is always the
+       last term, so every term list is a total order (see parse_order). */
+    char   **order_exprs;
+    int     *order_desc;
+    int      order_count;
+
+    /* Columns of base_table (loaded on first use) and the ones window reads
+       select, as indexes into them (NULL: all, see seekdb_set_projection) */
+    char   **col_names;
+    char   **col_decls;
+    int      col_count;
+    int     *proj;
+    int      proj_count;
+
+    /* Full-text shadow index over base_table (built on first search) */
+    int      fts_ready;
+    char   **fts_cols;
+    int      fts_col_count;
+
+    /* Row count of the view, valid while the main database's data version
+       is still count_version (see seekdb_count_estimate) */
+    int       count_valid;
+    int       count_exact;
+    long long count_rows;
+    unsigned  count_version;
+
+    /* Open write batch (seekdb_write_begin): nesting depth, and how the
+       cached count moves when it commits (unknown once count_lost) */
+    int       write_depth;
+    int       count_lost;
+    long long count_delta;
+    int       update_col;
+
+    /* Bulk load in progress (seekdb_ingest_begin) */
+    sqlite3_stmt *ingest_stmt;
+    char     *ingest_table;
+    int       ingest_cols;      /* values per row; the key is bound after them */
+    char     *ingest_key;       /* NULL when rows get no key */
+    long long ingest_next_key;
+    long long ingest_rows;      /* appended in total */
+    int       ingest_pending;   /* appended since the last batch commit */
+    int       ingest_relaxed;   /* journal switched off (spill databases) */
+
+    /* Indexes created (or found) this session, so set_view skips the DDL */
+    char   **known_indexes;
+    int      known_index_count;
+
+    /* Prepared once per view and reused via reset/bind; seekdb_set_view
+       finalizes them. Seek kinds over a non-key leading term keep their
+       NULL part apart (see append_seek_cond). */
+    sqlite3_stmt *stmts[STMT_KIND_COUNT];
+    sqlite3_stmt *null_stmts[STMT_KIND_COUNT];
 };
 
+/* Growable SQL text for statements whose size depends on the schema. */
+typedef struct {
+    char  *buf;
+    size_t len;
+    size_t cap;
+    int    oom;
+} sqlbuf;
+
+static void sb_appendf(sqlbuf *b, const char *fmt, ...) {
+    if (b->oom) return;
+    for (;;) {
+        va_list ap;
+        size_t avail = b->cap - b->len;
+        va_start(ap, fmt);
+        int n = vsnprintf(b->buf ? b->buf + b->len : NULL, b->buf ? avail : 0, fmt, ap);
+        va_end(ap);
+        if (n < 0) { b->oom = 1; return; }
+        if (b->buf && (size_t)n < avail) { b->len += (size_t)n; return; }
+        size_t cap = b->cap ? b->cap * 2 : 256;
+        while (cap < b->len + (size_t)n + 1) cap *= 2;
+        char *grown = realloc(b->buf, cap);
+        if (!grown) { b->oom = 1; return; }
+        b->buf = grown;
+        b->cap = cap;
+    }
+}
+
 static void set_err(char *err, size_t errlen, const char *msg) {
     if (err && errlen) {
         snprintf(err, errlen, "%s", msg ? msg : "error");
@@ -43,34 +180,643 @@ static int exec_sql(sqlite3 *db, const char *sql, char *err, size_t errlen) {
     return rc;
 }
 
+static seekdb_tuning g_tuning;
+
+void seekdb_set_tuning(const seekdb_tuning *t) {
+    memset(&g_tuning, 0, sizeof(g_tuning));
+    if (!t) return;
+    g_tuning = *t;
+    if (g_tuning.cache_mb < 0) g_tuning.cache_mb = 0;
+    /* SQLite ignores other sizes; 0 keeps its default */
+    if (g_tuning.page_size < 512 || g_tuning.page_size > 65536 ||
+        (g_tuning.page_size & (g_tuning.page_size - 1)) != 0) g_tuning.page_size = 0;
+}
+
+void seekdb_get_tuning(seekdb_tuning *out) {
+    if (out) *out = g_tuning;
+}
+
+/* Page cache (KiB) and mmap window (bytes) for a connection. AUTO sizes
+   them from the memory budget: 1/16 of it for the cache, 1/4 mapped.
+   The tuning settings override either. */
+static void cache_sizes(seekdb_mode_t mode, int *cache_kib, long long *mmap_bytes) {
+    unsigned long long budget = mode == SEEKDB_MODE_AUTO ? mem_budget_bytes() : 0;
+
+    *cache_kib = 16384; /* ~16 MiB */
+    *mmap_bytes = 0;
+    if (mode == SEEKDB_MODE_LOW_RAM) *cache_kib = 8192;
+    if (mode == SEEKDB_MODE_NORMAL)  *cache_kib = 32768;
+    if (budget > 0) {
+        unsigned long long kib = (budget >> 10) / 16;
+        if (kib < 8192) kib = 8192;
+        if (kib > 262144) kib = 262144;
+        *cache_kib = (int)kib;
+        *mmap_bytes = (long long)(budget / 4 < (1ULL << 30) ? budget / 4 : (1ULL << 30));
+    }
+    if (g_tuning.cache_mb > 0) *cache_kib = g_tuning.cache_mb * 1024;
+    if (g_tuning.mmap_mb > 0) *mmap_bytes = (long long)g_tuning.mmap_mb << 20;
+    if (g_tuning.mmap_mb < 0) *mmap_bytes = 0;
+}
+
 static int apply_pragmas(sqlite3 *db, seekdb_mode_t mode) {
-    /* Low-RAM friendly defaults; can be tuned later via a settings screen. */
-    int cache_kib = 16384; /* ~16 MiB */
-    if (mode == SEEKDB_MODE_LOW_RAM) cache_kib = 8192;
-    if (mode == SEEKDB_MODE_NORMAL)  cache_kib = 32768;
+    int cache_kib;
+    long long mmap_bytes;
+    char sql[320];
 
-    char sql[256];
+    cache_sizes(mode, &cache_kib, &mmap_bytes);
     snprintf(sql, sizeof(sql),
         "PRAGMA journal_mode=WAL;"
         "PRAGMA synchronous=NORMAL;"
         "PRAGMA temp_store=FILE;"
         "PRAGMA cache_spill=ON;"
-        "PRAGMA cache_size=-%d;", cache_kib);
+        "PRAGMA cache_size=-%d;"
+        "PRAGMA mmap_size=%lld;", cache_kib, mmap_bytes);
 
     return sqlite3_exec(db, sql, NULL, NULL, NULL);
 }
 
-static int append_key_if_missing(char *dst, size_t dstlen, const char *order_sql, const char *key) {
-    if (order_sql && strstr(order_sql, key)) {
-        snprintf(dst, dstlen, "%s", order_sql);
-    } else if (order_sql && *order_sql) {
-        snprintf(dst, dstlen, "%s, %s", order_sql, key);
-    } else {
-        snprintf(dst, dstlen, "%s", key);
+static void free_order(seekdb *s) {
+    for (int i = 0; i < s->order_count; ++i) free(s->order_exprs[i]);
+    free(s->order_exprs);
+    free(s->order_desc);
+    s->order_exprs = NULL;
+    s->order_desc = NULL;
+    s->order_count = 0;
+}
+
+static int push_order_term(seekdb *s, char *expr, int desc) {
+    if (!expr) return -1;
+    char **exprs = realloc(s->order_exprs, sizeof(char *) * (size_t)(s->order_count + 1));
+    if (!exprs) { free(expr); return -1; }
+    s->order_exprs = exprs;
+    int *dirs = realloc(s->order_desc, sizeof(int) * (size_t)(s->order_count + 1));
+    if (!dirs) { free(expr); return -1; }
+    s->order_desc = dirs;
+    s->order_exprs[s->order_count] = expr;
+    s->order_desc[s->order_count] = desc;
+    s->order_count++;
+    return 0;
+}
+
+static int is_plain_ident(const char *p, size_t n) {
+    if (n == 0) return 0;
+    for (size_t i = 0; i < n; ++i) {
+        char c = p[i];
+        if (!(c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (i > 0 && c >= '0' && c <= '9'))) return 0;
+    }
+    return 1;
+}
+
+/* Strips a trailing ASC/DESC from [p, p+*n); returns 1 for DESC. */
+static int take_direction(const char *p, size_t *n) {
+    static const struct { const char *word; int desc; } dirs[] = { {"DESC", 1}, {"ASC", 0} };
+    for (size_t d = 0; d < sizeof(dirs) / sizeof(dirs[0]); ++d) {
+        size_t w = strlen(dirs[d].word);
+        if (*n <= w || strncasecmp(p + *n - w, dirs[d].word, w) != 0) continue;
+        if (p[*n - w - 1] != ' ' && p[*n - w - 1] != '\t') continue;
+        *n -= w;
+        while (*n > 0 && (p[*n - 1] == ' ' || p[*n - 1] == '\t')) --*n;
+        return dirs[d].desc;
+    }
+    return 0;
+}
+
+/* Strips a trailing "COLLATE name" from [p, p+*n) into coll (empty if none). */
+static void take_collation(const char *p, size_t *n, char *coll, size_t coll_sz) {
+    size_t end = *n, start = end;
+    coll[0] = '\0';
+    while (start > 0 && is_plain_ident(p + start - 1, end - start + 1)) --start;
+    if (start == end || start < 8) return;
+    size_t c = start;
+    while (c > 0 && (p[c - 1] == ' ' || p[c - 1] == '\t')) --c;
+    if (c == start || c < 7 || strncasecmp(p + c - 7, "COLLATE", 7) != 0) return;
+    if (c > 7 && p[c - 8] != ' ' && p[c - 8] != '\t' && p[c - 8] != '"' && p[c - 8] != ')') return;
+    snprintf(coll, coll_sz, "%.*s", (int)(end - start), p + start);
+    *n = c - 7;
+    while (*n > 0 && (p[*n - 1] == ' ' || p[*n - 1] == '\t')) --*n;
+}
+
+/* One ORDER BY term as SQL: the bare column (or parenthesized expression)
+   with its explicit collation, if any, so the sort index and the column's
+   declared collation both apply. */
+static char *order_term_expr(seekdb *s, const char *p, size_t n) {
+    sqlbuf b = {0};
+    char coll[64];
+    take_collation(p, &n, coll, sizeof(coll));
+    size_t kn = strlen(s->key_name);
+    int is_key = (n == kn && strncmp(p, s->key_name, n) == 0) ||
+                 (n == kn + 2 && p[0] == '"' && strncmp(p + 1, s->key_name, kn) == 0 && p[n - 1] == '"');
+    if (is_key) sb_appendf(&b, "\"%s\"", s->key_name);
+    else if (n >= 2 && p[0] == '"' && p[n - 1] == '"') sb_appendf(&b, "%.*s", (int)n, p);
+    else if (is_plain_ident(p, n)) sb_appendf(&b, "\"%.*s\"", (int)n, p);
+    else sb_appendf(&b, "(%.*s)", (int)n, p);
+    if (coll[0] && !is_key) sb_appendf(&b, " COLLATE %s", coll);
+    if (b.oom) { free(b.buf); return NULL; }
+    return b.buf;
+}
+
+/* Splits order_sql ("a, \"b c\" DESC") into order terms and appends the
+   key (in the direction of the last term) unless it is already listed. */
+static int parse_order(seekdb *s, const char *order_sql) {
+    char key_expr[128];
+    int has_key = 0, last_desc = 0;
+
+    free_order(s);
+    snprintf(key_expr, sizeof(key_expr), "\"%s\"", s->key_name);
+    const char *p = order_sql ? order_sql : "";
+    while (*p) {
+        const char *end = p;
+        int depth = 0;
+        char quote = 0;
+        for (; *end; ++end) {
+            if (quote) { if (*end == quote) quote = 0; }
+            else if (*end == '"' || *end == '\'') quote = *end;
+            else if (*end == '(') depth++;
+            else if (*end == ')') depth--;
+            else if (depth == 0 && *end == ',') break;
+        }
+        const char *t = p;
+        size_t n = (size_t)(end - p);
+        while (n > 0 && (*t == ' ' || *t == '\t')) { ++t; --n; }
+        while (n > 0 && (t[n - 1] == ' ' || t[n - 1] == '\t')) --n;
+        if (n > 0) {
+            int desc = take_direction(t, &n);
+            char *expr = order_term_expr(s, t, n);
+            if (expr && strcmp(expr, key_expr) == 0) has_key = 1;
+            if (push_order_term(s, expr, desc) != 0) return -1;
+            last_desc = desc;
+            if (has_key) break; /* terms after a unique key never decide */
+        }
+        p = *end ? end + 1 : end;
+    }
+    if (!has_key && push_order_term(s, strdup(key_expr), last_desc) != 0) return -1;
+    return 0;
+}
+
+/* NULLs sort below every value; spelled out for the non-key terms (the
+   key is last and never NULL). These are SQLite's defaults, so the sort
+   index still supplies the order. */
+static void append_order_by(sqlbuf *b, seekdb *s, int reverse) {
+    sb_appendf(b, " ORDER BY ");
+    for (int i = 0; i < s->order_count; ++i) {
+        int desc = (s->order_desc[i] != reverse);
+        sb_appendf(b, "%s%s %s", i ? ", " : "", s->order_exprs[i], desc ? "DESC" : "ASC");
+        if (i < s->order_count - 1) sb_appendf(b, desc ? " NULLS LAST" : " NULLS FIRST");
+    }
+}
+
+enum { SEEK_AFTER, SEEK_BEFORE, SEEK_AT_OR_AFTER };
+
+/* Keyset condition on the order terms against the boundary values bound
+   from ?first on. Non-key terms may be NULL, which sorts below every value,
+   so they compare NULL-safely term by term (IS for ties; row values treat
+   NULL as unknown). A non-key leading term splits the condition in two
+   parts: nulls = 1 keeps the rows whose leading value is NULL, nulls = 0
+   the others, behind a range on the bare term so SQLite seeks the sort
+   index. Callers read both parts, in view order (see seek_part_nulls). */
+static void append_seek_cond(sqlbuf *b, seekdb *s, int mode, int first, int nulls) {
+    int n = s->order_count;
+    int forward = (mode != SEEK_BEFORE);
+    int inclusive = (mode == SEEK_AT_OR_AFTER);
+
+    if (n == 1) {
+        int gt = (forward != s->order_desc[0]);
+        sb_appendf(b, "%s %s%s ?%d", s->order_exprs[0], gt ? ">" : "<", inclusive ? "=" : "", first);
+        return;
+    }
+    const char *lead = s->order_exprs[0];
+    if (nulls) sb_appendf(b, "(%s IS NULL AND ", lead);
+    else if (forward != s->order_desc[0]) sb_appendf(b, "(%s >= IFNULL(?%d, -9e999) AND ", lead, first);
+    else sb_appendf(b, "(%s <= ?%d AND ", lead, first);
+    for (int i = 0; i < n; ++i) {
+        const char *e = s->order_exprs[i];
+        int gt = (forward != s->order_desc[i]);
+        int p = first + i;
+        if (i == n - 1) {
+            sb_appendf(b, "%s %s%s ?%d", e, gt ? ">" : "<", inclusive ? "=" : "", p);
+        } else if (gt) {
+            sb_appendf(b, "(%s > ?%d OR (?%d IS NULL AND %s IS NOT NULL) OR (%s IS ?%d AND ", e, p, p, e, e, p);
+        } else {
+            sb_appendf(b, "(%s < ?%d OR (%s IS NULL AND ?%d IS NOT NULL) OR (%s IS ?%d AND ", e, p, e, p, e, p);
+        }
+    }
+    for (int i = 0; i < n - 1; ++i) sb_appendf(b, "))");
+    sb_appendf(b, ")");
+}
+
+/* Parts a seek statement is read in (see append_seek_cond) */
+static int seek_parts(seekdb *s) {
+    return s->order_count > 1 ? 2 : 1;
+}
+
+/* Whether part (0 or 1) is the NULL part when the leading term is read
+   ascending (up) or descending: NULLs come first going up. */
+static int seek_part_nulls(seekdb *s, int up, int part) {
+    return s->order_count > 1 && (part == 0) == (up != 0);
+}
+
+/* CREATE INDEX IF NOT EXISTS over cols (SQL column list) of table, named
+   after a hash of the list so later sessions find the same index. Each
+   name is remembered, so re-applying a view costs no DDL. */
+static int ensure_index(seekdb *s, const char *prefix, const char *table, const char *cols,
+                        char *err, size_t errlen) {
+    unsigned long h = 5381;
+    for (const char *c = cols; *c; ++c) h = h * 33 + (unsigned char)*c;
+    char name[320];
+    snprintf(name, sizeof(name), "%s_%s_%08lx", prefix, table, h & 0xffffffffUL);
+    for (int i = 0; i < s->known_index_count; ++i) {
+        if (strcmp(s->known_indexes[i], name) == 0) return 0;
+    }
+
+    sqlbuf b = {0};
+    sb_appendf(&b, "CREATE INDEX IF NOT EXISTS \"%s\" ON \"%s\"(%s);", name, table, cols);
+    if (b.oom) { free(b.buf); set_err(err, errlen, "oom"); return -1; }
+    int rc = exec_sql(s->db, b.buf, err, errlen);
+    free(b.buf);
+    if (rc != SQLITE_OK) return -1;
+
+    char **grown = realloc(s->known_indexes, sizeof(char *) * (size_t)(s->known_index_count + 1));
+    if (grown) {
+        s->known_indexes = grown;
+        if ((grown[s->known_index_count] = strdup(name))) s->known_index_count++;
+    }
+    return 0;
+}
+
+/* Index on (sort terms..., key) so sorted seeks are a range scan plus a
+   key lookup per row. Key-only order uses the stable key index. */
+static int ensure_order_index(seekdb *s, char *err, size_t errlen) {
+    if (s->order_count <= 1) return 0;
+    sqlbuf cols = {0};
+    for (int i = 0; i < s->order_count; ++i) {
+        sb_appendf(&cols, "%s%s%s", i ? ", " : "", s->order_exprs[i], s->order_desc[i] ? " DESC" : "");
+    }
+    if (cols.oom) { free(cols.buf); set_err(err, errlen, "oom"); return -1; }
+    int rc = ensure_index(s, "_ttb_ord", s->base_table, cols.buf, err, errlen);
+    free(cols.buf);
+    return rc;
+}
+
+static void finalize_stmts(seekdb *s) {
+    for (int i = 0; i < STMT_KIND_COUNT; ++i) {
+        sqlite3_finalize(s->stmts[i]);
+        sqlite3_finalize(s->null_stmts[i]);
+        s->stmts[i] = s->null_stmts[i] = NULL;
+    }
+}
+
+/* The row-returning kinds, whose select list follows the projection */
+static void finalize_window_stmts(seekdb *s) {
+    for (int i = STMT_FIRST; i <= STMT_BY_ID; ++i) {
+        sqlite3_finalize(s->stmts[i]);
+        sqlite3_finalize(s->null_stmts[i]);
+        s->stmts[i] = s->null_stmts[i] = NULL;
+    }
+}
+
+static void free_columns(seekdb *s) {
+    for (int i = 0; i < s->col_count; ++i) { free(s->col_names[i]); free(s->col_decls[i]); }
+    free(s->col_names);
+    free(s->col_decls);
+    s->col_names = s->col_decls = NULL;
+    s->col_count = 0;
+}
+
+static void clear_projection(seekdb *s) {
+    free(s->proj);
+    s->proj = NULL;
+    s->proj_count = 0;
+}
+
+/* Names and declared types of base_table's columns, in SELECT * order */
+static int load_columns(seekdb *s, char *err, size_t errlen) {
+    char sql[512];
+    sqlite3_stmt *st = NULL;
+    int n;
+
+    if (s->col_names) return 0;
+    if (!s->base_table) { set_err(err, errlen, "no view"); return -1; }
+    snprintf(sql, sizeof(sql), "SELECT * FROM \"%s\";", s->base_table);
+    if (sqlite3_prepare_v2(s->db, sql, -1, &st, NULL) != SQLITE_OK) {
+        set_err(err, errlen, sqlite3_errmsg(s->db));
+        return -1;
+    }
+    n = sqlite3_column_count(st);
+    s->col_names = calloc((size_t)n, sizeof(char*));
+    s->col_decls = calloc((size_t)n, sizeof(char*));
+    if (!s->col_names || !s->col_decls) {
+        sqlite3_finalize(st);
+        free(s->col_names); free(s->col_decls);
+        s->col_names = s->col_decls = NULL;
+        set_err(err, errlen, "oom");
+        return -1;
+    }
+    s->col_count = n;
+    for (int i = 0; i < n; ++i) {
+        const char *name = sqlite3_column_name(st, i);
+        const char *decl = sqlite3_column_decltype(st, i);
+        s->col_names[i] = strdup(name ? name : "");
+        s->col_decls[i] = strdup(decl ? decl : "");
+        if (!s->col_names[i] || !s->col_decls[i]) {
+            sqlite3_finalize(st);
+            free_columns(s);
+            set_err(err, errlen, "oom");
+            return -1;
+        }
     }
+    sqlite3_finalize(st);
     return 0;
 }
 
+static int build_fts_query(seekdb *s, sqlbuf *b, int use_fts, int kind, int nulls);
+static void append_ident(sqlbuf *b, const char *name);
+
+/* Filtered window over the base table in view order. Window reads bind
+   the boundary's order values from ?1 (when there is one) and the row
+   limit last. */
+static void build_window_sql(seekdb *s, sqlbuf *b, int mode, int bounded, int nulls) {
+    sb_appendf(b, "SELECT ");
+    if (!s->proj) sb_appendf(b, "*");
+    for (int i = 0; i < s->proj_count; ++i) {
+        if (i) sb_appendf(b, ", ");
+        append_ident(b, s->col_names[s->proj[i]]);
+    }
+    sb_appendf(b, " FROM \"%s\" WHERE ", s->base_table);
+    if (bounded) append_seek_cond(b, s, mode, 1, nulls);
+    else sb_appendf(b, "1");
+    if (s->where_sql) sb_appendf(b, " AND (%s)", s->where_sql);
+    append_order_by(b, s, mode == SEEK_BEFORE);
+    sb_appendf(b, " LIMIT ?%d;", bounded ? s->order_count + 1 : 1);
+}
+
+static int build_stmt_sql(seekdb *s, int kind, int nulls, sqlbuf *b) {
+    if (!s->base_table || s->order_count == 0) return -1;
+    if (kind <= STMT_BY_ID && s->proj && load_columns(s, NULL, 0) != 0) return -1;
+    if ((kind == STMT_UPDATE || kind == STMT_INSERT) && load_columns(s, NULL, 0) != 0) return -1;
+    switch (kind) {
+        case STMT_FIRST:
+            build_window_sql(s, b, SEEK_AFTER, 0, 0);
+            break;
+        case STMT_AFTER:
+            build_window_sql(s, b, SEEK_AFTER, 1, nulls);
+            break;
+        case STMT_BEFORE:
+            build_window_sql(s, b, SEEK_BEFORE, 1, nulls);
+            break;
+        case STMT_BY_ID:
+            build_window_sql(s, b, SEEK_AT_OR_AFTER, 1, nulls);
+            break;
+        case STMT_BOUNDARY:
+            sb_appendf(b, "SELECT ");
+            for (int i = 0; i < s->order_count; ++i) sb_appendf(b, "%s%s", i ? ", " : "", s->order_exprs[i]);
+            sb_appendf(b, " FROM \"%s\" WHERE \"%s\" = ?1;", s->base_table, s->key_name);
+            break;
+        case STMT_COUNT_ROWS:
+            sb_appendf(b, "SELECT COUNT(*) FROM \"%s\"", s->base_table);
+            if (s->where_sql) sb_appendf(b, " WHERE (%s)", s->where_sql);
+            break;
+        case STMT_RANK:
+            sb_appendf(b, "SELECT COUNT(*) FROM \"%s\" WHERE ", s->base_table);
+            append_seek_cond(b, s, SEEK_BEFORE, 1, nulls);
+            if (s->where_sql) sb_appendf(b, " AND (%s)", s->where_sql);
+            break;
+        case STMT_KEYS:
+            sb_appendf(b, "SELECT \"%s\" FROM \"%s\"", s->key_name, s->base_table);
+            if (s->where_sql) sb_appendf(b, " WHERE (%s)", s->where_sql);
+            append_order_by(b, s, 0);
+            break;
+        case STMT_SCAN:
+            sb_appendf(b, "SELECT * FROM \"%s\"", s->base_table);
+            if (s->where_sql) sb_appendf(b, " WHERE (%s)", s->where_sql);
+            append_order_by(b, s, 0);
+            break;
+        case STMT_NTH:
+            /* keys from boundary ?1.. on, at most ?n+1 */
+            sb_appendf(b, "SELECT \"%s\" FROM \"%s\" WHERE ", s->key_name, s->base_table);
+            append_seek_cond(b, s, SEEK_AT_OR_AFTER, 1, nulls);
+            if (s->where_sql) sb_appendf(b, " AND (%s)", s->where_sql);
+            append_order_by(b, s, 0);
+            sb_appendf(b, " LIMIT ?%d", s->order_count + 1);
+            break;
+        case STMT_SORTS_FROM:
+            /* 1 when row ?n+1 sorts at or after boundary ?1.. */
+            sb_appendf(b, "SELECT COUNT(*) FROM \"%s\" WHERE \"%s\" = ?%d AND ",
+                       s->base_table, s->key_name, s->order_count + 1);
+            append_seek_cond(b, s, SEEK_AT_OR_AFTER, 1, nulls);
+            break;
+        case STMT_COUNT_BETWEEN:
+            /* rows from boundary ?1.. up to (not including) boundary ?n+1.. */
+            sb_appendf(b, "SELECT COUNT(*) FROM \"%s\" WHERE ", s->base_table);
+            append_seek_cond(b, s, SEEK_AT_OR_AFTER, 1, nulls);
+            sb_appendf(b, " AND ");
+            append_seek_cond(b, s, SEEK_BEFORE, s->order_count + 1, nulls);
+            if (s->where_sql) sb_appendf(b, " AND (%s)", s->where_sql);
+            break;
+        case STMT_DATA_VERSION:
+            sb_appendf(b, "PRAGMA data_version;");
+            break;
+        case STMT_UPDATE:
+            sb_appendf(b, "UPDATE \"%s\" SET ", s->base_table);
+            append_ident(b, s->col_names[s->update_col]);
+            sb_appendf(b, " = ?1 WHERE \"%s\" = ?2;", s->key_name);
+            break;
+        case STMT_NEXT_KEY:
+            sb_appendf(b, "SELECT COALESCE(MAX(\"%s\"), 0) + 1 FROM \"%s\";", s->key_name, s->base_table);
+            break;
+        case STMT_INSERT:
+            /* one parameter per column, in column order */
+            sb_appendf(b, "INSERT INTO \"%s\" (", s->base_table);
+            for (int i = 0; i < s->col_count; ++i) {
+                if (i) sb_appendf(b, ", ");
+                append_ident(b, s->col_names[i]);
+            }
+            sb_appendf(b, ") VALUES (");
+            for (int i = 0; i < s->col_count; ++i) sb_appendf(b, "%s?%d", i ? ", " : "", i + 1);
+            sb_appendf(b, ");");
+            break;
+        case STMT_DELETE:
+            sb_appendf(b, "DELETE FROM \"%s\" WHERE \"%s\" = ?1;", s->base_table, s->key_name);
+            break;
+        case STMT_FTS_AFTER: case STMT_FTS_BEFORE: case STMT_FTS_FIRST: case STMT_FTS_LAST: case STMT_FTS_COUNT:
+            return build_fts_query(s, b, 1, kind, nulls);
+        case STMT_LIKE_AFTER: case STMT_LIKE_BEFORE: case STMT_LIKE_FIRST: case STMT_LIKE_LAST: case STMT_LIKE_COUNT:
+            return build_fts_query(s, b, 0, kind - 1, nulls);
+        default:
+            return -1;
+    }
+    return b->oom ? -1 : 0;
+}
+
+/* Cached statement for kind (its NULL part when nulls, see
+   append_seek_cond): prepared on first use, otherwise reset with its
+   bindings cleared. The spec filter value (if any) is bound already.
+   Owned by s; callers must not finalize it. */
+static sqlite3_stmt *stmt_get_part(seekdb *s, int kind, int nulls, char *err, size_t errlen) {
+    sqlite3_stmt **slot = nulls ? &s->null_stmts[kind] : &s->stmts[kind];
+    sqlite3_stmt *st = *slot;
+    if (st) {
+        sqlite3_reset(st);
+        sqlite3_clear_bindings(st);
+        if (s->filter_arg) sqlite3_bind_text(st, FILTER_PARAM, s->filter_arg, -1, SQLITE_STATIC);
+        return st;
+    }
+    sqlbuf b = {0};
+    if (build_stmt_sql(s, kind, nulls, &b) != 0) {
+        free(b.buf); set_err(err, errlen, "oom"); return NULL;
+    }
+    int rc = sqlite3_prepare_v3(s->db, b.buf, -1, SQLITE_PREPARE_PERSISTENT, &st, NULL);
+    free(b.buf);
+    if (rc != SQLITE_OK) {
+        set_err(err, errlen, sqlite3_errmsg(s->db));
+        sqlite3_finalize(st);
+        return NULL;
+    }
+    *slot = st;
+    if (s->filter_arg) sqlite3_bind_text(st, FILTER_PARAM, s->filter_arg, -1, SQLITE_STATIC);
+    return st;
+}
+
+static sqlite3_stmt *stmt_get(seekdb *s, int kind, char *err, size_t errlen) {
+    return stmt_get_part(s, kind, 0, err, errlen);
+}
+
+static void free_fts_cols(seekdb *s) {
+    for (int i = 0; i < s->fts_col_count; ++i) free(s->fts_cols[i]);
+    free(s->fts_cols);
+    s->fts_cols = NULL;
+    s->fts_col_count = 0;
+    s->fts_ready = 0;
+}
+
+/* ttb_fold(x): x casefolded like the in-memory table keys (text_fold with
+   the current default flags). */
+static void sql_fold(sqlite3_context *ctx, int argc, sqlite3_value **argv) {
+    (void)argc;
+    const char *text = (const char *)sqlite3_value_text(argv[0]);
+    if (!text) { sqlite3_result_null(ctx); return; }
+    int flags = text_fold_default_flags();
+    char stack[256];
+    size_t n = text_fold_into(text, flags, stack, sizeof(stack));
+    if (n < sizeof(stack)) { sqlite3_result_text(ctx, stack, (int)n, SQLITE_TRANSIENT); return; }
+    char *buf = sqlite3_malloc64(n + 1);
+    if (!buf) { sqlite3_result_error_nomem(ctx); return; }
+    text_fold_into(text, flags, buf, n + 1);
+    sqlite3_result_text(ctx, buf, (int)n, sqlite3_free);
+}
+
+static void free_regex(void *re) { text_regex_free(re); }
+
+/* x REGEXP p, i.e. regexp(p, x): case-insensitive text_regex match. The
+   compiled pattern is cached on the statement for constant patterns. */
+static void sql_regexp(sqlite3_context *ctx, int argc, sqlite3_value **argv) {
+    (void)argc;
+    TextRegex *re = sqlite3_get_auxdata(ctx, 0);
+    if (!re) {
+        const char *pattern = (const char *)sqlite3_value_text(argv[0]);
+        char msg[128];
+        if (!pattern) { sqlite3_result_null(ctx); return; }
+        re = text_regex_compile(pattern, 1, msg, sizeof(msg));
+        if (!re) { sqlite3_result_error(ctx, msg, -1); return; }
+        sqlite3_set_auxdata(ctx, 0, re, free_regex);
+        if (sqlite3_get_auxdata(ctx, 0) != re) {
+            /* Not cached (already freed): compile a private copy */
+            re = text_regex_compile(pattern, 1, msg, sizeof(msg));
+            if (!re) { sqlite3_result_error_nomem(ctx); return; }
+            const char *text = (const char *)sqlite3_value_text(argv[1]);
+            sqlite3_result_int(ctx, text_regex_search(re, text ? text : "", NULL, NULL));
+            text_regex_free(re);
+            return;
+        }
+    }
+    const char *text = (const char *)sqlite3_value_text(argv[1]);
+    sqlite3_result_int(ctx, text_regex_search(re, text ? text : "", NULL, NULL));
+}
+
+static int register_functions(sqlite3 *db) {
+    int rc = sqlite3_create_function(db, "ttb_fold", 1, SQLITE_UTF8 | SQLITE_INNOCUOUS, NULL, sql_fold, NULL, NULL);
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_create_function(db, "regexp", 2, SQLITE_UTF8 | SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS,
+                                     NULL, sql_regexp, NULL, NULL);
+    }
+    return rc;
+}
+
+/* --------------------------
+   Spill directories
+   -------------------------- */
+
+/* A fresh seekdbXXXXXX under the first of dirs that takes one, or NULL. */
+static char *make_spill_dir(const char *const *dirs, int count) {
+    for (int i = 0; i < count; ++i) {
+        char tmpl[PATH_MAX];
+        if (!dirs[i] || !*dirs[i]) continue;
+        if (snprintf(tmpl, sizeof(tmpl), "%s/seekdbXXXXXX", dirs[i]) >= (int)sizeof(tmpl)) continue;
+        if (mkdtemp(tmpl)) return strdup(tmpl);
+    }
+    return NULL;
+}
+
+/* Repo-local build/ per project guidelines, else the system temp dir
+   (read-only working directories). */
+static char *disk_spill_dir(void) {
+    const char *dirs[] = { "build", getenv("TMPDIR"), "/tmp" };
+    (void)mkdir("build", 0755);
+    return make_spill_dir(dirs, 3);
+}
+
+/* In-memory tier. A tmpfs file rather than a :memory: database, so readers
+   can still open it by path. *limit gets the size it may grow to there:
+   the tuned or budget-derived cap, at most half the free tmpfs space. */
+static char *memory_spill_dir(unsigned long long *limit) {
+    const char *dirs[] = { getenv("XDG_RUNTIME_DIR"), "/dev/shm" };
+    unsigned long long want;
+    struct statvfs vfs;
+    char *dir;
+
+    *limit = 0;
+    if (g_tuning.spill_mem_mb < 0) return NULL;
+    if (g_tuning.spill_mem_mb > 0) {
+        want = (unsigned long long)g_tuning.spill_mem_mb << 20;
+    } else {
+        want = mem_budget_bytes() / 4;
+        if (want > (1ULL << 30)) want = 1ULL << 30;
+    }
+    if (want < SPILL_MIN_MEMORY) return NULL;
+    if (!(dir = make_spill_dir(dirs, 2))) return NULL;
+    if (statvfs(dir, &vfs) == 0) {
+        unsigned long long room = (unsigned long long)vfs.f_bavail * vfs.f_frsize / 2;
+        if (want > room) want = room;
+    }
+    if (want < SPILL_MIN_MEMORY) {
+        (void)rmdir(dir);
+        free(dir);
+        return NULL;
+    }
+    *limit = want;
+    return dir;
+}
+
+/* Deletes a spill directory with the database and its side files. */
+static void remove_spill_dir(const char *dir) {
+    static const char *const files[] = { "spill.db", "spill.db-wal", "spill.db-shm", "spill.db-journal" };
+    char path[PATH_MAX];
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); ++i) {
+        snprintf(path, sizeof(path), "%s/%s", dir, files[i]);
+        (void)unlink(path);
+    }
+    (void)rmdir(dir);
+}
+
+static void open_failed(seekdb *s) {
+    sqlite3_close(s->db);
+    if (s->tmpdir) {
+        remove_spill_dir(s->tmpdir);
+        free(s->tmpdir);
+    }
+    free(s);
+}
+
 /* --------------------------
    Public API (scaffold)
    -------------------------- */
@@ -83,37 +829,131 @@ seekdb* seekdb_open(const char *path_or_null, seekdb_mode_t mode, char *err, siz
     if (path_or_null && is_sqlite_file(path_or_null)) {
         rc = sqlite3_open(path_or_null, &s->db);
     } else {
-        /* Use repo-local build/ for ephemeral spill, per project guidelines. */
-        (void)mkdir("build", 0755);
-        char tmpdir[] = "build/seekdbXXXXXX";
-        if (!mkdtemp(tmpdir)) { set_err(err, errlen, "mkdtemp failed"); free(s); return NULL; }
-        s->tmpdir = strdup(tmpdir);
-        char path[512]; snprintf(path, sizeof(path), "%s/spill.db", tmpdir);
+        s->tmpdir = memory_spill_dir(&s->spill_limit);
+        if (!s->tmpdir) s->tmpdir = disk_spill_dir();
+        if (!s->tmpdir) { set_err(err, errlen, "mkdtemp failed"); free(s); return NULL; }
+        char path[PATH_MAX]; snprintf(path, sizeof(path), "%s/spill.db", s->tmpdir);
         rc = sqlite3_open(path, &s->db);
+        /* Only takes effect before the first write (and WAL) */
+        if (rc == SQLITE_OK && g_tuning.page_size > 0) {
+            char sql[48];
+            snprintf(sql, sizeof(sql), "PRAGMA page_size=%d;", g_tuning.page_size);
+            rc = sqlite3_exec(s->db, sql, NULL, NULL, NULL);
+        }
     }
     if (rc != SQLITE_OK) {
         set_err(err, errlen, sqlite3_errmsg(s->db));
-        sqlite3_close(s->db); free(s->tmpdir); free(s);
+        open_failed(s);
         return NULL;
     }
     if (apply_pragmas(s->db, mode) != SQLITE_OK) {
         set_err(err, errlen, "apply pragmas failed");
-        sqlite3_close(s->db); free(s->tmpdir); free(s);
+        open_failed(s);
+        return NULL;
+    }
+    if (register_functions(s->db) != SQLITE_OK) {
+        set_err(err, errlen, sqlite3_errmsg(s->db));
+        open_failed(s);
         return NULL;
     }
 
+    s->mode = mode;
     s->view_name = strdup("_ttb_view");
     s->key_name  = strdup("_ttb_id");
     return s;
 }
 
+static char *dup_or_null(const char *str, int *oom) {
+    if (!str) return NULL;
+    char *copy = strdup(str);
+    if (!copy) *oom = 1;
+    return copy;
+}
+
+const char *seekdb_filename(const seekdb *s) {
+    const char *path = (s && s->db) ? sqlite3_db_filename(s->db, "main") : NULL;
+    return path ? path : "";
+}
+
+seekdb *seekdb_open_reader(const seekdb *src, char *err, size_t errlen) {
+    if (!src || !src->db || !src->base_table) { set_err(err, errlen, "no view"); return NULL; }
+    const char *path = sqlite3_db_filename(src->db, "main");
+    if (!path || !*path) { set_err(err, errlen, "database has no file"); return NULL; }
+
+    seekdb *s = calloc(1, sizeof(*s));
+    if (!s) { set_err(err, errlen, "oom"); return NULL; }
+    if (sqlite3_open_v2(path, &s->db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK ||
+        register_functions(s->db) != SQLITE_OK) {
+        set_err(err, errlen, s->db ? sqlite3_errmsg(s->db) : "oom");
+        sqlite3_close(s->db); free(s);
+        return NULL;
+    }
+    /* journal_mode is the writer's business; WAL lets this read alongside it */
+    int cache_kib;
+    long long mmap_bytes;
+    char sql[160];
+    cache_sizes(src->mode, &cache_kib, &mmap_bytes);
+    snprintf(sql, sizeof(sql), "PRAGMA temp_store=FILE; PRAGMA cache_size=-%d; PRAGMA mmap_size=%lld;",
+             cache_kib, mmap_bytes);
+    sqlite3_exec(s->db, sql, NULL, NULL, NULL);
+
+    int oom = 0;
+    s->mode = src->mode;
+    s->view_name = dup_or_null(src->view_name, &oom);
+    s->key_name = dup_or_null(src->key_name, &oom);
+    s->base_table = dup_or_null(src->base_table, &oom);
+    s->where_sql = dup_or_null(src->where_sql, &oom);
+    s->filter_arg = dup_or_null(src->filter_arg, &oom);
+    for (int i = 0; i < src->order_count && !oom; ++i) {
+        if (push_order_term(s, dup_or_null(src->order_exprs[i], &oom), src->order_desc[i]) != 0) oom = 1;
+    }
+    if (src->proj && !oom) {
+        if ((s->proj = malloc(sizeof(int) * (size_t)src->proj_count))) {
+            memcpy(s->proj, src->proj, sizeof(int) * (size_t)src->proj_count);
+            s->proj_count = src->proj_count;
+        } else {
+            oom = 1;
+        }
+    }
+    if (oom) { seekdb_close(s); set_err(err, errlen, "oom"); return NULL; }
+    return s;
+}
+
 int seekdb_ensure_table(seekdb *s, const char *table, const char *columns_sql, char *err, size_t errlen) {
-    char sql[2048];
-    snprintf(sql, sizeof(sql), "CREATE TABLE IF NOT EXISTS \"%s\" (%s);", table, columns_sql);
-    return exec_sql(s->db, sql, err, errlen) == SQLITE_OK ? 0 : -1;
+    sqlbuf b = {0};
+    int rc;
+
+    sb_appendf(&b, "CREATE TABLE IF NOT EXISTS \"%s\" (%s);", table, columns_sql);
+    if (b.oom) { free(b.buf); set_err(err, errlen, "oom"); return -1; }
+    rc = exec_sql(s->db, b.buf, err, errlen);
+    free(b.buf);
+    return rc == SQLITE_OK ? 0 : -1;
+}
+
+int seekdb_ensure_table_columns(seekdb *s, const char *table, const char *const *names, const char *const *decls,
+                                int count, char *err, size_t errlen) {
+    sqlbuf b = {0};
+    int rc;
+
+    if (!s || !table || !names || count <= 0) { set_err(err, errlen, "bad args"); return -1; }
+    sb_appendf(&b, "CREATE TABLE IF NOT EXISTS ");
+    append_ident(&b, table);
+    sb_appendf(&b, " (");
+    for (int i = 0; i < count; ++i) {
+        if (i) sb_appendf(&b, ", ");
+        append_ident(&b, names[i]);
+        if (decls && decls[i]) sb_appendf(&b, " %s", decls[i]);
+    }
+    sb_appendf(&b, ");");
+    if (b.oom) { free(b.buf); set_err(err, errlen, "oom"); return -1; }
+    rc = exec_sql(s->db, b.buf, err, errlen);
+    free(b.buf);
+    return rc == SQLITE_OK ? 0 : -1;
 }
 
 int seekdb_ensure_stable_key(seekdb *s, const char *table, const char *key, char *err, size_t errlen) {
+    finalize_stmts(s);
+    free_columns(s); /* the key column may be added below */
     free(s->key_name); s->key_name = strdup(key);
 
     char sql[256];
@@ -144,36 +984,206 @@ int seekdb_ensure_stable_key(seekdb *s, const char *table, const char *key, char
     return 0;
 }
 
-int seekdb_set_view(seekdb *s, const char *base_table, const char *where_sql, const char *order_sql,
-                    const char *key, char *err, size_t errlen)
+/* Shared by set_view and set_view_spec. where_sql may use FILTER_PARAM
+   (bound to filter_arg, which s takes over); view_where_sql is the same
+   filter with the value inlined, since views cannot hold parameters. */
+static int apply_view(seekdb *s, const char *base_table, const char *where_sql, const char *view_where_sql,
+                      char *filter_arg, const char *order_sql, const char *key, char *err, size_t errlen)
 {
+    finalize_stmts(s);
     if (key && strcmp(key, s->key_name) != 0) { free(s->key_name); s->key_name = strdup(key); }
 
-    char ord[1024];
-    append_key_if_missing(ord, sizeof(ord), order_sql, s->key_name);
+    if (!s->base_table || strcmp(s->base_table, base_table) != 0) {
+        free(s->base_table);
+        s->base_table = strdup(base_table);
+        free_fts_cols(s);
+        free_columns(s);
+        clear_projection(s);
+    }
+    free(s->where_sql);
+    s->where_sql = (where_sql && *where_sql && strcmp(where_sql, "1=1") != 0) ? strdup(where_sql) : NULL;
+    free(s->filter_arg);
+    s->filter_arg = filter_arg;
+    s->count_valid = 0;
+
+    if (parse_order(s, order_sql) != 0) { set_err(err, errlen, "oom"); return -1; }
+    /* Indexes only speed things up: a read-only database still pages */
+    (void)ensure_order_index(s, NULL, 0);
 
-    char sql[2048];
+    char sql[256];
     snprintf(sql, sizeof(sql), "DROP VIEW IF EXISTS \"%s\";", s->view_name);
     if (exec_sql(s->db, sql, err, errlen) != SQLITE_OK) return -1;
 
-    snprintf(sql, sizeof(sql),
-        "CREATE TEMP VIEW \"%s\" AS SELECT * FROM \"%s\" WHERE %s ORDER BY %s;",
-        s->view_name, base_table, (where_sql && *where_sql) ? where_sql : "1=1", ord);
+    sqlbuf b = {0};
+    sb_appendf(&b, "CREATE TEMP VIEW \"%s\" AS SELECT * FROM \"%s\" WHERE %s",
+               s->view_name, base_table, s->where_sql ? view_where_sql : "1=1");
+    append_order_by(&b, s, 0);
+    sb_appendf(&b, ";");
+    if (b.oom) { free(b.buf); set_err(err, errlen, "oom"); return -1; }
+    int rc = exec_sql(s->db, b.buf, err, errlen);
+    free(b.buf);
+    return rc == SQLITE_OK ? 0 : -1;
+}
 
-    return exec_sql(s->db, sql, err, errlen) == SQLITE_OK ? 0 : -1;
+int seekdb_set_view(seekdb *s, const char *base_table, const char *where_sql, const char *order_sql,
+                    const char *key, char *err, size_t errlen)
+{
+    return apply_view(s, base_table, where_sql, where_sql, NULL, order_sql, key, err, errlen);
+}
+
+static void append_ident(sqlbuf *b, const char *name) {
+    sb_appendf(b, "\"");
+    for (const char *c = name; *c; ++c) {
+        if (*c == '"') sb_appendf(b, "\"\"");
+        else sb_appendf(b, "%c", *c);
+    }
+    sb_appendf(b, "\"");
 }
 
-static int run_window(seekdb *s, const char *sql, seekdb_row_cb cb, void *user, char *err, size_t errlen) {
+/* Declared type of column in table by SQLite's affinity rules: 1 for
+   INTEGER/REAL/NUMERIC affinity, 0 for TEXT/BLOB, <0 when missing. */
+static int column_is_numeric(seekdb *s, const char *table, const char *column, char *err, size_t errlen) {
+    char sql[512];
     sqlite3_stmt *st = NULL;
+    int numeric = -1;
+
+    snprintf(sql, sizeof(sql), "PRAGMA table_info(\"%s\");", table);
     if (sqlite3_prepare_v2(s->db, sql, -1, &st, NULL) != SQLITE_OK) {
         set_err(err, errlen, sqlite3_errmsg(s->db)); return -1;
     }
+    while (sqlite3_step(st) == SQLITE_ROW) {
+        const char *name = (const char *)sqlite3_column_text(st, 1);
+        if (!name || strcmp(name, column) != 0) continue;
+        const char *type = (const char *)sqlite3_column_text(st, 2);
+        if (!type) type = "";
+        if (strcasestr(type, "INT")) numeric = 1;
+        else if (strcasestr(type, "CHAR") || strcasestr(type, "CLOB") || strcasestr(type, "TEXT")) numeric = 0;
+        else if (!*type || strcasestr(type, "BLOB")) numeric = 0;
+        else numeric = 1;
+        break;
+    }
+    sqlite3_finalize(st);
+    if (numeric < 0) set_err(err, errlen, "no such column");
+    return numeric;
+}
+
+static void append_filter_sql(sqlbuf *b, const seekdb_filter *f, int numeric, const char *arg) {
+    static const char *const cmp_ops[] = { [SEEKDB_FILTER_GT] = ">", [SEEKDB_FILTER_LT] = "<",
+                                           [SEEKDB_FILTER_GTE] = ">=", [SEEKDB_FILTER_LTE] = "<=" };
+    switch (f->op) {
+        case SEEKDB_FILTER_CONTAINS:
+            sb_appendf(b, "instr(ttb_fold(");
+            append_ident(b, f->column);
+            sb_appendf(b, "), %s) > 0", arg);
+            break;
+        case SEEKDB_FILTER_EQUALS:
+            sb_appendf(b, numeric ? "" : "ttb_fold(");
+            append_ident(b, f->column);
+            sb_appendf(b, "%s = %s", numeric ? "" : ")", arg);
+            break;
+        case SEEKDB_FILTER_REGEX:
+            append_ident(b, f->column);
+            sb_appendf(b, " REGEXP %s", arg);
+            break;
+        default:
+            append_ident(b, f->column);
+            sb_appendf(b, " %s %s", cmp_ops[f->op], arg);
+            break;
+    }
+}
+
+int seekdb_set_view_spec(seekdb *s, const char *base_table, const seekdb_filter *filter, const seekdb_sort *sort,
+                         const char *key, char *err, size_t errlen)
+{
+    if (!s || !base_table) { set_err(err, errlen, "bad args"); return -1; }
+    sqlbuf where = {0}, view_where = {0}, order = {0};
+    char *arg = NULL;
+    int rc = -1;
+
+    if (filter) {
+        if (!filter->column || !filter->value || !*filter->value ||
+            filter->op < SEEKDB_FILTER_CONTAINS || filter->op > SEEKDB_FILTER_REGEX) {
+            set_err(err, errlen, "Filter value is required");
+            return -1;
+        }
+        int numeric = column_is_numeric(s, base_table, filter->column, err, errlen);
+        if (numeric < 0) return -1;
+        if (filter->op == SEEKDB_FILTER_REGEX) {
+            TextRegex *re = text_regex_compile(filter->value, 1, err, errlen);
+            if (!re) return -1;
+            text_regex_free(re);
+        }
+        /* Folded operators compare against the folded needle */
+        if (filter->op == SEEKDB_FILTER_CONTAINS || (filter->op == SEEKDB_FILTER_EQUALS && !numeric)) {
+            size_t n = text_fold_into(filter->value, text_fold_default_flags(), NULL, 0);
+            if ((arg = malloc(n + 1))) text_fold_into(filter->value, text_fold_default_flags(), arg, n + 1);
+        } else {
+            arg = strdup(filter->value);
+        }
+        char *lit = arg ? sqlite3_mprintf("%Q", arg) : NULL;
+        if (!lit) { free(arg); set_err(err, errlen, "oom"); return -1; }
+        append_filter_sql(&where, filter, numeric, FILTER_PARAM_SQL);
+        append_filter_sql(&view_where, filter, numeric, lit);
+        sqlite3_free(lit);
+
+        /* Equality and ranges on the raw column can seek an index */
+        int seekable = filter->op != SEEKDB_FILTER_CONTAINS && filter->op != SEEKDB_FILTER_REGEX &&
+                       !(filter->op == SEEKDB_FILTER_EQUALS && !numeric);
+        if (seekable) {
+            sqlbuf col = {0};
+            append_ident(&col, filter->column);
+            if (!col.oom) (void)ensure_index(s, "_ttb_flt", base_table, col.buf, NULL, 0);
+            free(col.buf);
+        }
+    }
+    if (sort && sort->column) {
+        int numeric = column_is_numeric(s, base_table, sort->column, err, errlen);
+        if (numeric < 0) goto done;
+        append_ident(&order, sort->column);
+        /* Text sorts case-insensitively, close to the in-memory fold order
+           but with a built-in collation the index can carry */
+        sb_appendf(&order, "%s%s", numeric ? "" : " COLLATE NOCASE", sort->desc ? " DESC" : "");
+    }
+    if (where.oom || view_where.oom || order.oom) { set_err(err, errlen, "oom"); goto done; }
+
+    rc = apply_view(s, base_table, where.buf, view_where.buf, arg, order.buf ? order.buf : key, key, err, errlen);
+    arg = NULL;
+done:
+    free(arg);
+    free(where.buf);
+    free(view_where.buf);
+    free(order.buf);
+    return rc;
+}
+
+/* Binds the order values of row id to ?first.. of st. With key-only order
+   the id itself is the boundary, so it need not exist. Returns 1 when
+   bound, 0 when the row is gone, <0 on error. */
+static int bind_boundary(seekdb *s, sqlite3_stmt *st, int first, long long id, char *err, size_t errlen) {
+    if (s->order_count == 1) { sqlite3_bind_int64(st, first, id); return 1; }
+    sqlite3_stmt *bq = stmt_get(s, STMT_BOUNDARY, err, errlen);
+    if (!bq) return -1;
+    sqlite3_bind_int64(bq, 1, id);
+    int rc = sqlite3_step(bq);
+    if (rc == SQLITE_ROW) {
+        for (int i = 0; i < s->order_count; ++i) sqlite3_bind_value(st, first + i, sqlite3_column_value(bq, i));
+    } else if (rc != SQLITE_DONE) {
+        set_err(err, errlen, sqlite3_errmsg(s->db));
+    }
+    sqlite3_reset(bq);
+    return rc == SQLITE_ROW ? 1 : (rc == SQLITE_DONE ? 0 : -1);
+}
+
+/* Steps a bound window statement, then resets it so no read transaction
+   stays open between calls. *stopped (optional) is set when cb stopped. */
+static int run_window(seekdb *s, sqlite3_stmt *st, seekdb_row_cb cb, void *user, int *stopped,
+                      char *err, size_t errlen) {
     int delivered = 0;
     for (;;) {
         int rc = sqlite3_step(st);
         if (rc == SQLITE_ROW) {
             ++delivered;
-            if (!cb(user, st)) break; /* early stop */
+            if (!cb(user, st)) { if (stopped) *stopped = 1; break; } /* early stop */
         } else if (rc == SQLITE_DONE) {
             break;
         } else {
@@ -181,53 +1191,129 @@ static int run_window(seekdb *s, const char *sql, seekdb_row_cb cb, void *user,
             delivered = -1; break;
         }
     }
-    sqlite3_finalize(st);
+    sqlite3_reset(st);
+    return delivered;
+}
+
+static int seek_bounded(seekdb *s, int kind, long long bound, int limit, seekdb_row_cb cb, void *user,
+                        char *err, size_t errlen) {
+    int up = (kind != STMT_BEFORE) != s->order_desc[0];
+    int delivered = 0, stopped = 0;
+    for (int part = 0; part < seek_parts(s) && delivered < limit && !stopped; ++part) {
+        sqlite3_stmt *st = stmt_get_part(s, kind, seek_part_nulls(s, up, part), err, errlen);
+        if (!st) return -1;
+        int found = bind_boundary(s, st, 1, bound, err, errlen);
+        if (found <= 0) return found < 0 ? -1 : delivered;
+        sqlite3_bind_int(st, s->order_count + 1, limit - delivered);
+        int got = run_window(s, st, cb, user, &stopped, err, errlen);
+        if (got < 0) return -1;
+        delivered += got;
+    }
     return delivered;
 }
 
 int seekdb_seek_first(seekdb *s, int limit, seekdb_row_cb cb, void *user, char *err, size_t errlen) {
-    char sql[512];
-    snprintf(sql, sizeof(sql), "SELECT * FROM \"%s\" LIMIT %d;", s->view_name, limit);
-    return run_window(s, sql, cb, user, err, errlen);
+    sqlite3_stmt *st = stmt_get(s, STMT_FIRST, err, errlen);
+    if (!st) return -1;
+    sqlite3_bind_int(st, 1, limit);
+    return run_window(s, st, cb, user, NULL, err, errlen);
 }
 
 int seekdb_seek_after(seekdb *s, long long last_id, int limit, seekdb_row_cb cb, void *user, char *err, size_t errlen) {
-    char sql[1024];
-    snprintf(sql, sizeof(sql),
-        "SELECT * FROM \"%s\" WHERE \"%s\" > %lld ORDER BY \"%s\" LIMIT %d;",
-        s->view_name, s->key_name, last_id, s->key_name, limit);
-    return run_window(s, sql, cb, user, err, errlen);
+    return seek_bounded(s, STMT_AFTER, last_id, limit, cb, user, err, errlen);
 }
 
 int seekdb_seek_before(seekdb *s, long long first_id, int limit, seekdb_row_cb cb, void *user, char *err, size_t errlen) {
-    char sql[1024];
-    snprintf(sql, sizeof(sql),
-        "SELECT * FROM \"%s\" WHERE \"%s\" < %lld ORDER BY \"%s\" DESC LIMIT %d;",
-        s->view_name, s->key_name, first_id, s->key_name, limit);
-    return run_window(s, sql, cb, user, err, errlen);
+    return seek_bounded(s, STMT_BEFORE, first_id, limit, cb, user, err, errlen);
 }
 
 int seekdb_seek_by_id(seekdb *s, long long target_id, int limit, seekdb_row_cb cb, void *user, char *err, size_t errlen) {
-    char sql[1024];
-    snprintf(sql, sizeof(sql),
-        "SELECT * FROM \"%s\" WHERE \"%s\" >= %lld ORDER BY \"%s\" LIMIT %d;",
-        s->view_name, s->key_name, target_id, s->key_name, limit);
-    return run_window(s, sql, cb, user, err, errlen);
+    return seek_bounded(s, STMT_BY_ID, target_id, limit, cb, user, err, errlen);
 }
 
-long long seekdb_count(seekdb *s, char *err, size_t errlen) {
-    char sql[256];
-    snprintf(sql, sizeof(sql), "SELECT COUNT(*) FROM \"%s\";", s->view_name);
+/* Changes on any commit to the main database, by this connection or
+   another one, so a cached count knows when it is stale. The pager only
+   notices other connections' commits when a read starts, hence the
+   (cheap) PRAGMA first. */
+static unsigned data_version(seekdb *s) {
+    unsigned v = 0;
+    sqlite3_stmt *st = stmt_get(s, STMT_DATA_VERSION, NULL, 0);
+    if (st) {
+        (void)sqlite3_step(st);
+        sqlite3_reset(st);
+    }
+    sqlite3_file_control(s->db, "main", SQLITE_FCNTL_DATA_VERSION, &v);
+    return v;
+}
+
+static int count_fresh(seekdb *s) {
+    return s->count_valid && s->count_version == data_version(s);
+}
+
+static void count_remember(seekdb *s, long long n, int exact) {
+    s->count_rows = n;
+    s->count_exact = exact;
+    s->count_version = data_version(s);
+    s->count_valid = 1;
+}
+
+/* Row estimate for an unfiltered view: the table's sqlite_stat1 row count
+   (after ANALYZE), else the rowid span, which is exact until rows are
+   deleted. Both are index lookups. <0 when neither is available. */
+static long long estimate_rows(seekdb *s) {
     sqlite3_stmt *st = NULL;
-    if (sqlite3_prepare_v2(s->db, sql, -1, &st, NULL) != SQLITE_OK) {
-        set_err(err, errlen, sqlite3_errmsg(s->db)); return -1;
+    long long n = -1;
+    if (sqlite3_prepare_v2(s->db, "SELECT stat FROM sqlite_stat1 WHERE tbl = ?1 LIMIT 1;", -1, &st, NULL) == SQLITE_OK) {
+        sqlite3_bind_text(st, 1, s->base_table, -1, SQLITE_STATIC);
+        if (sqlite3_step(st) == SQLITE_ROW && sqlite3_column_text(st, 0)) {
+            n = strtoll((const char *)sqlite3_column_text(st, 0), NULL, 10);
+        }
+    }
+    sqlite3_finalize(st);
+    if (n > 0) return n;
+
+    sqlbuf b = {0};
+    st = NULL;
+    sb_appendf(&b, "SELECT (SELECT max(rowid) FROM \"%s\") - (SELECT min(rowid) FROM \"%s\") + 1;",
+               s->base_table, s->base_table);
+    n = -1;
+    if (!b.oom && sqlite3_prepare_v2(s->db, b.buf, -1, &st, NULL) == SQLITE_OK && sqlite3_step(st) == SQLITE_ROW) {
+        n = (sqlite3_column_type(st, 0) == SQLITE_NULL) ? 0 : sqlite3_column_int64(st, 0);
     }
+    sqlite3_finalize(st);
+    free(b.buf);
+    return n;
+}
+
+long long seekdb_count(seekdb *s, char *err, size_t errlen) {
+    if (count_fresh(s) && s->count_exact) return s->count_rows;
+    sqlite3_stmt *st = stmt_get(s, STMT_COUNT_ROWS, err, errlen);
+    if (!st) return -1;
     long long n = -1;
     if (sqlite3_step(st) == SQLITE_ROW) n = sqlite3_column_int64(st, 0);
-    sqlite3_finalize(st);
+    else set_err(err, errlen, sqlite3_errmsg(s->db));
+    sqlite3_reset(st);
+    if (n >= 0) count_remember(s, n, 1);
     return n;
 }
 
+long long seekdb_count_estimate(seekdb *s, int *exact) {
+    if (exact) *exact = 0;
+    if (!s || !s->base_table) return -1;
+    if (!count_fresh(s)) {
+        if (s->where_sql) return -1;
+        long long n = estimate_rows(s);
+        if (n < 0) return -1;
+        count_remember(s, n, 0);
+    }
+    if (exact) *exact = s->count_exact;
+    return s->count_rows;
+}
+
+void seekdb_count_store(seekdb *s, long long rows) {
+    if (s && s->base_table && rows >= 0) count_remember(s, rows, 1);
+}
+
 int seekdb_save_as(seekdb *s, const char *dest_path, char *err, size_t errlen) {
     char esc[1024]; size_t j=0;
     for (size_t i=0; dest_path[i] && j<sizeof(esc)-2; ++i) {
@@ -243,35 +1329,929 @@ int seekdb_save_as(seekdb *s, const char *dest_path, char *err, size_t errlen) {
 
 void seekdb_close(seekdb *s) {
     if (!s) return;
+    seekdb_ingest_abort(s);
+    finalize_stmts(s);
     if (s->db) sqlite3_close(s->db);
     free(s->view_name);
     free(s->key_name);
+    free(s->base_table);
+    free(s->where_sql);
+    free(s->filter_arg);
+    for (int i = 0; i < s->known_index_count; ++i) free(s->known_indexes[i]);
+    free(s->known_indexes);
+    free_order(s);
+    free_fts_cols(s);
+    free_columns(s);
+    clear_projection(s);
     if (s->tmpdir) {
-        char path[512];
-        snprintf(path, sizeof(path), "%s/spill.db", s->tmpdir);
-        (void)unlink(path);
-        (void)rmdir(s->tmpdir);
+        remove_spill_dir(s->tmpdir);
         free(s->tmpdir);
     }
     free(s);
 }
 
+int seekdb_view_column_count(seekdb *s, char *err, size_t errlen) {
+    if (!s || !s->db) { set_err(err, errlen, "bad args"); return -1; }
+    return load_columns(s, err, errlen) == 0 ? s->col_count : -1;
+}
+
+static int copy_strings(char **src, int n, char ***out, char *err, size_t errlen) {
+    char **arr = (char**)calloc((size_t)n, sizeof(char*));
+    if (!arr) { set_err(err, errlen, "oom"); return -1; }
+    for (int i = 0; i < n; ++i) arr[i] = strdup(src[i]);
+    *out = arr;
+    return n;
+}
+
 int seekdb_get_view_columns(seekdb *s, char ***names_out, char *err, size_t errlen) {
     if (!s || !s->db || !names_out) { set_err(err, errlen, "bad args"); return -1; }
     *names_out = NULL;
-    char sql[256];
-    snprintf(sql, sizeof(sql), "SELECT * FROM \"%s\" LIMIT 0;", s->view_name);
+    if (load_columns(s, err, errlen) != 0) return -1;
+    return copy_strings(s->col_names, s->col_count, names_out, err, errlen);
+}
+
+int seekdb_view_key_column(seekdb *s, char *err, size_t errlen) {
+    if (!s || !s->db) { set_err(err, errlen, "bad args"); return -1; }
+    if (load_columns(s, err, errlen) != 0) return -1;
+    for (int i = 0; i < s->col_count; ++i) {
+        if (strcmp(s->col_names[i], s->key_name) == 0) return i;
+    }
+    return -1;
+}
+
+long long seekdb_scan(seekdb *s, seekdb_row_cb cb, void *user, char *err, size_t errlen) {
+    long long rows = 0;
+    int rc;
+
+    if (!s || !s->base_table || !cb) { set_err(err, errlen, "bad args"); return -1; }
+    sqlite3_stmt *st = stmt_get(s, STMT_SCAN, err, errlen);
+    if (!st) return -1;
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        rows++;
+        if (!cb(user, st)) { rc = SQLITE_DONE; break; }
+    }
+    if (rc != SQLITE_DONE) set_err(err, errlen, sqlite3_errmsg(s->db));
+    sqlite3_reset(st);
+    return rc == SQLITE_DONE ? rows : -1;
+}
+
+int seekdb_get_view_column_types(seekdb *s, char ***types_out, char *err, size_t errlen) {
+    if (!s || !s->db || !types_out) { set_err(err, errlen, "bad args"); return -1; }
+    *types_out = NULL;
+    if (load_columns(s, err, errlen) != 0) return -1;
+    return copy_strings(s->col_decls, s->col_count, types_out, err, errlen);
+}
+
+int seekdb_set_projection(seekdb *s, const int *cols, int count, char *err, size_t errlen) {
+    if (!s || !s->db || count < 0 || (count > 0 && !cols)) { set_err(err, errlen, "bad args"); return -1; }
+    if (count == 0) {
+        if (s->proj) { clear_projection(s); finalize_window_stmts(s); }
+        return 0;
+    }
+    if (load_columns(s, err, errlen) != 0) return -1;
+    for (int i = 0; i < count; ++i) {
+        if (cols[i] < 0 || cols[i] >= s->col_count) { set_err(err, errlen, "column out of range"); return -1; }
+    }
+    if (s->proj && s->proj_count == count && memcmp(s->proj, cols, sizeof(int) * (size_t)count) == 0) return 0;
+    int *copy = malloc(sizeof(int) * (size_t)count);
+    if (!copy) { set_err(err, errlen, "oom"); return -1; }
+    memcpy(copy, cols, sizeof(int) * (size_t)count);
+    clear_projection(s);
+    s->proj = copy;
+    s->proj_count = count;
+    finalize_window_stmts(s);
+    return 0;
+}
+
+/* --------------------------
+   Keyed writes
+   -------------------------- */
+
+int seekdb_write_begin(seekdb *s, char *err, size_t errlen) {
+    if (!s || !s->db || !s->base_table) { set_err(err, errlen, "no view"); return -1; }
+    if (s->ingest_stmt) { set_err(err, errlen, "a bulk load is in progress"); return -1; }
+    if (s->write_depth > 0) { s->write_depth++; return 0; }
+    /* Only a count that is current now can be carried across the batch */
+    s->count_lost = !count_fresh(s);
+    s->count_delta = 0;
+    if (exec_sql(s->db, "BEGIN IMMEDIATE;", err, errlen) != SQLITE_OK) return -1;
+    s->write_depth = 1;
+    return 0;
+}
+
+int seekdb_write_commit(seekdb *s, char *err, size_t errlen) {
+    if (!s || s->write_depth <= 0) { set_err(err, errlen, "no write batch"); return -1; }
+    if (--s->write_depth > 0) return 0;
+    if (exec_sql(s->db, "COMMIT;", err, errlen) != SQLITE_OK) {
+        seekdb_write_rollback(s);
+        return -1;
+    }
+    if (!s->count_lost) count_remember(s, s->count_rows + s->count_delta, s->count_exact);
+    return 0;
+}
+
+void seekdb_write_rollback(seekdb *s) {
+    if (!s || s->write_depth <= 0) return;
+    s->write_depth = 0;
+    (void)exec_sql(s->db, "ROLLBACK;", NULL, 0);
+}
+
+/* Runs st (bound already) inside the open batch */
+static int step_write(seekdb *s, sqlite3_stmt *st, char *err, size_t errlen) {
+    int rc = sqlite3_step(st);
+    if (rc != SQLITE_DONE) set_err(err, errlen, sqlite3_errmsg(s->db));
+    sqlite3_reset(st);
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+static void bind_value(sqlite3_stmt *st, int idx, const char *value) {
+    if (value) sqlite3_bind_text(st, idx, value, -1, SQLITE_TRANSIENT);
+    else sqlite3_bind_null(st, idx);
+}
+
+int seekdb_update_cell(seekdb *s, long long id, int col, const char *value, char *err, size_t errlen) {
+    sqlite3_stmt *st;
+    int own;
+
+    if (!s || !s->db || load_columns(s, err, errlen) != 0) return -1;
+    if (col < 0 || col >= s->col_count) { set_err(err, errlen, "column out of range"); return -1; }
+    if (strcmp(s->col_names[col], s->key_name) == 0) { set_err(err, errlen, "the row key cannot be changed"); return -1; }
+    own = (s->write_depth == 0);
+    if (own && seekdb_write_begin(s, err, errlen) != 0) return -1;
+    if (s->stmts[STMT_UPDATE] && s->update_col != col) {
+        sqlite3_finalize(s->stmts[STMT_UPDATE]);
+        s->stmts[STMT_UPDATE] = NULL;
+    }
+    s->update_col = col;
+    if (!(st = stmt_get(s, STMT_UPDATE, err, errlen))) goto fail;
+    bind_value(st, 1, value);
+    sqlite3_bind_int64(st, 2, id);
+    if (step_write(s, st, err, errlen) != 0) goto fail;
+    if (s->where_sql) s->count_lost = 1; /* the row may have left or joined the view */
+    if (own && seekdb_write_commit(s, err, errlen) != 0) return -1;
+    return 0;
+fail:
+    if (own) seekdb_write_rollback(s);
+    return -1;
+}
+
+int seekdb_insert_row(seekdb *s, const char *const *values, int count, long long *id_out, char *err, size_t errlen) {
+    sqlite3_stmt *st;
+    long long id = 0;
+    int own;
+
+    if (!s || !s->db || load_columns(s, err, errlen) != 0) return -1;
+    if (count != s->col_count) { set_err(err, errlen, "column count mismatch"); return -1; }
+    own = (s->write_depth == 0);
+    if (own && seekdb_write_begin(s, err, errlen) != 0) return -1;
+    /* The next key is read inside the batch, so no other writer takes it */
+    if (!(st = stmt_get(s, STMT_NEXT_KEY, err, errlen))) goto fail;
+    if (sqlite3_step(st) == SQLITE_ROW) id = sqlite3_column_int64(st, 0);
+    else set_err(err, errlen, sqlite3_errmsg(s->db));
+    sqlite3_reset(st);
+    if (id <= 0 || !(st = stmt_get(s, STMT_INSERT, err, errlen))) goto fail;
+    /* Every parameter is bound, FILTER_PARAM included on wide tables */
+    for (int i = 0; i < count; ++i) {
+        if (strcmp(s->col_names[i], s->key_name) == 0) sqlite3_bind_int64(st, i + 1, id);
+        else bind_value(st, i + 1, values ? values[i] : NULL);
+    }
+    if (step_write(s, st, err, errlen) != 0) goto fail;
+    if (s->where_sql) s->count_lost = 1; /* the row may not pass the filter */
+    else s->count_delta++;
+    if (own && seekdb_write_commit(s, err, errlen) != 0) return -1;
+    if (id_out) *id_out = id;
+    return 0;
+fail:
+    if (own) seekdb_write_rollback(s);
+    return -1;
+}
+
+int seekdb_delete_row(seekdb *s, long long id, char *err, size_t errlen) {
+    sqlite3_stmt *st;
+    int own;
+
+    if (!s || !s->db) { set_err(err, errlen, "bad args"); return -1; }
+    own = (s->write_depth == 0);
+    if (own && seekdb_write_begin(s, err, errlen) != 0) return -1;
+    if (!(st = stmt_get(s, STMT_DELETE, err, errlen))) goto fail;
+    sqlite3_bind_int64(st, 1, id);
+    if (step_write(s, st, err, errlen) != 0) goto fail;
+    if (s->where_sql) s->count_lost = 1; /* the row may not have been in the view */
+    else s->count_delta -= sqlite3_changes(s->db);
+    if (own && seekdb_write_commit(s, err, errlen) != 0) return -1;
+    return 0;
+fail:
+    if (own) seekdb_write_rollback(s);
+    return -1;
+}
+
+/* --------------------------
+   Bulk load
+   -------------------------- */
+
+static int table_has_column(seekdb *s, const char *table, const char *column, char *err, size_t errlen) {
+    char sql[320];
     sqlite3_stmt *st = NULL;
+    int found = 0;
+
+    snprintf(sql, sizeof(sql), "PRAGMA table_info(\"%s\");", table);
+    if (sqlite3_prepare_v2(s->db, sql, -1, &st, NULL) != SQLITE_OK) {
+        set_err(err, errlen, sqlite3_errmsg(s->db));
+        return -1;
+    }
+    while (!found && sqlite3_step(st) == SQLITE_ROW) {
+        const unsigned char *name = sqlite3_column_text(st, 1);
+        found = name && strcmp((const char*)name, column) == 0;
+    }
+    sqlite3_finalize(st);
+    return found;
+}
+
+/* Durability only matters once the load is complete: a spill database
+   (throwaway by nature) drops its journal, any other one stops syncing. */
+static void ingest_relax(seekdb *s) {
+    (void)exec_sql(s->db, "PRAGMA synchronous=OFF;", NULL, 0);
+    if (s->tmpdir) s->ingest_relaxed = exec_sql(s->db, "PRAGMA journal_mode=OFF;", NULL, 0) == SQLITE_OK;
+}
+
+static void ingest_restore(seekdb *s) {
+    if (s->ingest_relaxed) (void)exec_sql(s->db, "PRAGMA journal_mode=WAL;", NULL, 0);
+    (void)exec_sql(s->db, "PRAGMA synchronous=NORMAL;", NULL, 0);
+    s->ingest_relaxed = 0;
+}
+
+static void ingest_free(seekdb *s) {
+    sqlite3_finalize(s->ingest_stmt);
+    s->ingest_stmt = NULL;
+    free(s->ingest_table);
+    s->ingest_table = NULL;
+    free(s->ingest_key);
+    s->ingest_key = NULL;
+    s->ingest_cols = 0;
+    s->ingest_pending = 0;
+}
+
+/* Copies a tmpfs spill to a disk spill directory with the backup API and
+   switches to it. Runs between transactions; cached statements are
+   dropped and the bulk insert re-prepared. Returns <0 (and leaves the
+   spill where it was) when no disk directory takes the copy. */
+static int spill_promote(seekdb *s) {
+    char *dir = disk_spill_dir();
+    char path[PATH_MAX];
+    sqlite3 *db = NULL;
+    sqlite3_stmt *ingest = NULL;
+    sqlite3_backup *bk;
+    int rc;
+
+    if (!dir) return -1;
+    snprintf(path, sizeof(path), "%s/spill.db", dir);
+    rc = sqlite3_open(path, &db);
+    if (rc == SQLITE_OK) {
+        /* the copy takes the source's page size */
+        if (!(bk = sqlite3_backup_init(db, "main", s->db, "main"))) {
+            rc = sqlite3_errcode(db);
+        } else {
+            (void)sqlite3_backup_step(bk, -1);
+            rc = sqlite3_backup_finish(bk);
+        }
+    }
+    if (rc == SQLITE_OK) rc = apply_pragmas(db, s->mode);
+    if (rc == SQLITE_OK) rc = register_functions(db);
+    if (rc == SQLITE_OK && s->ingest_stmt) {
+        rc = sqlite3_prepare_v3(db, sqlite3_sql(s->ingest_stmt), -1, SQLITE_PREPARE_PERSISTENT, &ingest, NULL);
+    }
+    if (rc != SQLITE_OK) {
+        sqlite3_close(db);
+        remove_spill_dir(dir);
+        free(dir);
+        return -1;
+    }
+
+    finalize_stmts(s);
+    sqlite3_finalize(s->ingest_stmt);
+    s->ingest_stmt = ingest;
+    sqlite3_close(s->db);
+    remove_spill_dir(s->tmpdir);
+    free(s->tmpdir);
+    s->db = db;
+    s->tmpdir = dir;
+    s->spill_limit = 0;
+    s->count_valid = 0; /* data versions are per connection */
+    if (s->ingest_relaxed) ingest_relax(s);
+    return 0;
+}
+
+/* Moves a tmpfs spill to disk once it outgrows spill_limit. in_txn: called
+   inside the ingest transaction, which is committed around the copy. */
+static int spill_check(seekdb *s, int in_txn, char *err, size_t errlen) {
+    sqlite3_stmt *st = NULL;
+    unsigned long long bytes = 0;
+
+    if (!s->spill_limit) return 0;
+    if (sqlite3_prepare_v2(s->db, "SELECT page_count * page_size FROM pragma_page_count, pragma_page_size;",
+                           -1, &st, NULL) == SQLITE_OK && sqlite3_step(st) == SQLITE_ROW) {
+        bytes = (unsigned long long)sqlite3_column_int64(st, 0);
+    }
+    sqlite3_finalize(st);
+    if (bytes <= s->spill_limit) return 0;
+
+    if (in_txn) {
+        if (exec_sql(s->db, "COMMIT;", err, errlen) != SQLITE_OK) return -1;
+        s->ingest_pending = 0;
+    }
+    /* Without a writable disk directory the spill stays on tmpfs */
+    if (spill_promote(s) != 0) s->spill_limit = 0;
+    if (in_txn && exec_sql(s->db, "BEGIN;", err, errlen) != SQLITE_OK) return -1;
+    return 0;
+}
+
+int seekdb_ingest_begin(seekdb *s, const char *table, const char *const *columns, int count, const char *key,
+                        char *err, size_t errlen) {
+    sqlbuf b = {0};
+    sqlite3_stmt *st = NULL;
+    int has_key = 0;
+
+    if (!s || !s->db || !table || !columns || count <= 0) { set_err(err, errlen, "bad args"); return -1; }
+    if (s->ingest_stmt || s->write_depth > 0) { set_err(err, errlen, "a write is already in progress"); return -1; }
+    if (key) {
+        has_key = table_has_column(s, table, key, err, errlen);
+        if (has_key < 0) return -1;
+        if (!has_key) {
+            /* Added empty and filled as rows arrive; indexed at commit */
+            sb_appendf(&b, "ALTER TABLE \"%s\" ADD COLUMN ", table);
+            append_ident(&b, key);
+            sb_appendf(&b, " INTEGER;");
+            if (b.oom || exec_sql(s->db, b.buf, err, errlen) != SQLITE_OK) { free(b.buf); return -1; }
+            free(b.buf);
+            b = (sqlbuf){0};
+            if (s->base_table && strcmp(s->base_table, table) == 0) { finalize_stmts(s); free_columns(s); clear_projection(s); }
+        }
+        sb_appendf(&b, "SELECT COALESCE(MAX(");
+        append_ident(&b, key);
+        sb_appendf(&b, "), 0) + 1 FROM \"%s\";", table);
+        if (b.oom || sqlite3_prepare_v2(s->db, b.buf, -1, &st, NULL) != SQLITE_OK) {
+            set_err(err, errlen, b.oom ? "oom" : sqlite3_errmsg(s->db));
+            free(b.buf);
+            return -1;
+        }
+        s->ingest_next_key = sqlite3_step(st) == SQLITE_ROW ? sqlite3_column_int64(st, 0) : 1;
+        sqlite3_finalize(st);
+        free(b.buf);
+        b = (sqlbuf){0};
+    }
+
+    sb_appendf(&b, "INSERT INTO \"%s\" (", table);
+    for (int i = 0; i < count; ++i) {
+        if (i) sb_appendf(&b, ", ");
+        append_ident(&b, columns[i]);
+    }
+    if (key) { sb_appendf(&b, ", "); append_ident(&b, key); }
+    sb_appendf(&b, ") VALUES (");
+    for (int i = 0; i < count + (key ? 1 : 0); ++i) sb_appendf(&b, "%s?%d", i ? ", " : "", i + 1);
+    sb_appendf(&b, ");");
+    if (b.oom) { free(b.buf); set_err(err, errlen, "oom"); return -1; }
+    s->ingest_table = strdup(table);
+    s->ingest_key = key ? strdup(key) : NULL;
+    if (!s->ingest_table || (key && !s->ingest_key)) {
+        set_err(err, errlen, "oom");
+        free(b.buf);
+        ingest_free(s);
+        return -1;
+    }
+    if (sqlite3_prepare_v3(s->db, b.buf, -1, SQLITE_PREPARE_PERSISTENT, &s->ingest_stmt, NULL) != SQLITE_OK) {
+        set_err(err, errlen, sqlite3_errmsg(s->db));
+        free(b.buf);
+        ingest_free(s);
+        return -1;
+    }
+    free(b.buf);
+    s->ingest_cols = count;
+    s->ingest_rows = 0;
+    s->ingest_pending = 0;
+    ingest_relax(s);
+    if (exec_sql(s->db, "BEGIN;", err, errlen) != SQLITE_OK) {
+        ingest_restore(s);
+        ingest_free(s);
+        return -1;
+    }
+    return 0;
+}
+
+int seekdb_ingest_append_row(seekdb *s, const char *const *values, char *err, size_t errlen) {
+    sqlite3_stmt *st = s ? s->ingest_stmt : NULL;
+
+    if (!st) { set_err(err, errlen, "no ingest in progress"); return -1; }
+    /* values only need to live through this call: the row is stepped here */
+    for (int i = 0; i < s->ingest_cols; ++i) {
+        if (values && values[i]) sqlite3_bind_text(st, i + 1, values[i], -1, SQLITE_STATIC);
+        else sqlite3_bind_null(st, i + 1);
+    }
+    if (s->ingest_key) sqlite3_bind_int64(st, s->ingest_cols + 1, s->ingest_next_key);
+    if (sqlite3_step(st) != SQLITE_DONE) {
+        set_err(err, errlen, sqlite3_errmsg(s->db));
+        sqlite3_reset(st);
+        return -1;
+    }
+    sqlite3_reset(st);
+    s->ingest_next_key++;
+    s->ingest_rows++;
+    if (++s->ingest_pending >= INGEST_BATCH_ROWS) {
+        if (exec_sql(s->db, "COMMIT; BEGIN;", err, errlen) != SQLITE_OK) return -1;
+        s->ingest_pending = 0;
+    }
+    if (s->ingest_rows % SPILL_CHECK_ROWS == 0 && spill_check(s, 1, err, errlen) != 0) return -1;
+    return 0;
+}
+
+long long seekdb_ingest_commit(seekdb *s, char *err, size_t errlen) {
+    long long rows;
+    int rc = 0;
+
+    if (!s || !s->ingest_stmt) { set_err(err, errlen, "no ingest in progress"); return -1; }
+    rows = s->ingest_rows;
+    sqlite3_finalize(s->ingest_stmt);
+    s->ingest_stmt = NULL;
+    if (exec_sql(s->db, "COMMIT;", err, errlen) != SQLITE_OK) rc = -1;
+    ingest_restore(s);
+    /* One sort per index instead of a b-tree update per row */
+    if (rc == 0 && s->ingest_key) {
+        /* same index seekdb_ensure_stable_key creates */
+        sqlbuf b = {0};
+        sb_appendf(&b, "CREATE UNIQUE INDEX IF NOT EXISTS \"idx_%s_%s\" ON \"%s\"(",
+                   s->ingest_table, s->ingest_key, s->ingest_table);
+        append_ident(&b, s->ingest_key);
+        sb_appendf(&b, ");");
+        if (b.oom || exec_sql(s->db, b.buf, err, errlen) != SQLITE_OK) rc = -1;
+        free(b.buf);
+    }
+    if (rc == 0 && s->base_table && strcmp(s->base_table, s->ingest_table) == 0 && s->order_count > 0) {
+        rc = ensure_order_index(s, err, errlen);
+    }
+    if (rc == 0) rc = spill_check(s, 0, err, errlen);
+    ingest_free(s);
+    return rc == 0 ? rows : -1;
+}
+
+void seekdb_ingest_abort(seekdb *s) {
+    if (!s || !s->ingest_stmt) return;
+    sqlite3_finalize(s->ingest_stmt);
+    s->ingest_stmt = NULL;
+    (void)exec_sql(s->db, "ROLLBACK;", NULL, 0);
+    ingest_restore(s);
+    ingest_free(s);
+}
+
+int seekdb_decl_is_bool(const char *decl) {
+    return decl && sqlite3_strlike("%bool%", decl, 0) == 0;
+}
+
+const char *seekdb_bool_value(const char *text) {
+    if (!text) return NULL;
+    if (strcasecmp(text, "true") == 0) return "1";
+    if (strcasecmp(text, "false") == 0) return "0";
+    return text;
+}
+
+/* --------------------------
+   Full-text search (FTS5)
+   -------------------------- */
+
+/* Restrict matches (by key expression) to rows that pass the view filter. */
+static void append_view_filter(sqlbuf *b, seekdb *s, const char *rowid_expr) {
+    if (!s->where_sql) return;
+    sb_appendf(b, " AND EXISTS (SELECT 1 FROM \"%s\" WHERE \"%s\" = %s AND (%s))",
+               s->base_table, s->key_name, rowid_expr, s->where_sql);
+}
+
+static int load_fts_columns(seekdb *s, char *err, size_t errlen) {
+    char sql[512];
+    sqlite3_stmt *st = NULL;
+
+    free_fts_cols(s);
+    snprintf(sql, sizeof(sql), "PRAGMA table_info(\"%s\");", s->base_table);
     if (sqlite3_prepare_v2(s->db, sql, -1, &st, NULL) != SQLITE_OK) {
         set_err(err, errlen, sqlite3_errmsg(s->db)); return -1;
     }
-    int n = sqlite3_column_count(st);
-    char **arr = (char**)calloc((size_t)n, sizeof(char*));
-    for (int i = 0; i < n; ++i) {
-        const char *nm = sqlite3_column_name(st, i);
-        arr[i] = strdup(nm ? nm : "");
+    while (sqlite3_step(st) == SQLITE_ROW) {
+        const char *name = (const char *)sqlite3_column_text(st, 1);
+        if (!name || strcmp(name, s->key_name) == 0) continue;
+        char **grown = realloc(s->fts_cols, sizeof(char *) * (size_t)(s->fts_col_count + 1));
+        if (!grown) { sqlite3_finalize(st); set_err(err, errlen, "oom"); return -1; }
+        s->fts_cols = grown;
+        s->fts_cols[s->fts_col_count++] = strdup(name);
     }
     sqlite3_finalize(st);
-    *names_out = arr;
+    if (s->fts_col_count == 0) { set_err(err, errlen, "no columns to index"); return -1; }
+    return 0;
+}
+
+/* Existing index usable as-is? (present with one column per base column) */
+static int fts_index_matches(seekdb *s, const char *fts) {
+    char sql[512];
+    sqlite3_stmt *st = NULL;
+    int cols = 0;
+
+    snprintf(sql, sizeof(sql), "PRAGMA temp.table_info(\"%s\");", fts);
+    if (sqlite3_prepare_v2(s->db, sql, -1, &st, NULL) != SQLITE_OK) return 0;
+    while (sqlite3_step(st) == SQLITE_ROW) {
+        const char *name = (const char *)sqlite3_column_text(st, 1);
+        if (cols >= s->fts_col_count || !name || strcmp(name, s->fts_cols[cols]) != 0) { cols = -1; break; }
+        cols++;
+    }
+    sqlite3_finalize(st);
+    return cols == s->fts_col_count;
+}
+
+static void append_col_list(sqlbuf *b, seekdb *s, const char *prefix) {
+    for (int i = 0; i < s->fts_col_count; ++i) {
+        sb_appendf(b, "%s%s\"%s\"", i ? ", " : "", prefix, s->fts_cols[i]);
+    }
+}
+
+int seekdb_fts_ensure(seekdb *s, char *err, size_t errlen) {
+    if (!s || !s->base_table) { set_err(err, errlen, "no view"); return -1; }
+    if (s->fts_ready) return 0;
+    if (load_fts_columns(s, err, errlen) != 0) return -1;
+
+    char fts[300];
+    snprintf(fts, sizeof(fts), "_ttb_fts_%s", s->base_table);
+    if (fts_index_matches(s, fts)) { s->fts_ready = 1; return 0; }
+
+    /* The index and triggers live in this connection's TEMP schema, so the
+       database file is never written (read-only files work) and they go
+       away on close. Contentless: the rows stay in the base table, the index
+       only maps trigrams to keys. Trigger bodies name the index unqualified,
+       which finds the TEMP table first. */
+    const char *t = s->base_table, *k = s->key_name;
+    sqlbuf b = {0};
+    sb_appendf(&b, "BEGIN;"
+                   "DROP TRIGGER IF EXISTS temp.\"%s_ai\"; DROP TRIGGER IF EXISTS temp.\"%s_ad\";"
+                   "DROP TRIGGER IF EXISTS temp.\"%s_au\"; DROP TABLE IF EXISTS temp.\"%s\";", fts, fts, fts, fts);
+    sb_appendf(&b, "CREATE VIRTUAL TABLE temp.\"%s\" USING fts5(", fts);
+    append_col_list(&b, s, "");
+    sb_appendf(&b, ", content='', tokenize='trigram');");
+
+    /* Keep the index in step with later writes to the base table */
+    sb_appendf(&b, "CREATE TEMP TRIGGER \"%s_ai\" AFTER INSERT ON main.\"%s\" WHEN new.\"%s\" IS NOT NULL BEGIN "
+                   "INSERT INTO \"%s\"(rowid, ", fts, t, k, fts);
+    append_col_list(&b, s, "");
+    sb_appendf(&b, ") VALUES (new.\"%s\", ", k);
+    append_col_list(&b, s, "new.");
+    sb_appendf(&b, "); END;");
+
+    sb_appendf(&b, "CREATE TEMP TRIGGER \"%s_ad\" AFTER DELETE ON main.\"%s\" WHEN old.\"%s\" IS NOT NULL BEGIN "
+                   "INSERT INTO \"%s\"(\"%s\", rowid, ", fts, t, k, fts, fts);
+    append_col_list(&b, s, "");
+    sb_appendf(&b, ") VALUES ('delete', old.\"%s\", ", k);
+    append_col_list(&b, s, "old.");
+    sb_appendf(&b, "); END;");
+
+    sb_appendf(&b, "CREATE TEMP TRIGGER \"%s_au\" AFTER UPDATE ON main.\"%s\" BEGIN "
+                   "INSERT INTO \"%s\"(\"%s\", rowid, ", fts, t, fts, fts);
+    append_col_list(&b, s, "");
+    sb_appendf(&b, ") SELECT 'delete', old.\"%s\", ", k);
+    append_col_list(&b, s, "old.");
+    sb_appendf(&b, " WHERE old.\"%s\" IS NOT NULL; INSERT INTO \"%s\"(rowid, ", k, fts);
+    append_col_list(&b, s, "");
+    sb_appendf(&b, ") SELECT new.\"%s\", ", k);
+    append_col_list(&b, s, "new.");
+    sb_appendf(&b, " WHERE new.\"%s\" IS NOT NULL; END;", k);
+
+    sb_appendf(&b, "INSERT INTO temp.\"%s\"(rowid, ", fts);
+    append_col_list(&b, s, "");
+    sb_appendf(&b, ") SELECT \"%s\", ", k);
+    append_col_list(&b, s, "");
+    sb_appendf(&b, " FROM main.\"%s\" WHERE \"%s\" IS NOT NULL; COMMIT;", t, k);
+    if (b.oom) { free(b.buf); set_err(err, errlen, "oom"); return -1; }
+
+    int rc = exec_sql(s->db, b.buf, err, errlen);
+    free(b.buf);
+    if (rc != SQLITE_OK) {
+        sqlite3_exec(s->db, "ROLLBACK;", NULL, NULL, NULL);
+        return -1;
+    }
+    s->fts_ready = 1;
+    return 0;
+}
+
+/* Trigram needs three characters; shorter queries fall back to LIKE over the base table. */
+static int fts_query_usable(const char *query) {
+    return query && strlen(query) >= 3;
+}
+
+static char *fts_phrase(const char *query) {
+    size_t n = strlen(query);
+    char *out = malloc(n * 2 + 3);
+    if (!out) return NULL;
+    size_t j = 0;
+    out[j++] = '"';
+    for (size_t i = 0; i < n; ++i) {
+        if (query[i] == '"') out[j++] = '"';
+        out[j++] = query[i];
+    }
+    out[j++] = '"';
+    out[j] = '\0';
+    return out;
+}
+
+static char *like_pattern(const char *query) {
+    size_t n = strlen(query);
+    char *out = malloc(n * 2 + 3);
+    if (!out) return NULL;
+    size_t j = 0;
+    out[j++] = '%';
+    for (size_t i = 0; i < n; ++i) {
+        if (query[i] == '%' || query[i] == '_' || query[i] == '\\') out[j++] = '\\';
+        out[j++] = query[i];
+    }
+    out[j++] = '%';
+    out[j] = '\0';
+    return out;
+}
+
+/* Shared body of the search/count queries; kind is the STMT_FTS_* kind
+   (use_fts = 0 builds its LIKE variant). Bounded kinds bind the boundary's
+   order values from ?2 and come in two parts, like the other seeks. */
+static int build_fts_query(seekdb *s, sqlbuf *b, int use_fts, int kind, int nulls) {
+    const char *t = s->base_table, *k = s->key_name;
+    int bounded = (kind == STMT_FTS_AFTER || kind == STMT_FTS_BEFORE);
+    int reverse = (kind == STMT_FTS_BEFORE || kind == STMT_FTS_LAST);
+    char fts[300];
+    snprintf(fts, sizeof(fts), "_ttb_fts_%s", t);
+
+    if (use_fts && (kind == STMT_FTS_COUNT || s->order_count == 1)) {
+        /* Key order (or no order at all): walk the index in rowid order */
+        int desc = (s->order_desc[0] != reverse);
+        sb_appendf(b, "SELECT %s FROM temp.\"%s\" WHERE \"%s\" MATCH ?1",
+                   kind == STMT_FTS_COUNT ? "COUNT(*)" : "rowid", fts, fts);
+        if (bounded) sb_appendf(b, " AND rowid %s ?2", desc ? "<" : ">");
+        char outer[320];
+        snprintf(outer, sizeof(outer), "\"%s\".rowid", fts);
+        append_view_filter(b, s, outer);
+        if (kind != STMT_FTS_COUNT) sb_appendf(b, " ORDER BY rowid %s LIMIT ?%d", desc ? "DESC" : "ASC", bounded ? 3 : 2);
+        return b->oom ? -1 : 0;
+    }
+
+    if (kind == STMT_FTS_COUNT) sb_appendf(b, "SELECT COUNT(*) FROM \"%s\" WHERE ", t);
+    else sb_appendf(b, "SELECT \"%s\" FROM \"%s\" WHERE ", k, t);
+    if (use_fts) {
+        sb_appendf(b, "\"%s\" IN (SELECT rowid FROM temp.\"%s\" WHERE \"%s\" MATCH ?1)", k, fts, fts);
+    } else {
+        sb_appendf(b, "(");
+        for (int i = 0; i < s->fts_col_count; ++i) {
+            sb_appendf(b, "%s\"%s\" LIKE ?1 ESCAPE '\\'", i ? " OR " : "", s->fts_cols[i]);
+        }
+        sb_appendf(b, ")");
+    }
+    if (bounded) {
+        sb_appendf(b, " AND ");
+        append_seek_cond(b, s, reverse ? SEEK_BEFORE : SEEK_AFTER, 2, nulls);
+    }
+    if (s->where_sql) sb_appendf(b, " AND (%s)", s->where_sql);
+    if (kind != STMT_FTS_COUNT) {
+        append_order_by(b, s, reverse);
+        sb_appendf(b, " LIMIT ?%d", bounded ? s->order_count + 2 : 2);
+    }
+    return b->oom ? -1 : 0;
+}
+
+/* Cached search statement for base_kind (an STMT_FTS_* kind; its NULL part
+   when nulls) with the query bound as ?1; short queries use the LIKE variant
+   stored right after it. */
+static sqlite3_stmt *fts_stmt(seekdb *s, const char *query, int base_kind, int nulls, char *err, size_t errlen) {
+    if (!query || !*query) { set_err(err, errlen, "empty query"); return NULL; }
+    if (seekdb_fts_ensure(s, err, errlen) != 0) return NULL;
+
+    int use_fts = fts_query_usable(query);
+    sqlite3_stmt *st = stmt_get_part(s, use_fts ? base_kind : base_kind + 1, nulls, err, errlen);
+    if (!st) return NULL;
+    char *arg = use_fts ? fts_phrase(query) : like_pattern(query);
+    if (!arg) { set_err(err, errlen, "oom"); return NULL; }
+    sqlite3_bind_text(st, 1, arg, -1, free);
+    return st;
+}
+
+/* Steps st for up to limit keys into ids_out, then resets it. */
+static int step_ids(seekdb *s, sqlite3_stmt *st, int limit, long long *ids_out, char *err, size_t errlen) {
+    int n = 0;
+    int rc = SQLITE_DONE;
+    while (n < limit && (rc = sqlite3_step(st)) == SQLITE_ROW) {
+        ids_out[n++] = sqlite3_column_int64(st, 0);
+    }
+    if (n < limit && rc != SQLITE_DONE) { set_err(err, errlen, sqlite3_errmsg(s->db)); n = -1; }
+    sqlite3_reset(st);
+    return n;
+}
+
+static int fts_collect(seekdb *s, const char *query, long long bound, int kind,
+                       int limit, long long *ids_out, char *err, size_t errlen) {
+    if (!ids_out || limit <= 0) { set_err(err, errlen, "bad args"); return -1; }
+    /* LLONG_MIN/LLONG_MAX ask for the first/last match in view order */
+    int found = 0, n = 0;
+    if (bound != LLONG_MIN && bound != LLONG_MAX) {
+        int up = (kind == STMT_FTS_AFTER) != s->order_desc[0];
+        for (int part = 0; part < seek_parts(s) && n < limit; ++part) {
+            sqlite3_stmt *st = fts_stmt(s, query, kind, seek_part_nulls(s, up, part), err, errlen);
+            if (!st) return -1;
+            found = bind_boundary(s, st, 2, bound, err, errlen);
+            if (found <= 0) { sqlite3_reset(st); break; }
+            sqlite3_bind_int(st, s->order_count + 2, limit - n);
+            int got = step_ids(s, st, limit - n, ids_out + n, err, errlen);
+            if (got < 0) return -1;
+            n += got;
+        }
+        if (found < 0) return -1;
+        if (found > 0 || n > 0) return n;
+    }
+
+    /* No boundary, or its row is gone: start from the matching end of the view */
+    sqlite3_stmt *st = fts_stmt(s, query, kind == STMT_FTS_AFTER ? STMT_FTS_FIRST : STMT_FTS_LAST, 0, err, errlen);
+    if (!st) return -1;
+    sqlite3_bind_int(st, 2, limit);
+    return step_ids(s, st, limit, ids_out, err, errlen);
+}
+
+int seekdb_fts_search(seekdb *s, const char *query, long long after_id, int limit, long long *ids_out,
+                      char *err, size_t errlen) {
+    return fts_collect(s, query, after_id, STMT_FTS_AFTER, limit, ids_out, err, errlen);
+}
+
+int seekdb_fts_search_before(seekdb *s, const char *query, long long before_id, int limit, long long *ids_out,
+                             char *err, size_t errlen) {
+    return fts_collect(s, query, before_id, STMT_FTS_BEFORE, limit, ids_out, err, errlen);
+}
+
+long long seekdb_fts_count(seekdb *s, const char *query, char *err, size_t errlen) {
+    sqlite3_stmt *st = fts_stmt(s, query, STMT_FTS_COUNT, 0, err, errlen);
+    if (!st) return -1;
+    long long n = -1;
+    if (sqlite3_step(st) == SQLITE_ROW) n = sqlite3_column_int64(st, 0);
+    else set_err(err, errlen, sqlite3_errmsg(s->db));
+    sqlite3_reset(st);
+    return n;
+}
+
+/* Single-value query on a statement already bound; <0 on error. */
+static long long step_count(seekdb *s, sqlite3_stmt *st, char *err, size_t errlen) {
+    long long n = -1;
+    if (sqlite3_step(st) == SQLITE_ROW) n = sqlite3_column_int64(st, 0);
+    else set_err(err, errlen, sqlite3_errmsg(s->db));
+    sqlite3_reset(st);
+    return n;
+}
+
+long long seekdb_rank_of_id(seekdb *s, long long id, char *err, size_t errlen) {
+    if (!s || !s->base_table) { set_err(err, errlen, "no view"); return -1; }
+    long long n = 0;
+    for (int part = 0; part < seek_parts(s); ++part) {
+        sqlite3_stmt *st = stmt_get_part(s, STMT_RANK, seek_part_nulls(s, 1, part), err, errlen);
+        if (!st) return -1;
+        int found = bind_boundary(s, st, 1, id, err, errlen);
+        if (found <= 0) {
+            if (found == 0) set_err(err, errlen, "row not found");
+            return -1;
+        }
+        long long c = step_count(s, st, err, errlen);
+        if (c < 0) return -1;
+        n += c;
+    }
     return n;
 }
+
+/* --------------------------
+   Row positions (checkpoints)
+   -------------------------- */
+
+struct seekdb_checkpoints {
+    long long *ids;    /* ids[k] is the key of the row at position k * stride */
+    long long  count;
+    long long  rows;   /* view rows when built */
+    int        stride;
+};
+
+seekdb_checkpoints *seekdb_checkpoints_build(seekdb *s, int stride, char *err, size_t errlen) {
+    if (!s || !s->base_table || stride < 1) { set_err(err, errlen, "bad args"); return NULL; }
+    sqlite3_stmt *st = stmt_get(s, STMT_KEYS, err, errlen);
+    if (!st) return NULL;
+    seekdb_checkpoints *cp = calloc(1, sizeof(*cp));
+    if (!cp) { set_err(err, errlen, "oom"); return NULL; }
+    cp->stride = stride;
+
+    long long cap = 0;
+    int rc;
+    while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+        if (cp->rows % stride == 0) {
+            if (cp->count == cap) {
+                long long grown_cap = cap ? cap * 2 : 256;
+                long long *grown = realloc(cp->ids, sizeof(long long) * (size_t)grown_cap);
+                if (!grown) { rc = SQLITE_NOMEM; break; }
+                cp->ids = grown;
+                cap = grown_cap;
+            }
+            cp->ids[cp->count++] = sqlite3_column_int64(st, 0);
+        }
+        cp->rows++;
+    }
+    if (rc != SQLITE_DONE) {
+        set_err(err, errlen, rc == SQLITE_NOMEM ? "oom" : sqlite3_errmsg(s->db));
+        sqlite3_reset(st);
+        seekdb_checkpoints_free(cp);
+        return NULL;
+    }
+    sqlite3_reset(st);
+    return cp;
+}
+
+void seekdb_checkpoints_free(seekdb_checkpoints *cp) {
+    if (!cp) return;
+    free(cp->ids);
+    free(cp);
+}
+
+long long seekdb_checkpoints_rows(const seekdb_checkpoints *cp) {
+    return cp ? cp->rows : -1;
+}
+
+int seekdb_id_at_position(seekdb *s, const seekdb_checkpoints *cp, long long pos, long long *id_out,
+                          char *err, size_t errlen) {
+    if (!s || !cp || !id_out || pos < 0) { set_err(err, errlen, "bad args"); return -1; }
+    if (pos >= cp->rows) return 0;
+    long long k = pos / cp->stride;
+    long long skip = pos - k * cp->stride;
+    if (skip == 0) { *id_out = cp->ids[k]; return 1; }
+
+    /* Walk skip rows past the checkpoint, through both seek parts */
+    int up = !s->order_desc[0];
+    for (int part = 0; part < seek_parts(s); ++part) {
+        sqlite3_stmt *st = stmt_get_part(s, STMT_NTH, seek_part_nulls(s, up, part), err, errlen);
+        if (!st) return -1;
+        int found = bind_boundary(s, st, 1, cp->ids[k], err, errlen);
+        if (found <= 0) return found;
+        sqlite3_bind_int64(st, s->order_count + 1, skip + 1);
+        int rc;
+        while ((rc = sqlite3_step(st)) == SQLITE_ROW) {
+            if (skip-- == 0) {
+                *id_out = sqlite3_column_int64(st, 0);
+                sqlite3_reset(st);
+                return 1;
+            }
+        }
+        if (rc != SQLITE_DONE) set_err(err, errlen, sqlite3_errmsg(s->db));
+        sqlite3_reset(st);
+        if (rc != SQLITE_DONE) return -1;
+    }
+    return 0;
+}
+
+/* 1 when row id sorts at or after the row at checkpoint k, 0 when before
+   (or either row is gone), <0 on error. */
+static int sorts_from_checkpoint(seekdb *s, const seekdb_checkpoints *cp, long long k, long long id,
+                                 char *err, size_t errlen) {
+    long long n = 0;
+    for (int part = 0; part < seek_parts(s); ++part) {
+        sqlite3_stmt *st = stmt_get_part(s, STMT_SORTS_FROM, seek_part_nulls(s, 1, part), err, errlen);
+        if (!st) return -1;
+        int found = bind_boundary(s, st, 1, cp->ids[k], err, errlen);
+        if (found <= 0) return found;
+        sqlite3_bind_int64(st, s->order_count + 1, id);
+        long long c = step_count(s, st, err, errlen);
+        if (c < 0) return -1;
+        n += c;
+    }
+    return n > 0;
+}
+
+long long seekdb_position_of_id(seekdb *s, const seekdb_checkpoints *cp, long long id, char *err, size_t errlen) {
+    if (!s || !s->base_table) { set_err(err, errlen, "no view"); return -1; }
+    if (!cp || cp->count == 0) return seekdb_rank_of_id(s, id, err, errlen);
+
+    /* Last checkpoint at or before id */
+    long long lo = 0, hi = cp->count - 1;
+    int first = sorts_from_checkpoint(s, cp, 0, id, err, errlen);
+    if (first < 0) return -1;
+    if (first == 0) return seekdb_rank_of_id(s, id, err, errlen);
+    while (lo < hi) {
+        long long mid = lo + (hi - lo + 1) / 2;
+        int from = sorts_from_checkpoint(s, cp, mid, id, err, errlen);
+        if (from < 0) return -1;
+        if (from) lo = mid; else hi = mid - 1;
+    }
+
+    long long n = 0;
+    for (int part = 0; part < seek_parts(s); ++part) {
+        sqlite3_stmt *st = stmt_get_part(s, STMT_COUNT_BETWEEN, seek_part_nulls(s, 1, part), err, errlen);
+        if (!st) return -1;
+        int found = bind_boundary(s, st, 1, cp->ids[lo], err, errlen);
+        if (found > 0) found = bind_boundary(s, st, s->order_count + 1, id, err, errlen);
+        if (found < 0) return -1;
+        if (found == 0) return seekdb_rank_of_id(s, id, err, errlen);
+        long long c = step_count(s, st, err, errlen);
+        if (c < 0) return -1;
+        n += c;
+    }
+    return lo * cp->stride + n;
+}
+
+void seekdb_interrupt(seekdb *s) {
+    if (s && s->db) sqlite3_interrupt(s->db);
+}
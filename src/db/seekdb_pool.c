@@ -0,0 +1,244 @@
+#include "seekdb_pool.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct pool_job {
+    seekdb_job_fn fn;
+    void *arg;
+    long long id;
+    struct pool_job *next;
+} pool_job;
+
+typedef struct {
+    seekdb_pool *pool;
+    pthread_t thread;
+    seekdb *reader;
+    seekdb *next_reader;  /* swapped in before the next job (seekdb_pool_reset) */
+    long long running;    /* id of the job being run, 0 when idle */
+} pool_worker;
+
+struct seekdb_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;  /* a job was queued, or stop */
+    pthread_cond_t idle;  /* the queue drained and no job runs */
+    pool_job *head;
+    pool_job *tail;
+    long long next_id;
+    int busy;
+    int stop;
+    int worker_count;
+    pool_worker *workers;
+};
+
+static void set_err(char *err, size_t errlen, const char *msg) {
+    if (!err || errlen == 0) return;
+    snprintf(err, errlen, "%s", msg ? msg : "error");
+}
+
+static void *worker_main(void *arg) {
+    pool_worker *w = arg;
+    seekdb_pool *p = w->pool;
+
+    pthread_mutex_lock(&p->lock);
+    for (;;) {
+        while (!p->stop && !p->head) pthread_cond_wait(&p->wake, &p->lock);
+        if (p->stop) break;
+        pool_job *job = p->head;
+        p->head = job->next;
+        if (!p->head) p->tail = NULL;
+        if (w->next_reader) {
+            seekdb_close(w->reader);
+            w->reader = w->next_reader;
+            w->next_reader = NULL;
+        }
+        w->running = job->id;
+        p->busy++;
+        pthread_mutex_unlock(&p->lock);
+
+        job->fn(w->reader, job->arg);
+        free(job);
+
+        pthread_mutex_lock(&p->lock);
+        w->running = 0;
+        p->busy--;
+        if (!p->head && p->busy == 0) pthread_cond_broadcast(&p->idle);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+/* Both run with p->lock held. */
+static void interrupt_running(seekdb_pool *p, long long id) {
+    for (int i = 0; i < p->worker_count; ++i) {
+        pool_worker *w = &p->workers[i];
+        if (w->running && (id == 0 || w->running == id)) seekdb_interrupt(w->reader);
+    }
+}
+
+/* Unlinks the queued jobs (all when id is 0); the caller runs them as
+   cancelled once the lock is dropped. */
+static pool_job *take_queued(seekdb_pool *p, long long id) {
+    pool_job *taken = NULL, **tail = &taken;
+    pool_job **link = &p->head;
+
+    p->tail = NULL;
+    while (*link) {
+        pool_job *job = *link;
+        if (id == 0 || job->id == id) {
+            *link = job->next;
+            job->next = NULL;
+            *tail = job;
+            tail = &job->next;
+        } else {
+            p->tail = job;
+            link = &job->next;
+        }
+    }
+    if (!p->head && p->busy == 0) pthread_cond_broadcast(&p->idle);
+    return taken;
+}
+
+static void run_cancelled(pool_job *jobs) {
+    while (jobs) {
+        pool_job *next = jobs->next;
+        jobs->fn(NULL, jobs->arg);
+        free(jobs);
+        jobs = next;
+    }
+}
+
+static void close_readers(seekdb **readers, int n) {
+    for (int i = 0; i < n; ++i) seekdb_close(readers[i]);
+    free(readers);
+}
+
+/* All or nothing: n readers over the current view of s. */
+static seekdb **open_readers(const seekdb *s, int n, char *err, size_t errlen) {
+    seekdb **readers = calloc((size_t)n, sizeof(*readers));
+    if (!readers) { set_err(err, errlen, "oom"); return NULL; }
+    for (int i = 0; i < n; ++i) {
+        if (!(readers[i] = seekdb_open_reader(s, err, errlen))) {
+            close_readers(readers, i);
+            return NULL;
+        }
+    }
+    return readers;
+}
+
+seekdb_pool *seekdb_pool_open(const seekdb *s, int readers, char *err, size_t errlen) {
+    seekdb_pool *p;
+    seekdb **conns;
+
+    if (!s || readers <= 0) { set_err(err, errlen, "bad args"); return NULL; }
+    if (!(p = calloc(1, sizeof(*p))) || !(p->workers = calloc((size_t)readers, sizeof(pool_worker)))) {
+        free(p);
+        set_err(err, errlen, "oom");
+        return NULL;
+    }
+    if (!(conns = open_readers(s, readers, err, errlen))) {
+        free(p->workers);
+        free(p);
+        return NULL;
+    }
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->wake, NULL);
+    pthread_cond_init(&p->idle, NULL);
+    for (int i = 0; i < readers; ++i) {
+        pool_worker *w = &p->workers[p->worker_count];
+        w->pool = p;
+        w->reader = conns[i];
+        conns[i] = NULL;
+        if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+            seekdb_close(w->reader);
+            w->reader = NULL;
+            continue;
+        }
+        p->worker_count++;
+    }
+    free(conns);
+    if (p->worker_count == 0) {
+        set_err(err, errlen, "cannot start worker threads");
+        seekdb_pool_close(p);
+        return NULL;
+    }
+    return p;
+}
+
+long long seekdb_pool_submit(seekdb_pool *p, seekdb_job_fn fn, void *arg) {
+    pool_job *job;
+    long long id;
+
+    if (!p || !fn || !(job = calloc(1, sizeof(*job)))) return -1;
+    job->fn = fn;
+    job->arg = arg;
+    pthread_mutex_lock(&p->lock);
+    id = job->id = ++p->next_id;
+    if (p->tail) p->tail->next = job; else p->head = job;
+    p->tail = job;
+    pthread_cond_signal(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+    return id;
+}
+
+void seekdb_pool_cancel(seekdb_pool *p, long long id) {
+    pool_job *cancelled;
+
+    if (!p || id <= 0) return;
+    pthread_mutex_lock(&p->lock);
+    cancelled = take_queued(p, id);
+    if (!cancelled) interrupt_running(p, id);
+    pthread_mutex_unlock(&p->lock);
+    run_cancelled(cancelled);
+}
+
+int seekdb_pool_reset(seekdb_pool *p, const seekdb *s, char *err, size_t errlen) {
+    seekdb **conns;
+    pool_job *cancelled;
+
+    if (!p || !s) { set_err(err, errlen, "bad args"); return -1; }
+    if (!(conns = open_readers(s, p->worker_count, err, errlen))) return -1;
+    pthread_mutex_lock(&p->lock);
+    cancelled = take_queued(p, 0);
+    interrupt_running(p, 0);
+    for (int i = 0; i < p->worker_count; ++i) {
+        seekdb_close(p->workers[i].next_reader);
+        p->workers[i].next_reader = conns[i];
+    }
+    pthread_mutex_unlock(&p->lock);
+    free(conns);
+    run_cancelled(cancelled);
+    return 0;
+}
+
+void seekdb_pool_wait(seekdb_pool *p) {
+    if (!p) return;
+    pthread_mutex_lock(&p->lock);
+    while (p->head || p->busy > 0) pthread_cond_wait(&p->idle, &p->lock);
+    pthread_mutex_unlock(&p->lock);
+}
+
+void seekdb_pool_close(seekdb_pool *p) {
+    pool_job *cancelled;
+
+    if (!p) return;
+    pthread_mutex_lock(&p->lock);
+    p->stop = 1;
+    cancelled = take_queued(p, 0);
+    interrupt_running(p, 0);
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+    run_cancelled(cancelled);
+
+    for (int i = 0; i < p->worker_count; ++i) {
+        pthread_join(p->workers[i].thread, NULL);
+        seekdb_close(p->workers[i].reader);
+        seekdb_close(p->workers[i].next_reader);
+    }
+    pthread_cond_destroy(&p->idle);
+    pthread_cond_destroy(&p->wake);
+    pthread_mutex_destroy(&p->lock);
+    free(p->workers);
+    free(p);
+}
@@ -0,0 +1,542 @@
+#include "table_vtab.h"
+#include "table_ops.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TABLE_VTAB_MODULE "ttb_table"
+
+static void set_err(char *err, size_t err_sz, const char *msg) {
+    if (!err || err_sz == 0) return;
+    snprintf(err, err_sz, "%s", msg ? msg : "error");
+}
+
+typedef struct {
+    char *name;
+    const Table *table;
+} VtabEntry;
+
+// Module client data: the tables attached on db, looked up by name when
+// SQLite connects one of them
+struct TableVtabModule {
+    sqlite3 *db;
+    VtabEntry *entries;
+    int count;
+    int cap;
+};
+
+typedef struct {
+    sqlite3_vtab base;
+    const Table *table;
+} TableVtab;
+
+// Column equality pushed down by xBestIndex
+typedef struct {
+    int col;
+    sqlite3_value *value;
+} VtabCond;
+
+typedef struct {
+    sqlite3_vtab_cursor base;
+    int row;
+    int end;           // one past the last row the rowid bounds allow
+    VtabCond *conds;
+    int cond_count;
+} TableCursor;
+
+static VtabEntry *module_find(TableVtabModule *m, const char *name) {
+    for (int i = 0; i < m->count; ++i) {
+        if (sqlite3_stricmp(m->entries[i].name, name) == 0) return &m->entries[i];
+    }
+    return NULL;
+}
+
+static void module_free(void *aux) {
+    TableVtabModule *m = aux;
+    if (!m) return;
+    for (int i = 0; i < m->count; ++i) free(m->entries[i].name);
+    free(m->entries);
+    free(m);
+}
+
+static const char *decl_type(DataType t) {
+    switch (t) {
+        case TYPE_INT: return "INTEGER";
+        case TYPE_FLOAT: return "REAL";
+        case TYPE_BOOL: return "BOOLEAN";
+        default: return "TEXT";
+    }
+}
+
+// xCreate and xConnect: declares the attached Table's columns
+static int vtab_connect(sqlite3 *db, void *aux, int argc, const char *const *argv,
+                        sqlite3_vtab **out, char **pz_err) {
+    VtabEntry *e = argc > 2 ? module_find(aux, argv[2]) : NULL;
+    if (!e) {
+        *pz_err = sqlite3_mprintf("no table attached as %s", argc > 2 ? argv[2] : "?");
+        return SQLITE_ERROR;
+    }
+    const Table *t = e->table;
+    if (t->column_count <= 0) {
+        *pz_err = sqlite3_mprintf("table %s has no columns", argv[2]);
+        return SQLITE_ERROR;
+    }
+
+    sqlite3_str *ddl = sqlite3_str_new(db);
+    sqlite3_str_appendall(ddl, "CREATE TABLE x(");
+    for (int i = 0; i < t->column_count; ++i) {
+        sqlite3_str_appendf(ddl, "%s\"%w\" %s", i ? ", " : "",
+                            t->columns[i].name ? t->columns[i].name : "", decl_type(t->columns[i].type));
+    }
+    sqlite3_str_appendall(ddl, ")");
+    char *sql = sqlite3_str_finish(ddl);
+    if (!sql) return SQLITE_NOMEM;
+    int rc = sqlite3_declare_vtab(db, sql);
+    sqlite3_free(sql);
+    if (rc != SQLITE_OK) {
+        *pz_err = sqlite3_mprintf("%s", sqlite3_errmsg(db));
+        return rc;
+    }
+
+    TableVtab *v = sqlite3_malloc(sizeof(*v));
+    if (!v) return SQLITE_NOMEM;
+    memset(v, 0, sizeof(*v));
+    v->table = t;
+    *out = &v->base;
+    return SQLITE_OK;
+}
+
+static int vtab_disconnect(sqlite3_vtab *vt) {
+    sqlite3_free(vt);
+    return SQLITE_OK;
+}
+
+static char constraint_op(unsigned char op) {
+    switch (op) {
+        case SQLITE_INDEX_CONSTRAINT_EQ: return '=';
+        case SQLITE_INDEX_CONSTRAINT_GT: return '>';
+        case SQLITE_INDEX_CONSTRAINT_GE: return 'g';
+        case SQLITE_INDEX_CONSTRAINT_LT: return '<';
+        case SQLITE_INDEX_CONSTRAINT_LE: return 'l';
+        default: return 0;
+    }
+}
+
+// Takes rowid comparisons and column equality (text only under BINARY
+// collation). Each used constraint is one "<op><column>," entry of idxStr
+// (column -1 for rowid), in argv order. SQLite still checks every
+// constraint on the rows returned, so xFilter may let extra rows through.
+static int vtab_best_index(sqlite3_vtab *vt, sqlite3_index_info *info) {
+    const Table *t = ((TableVtab *)vt)->table;
+    double rows = t->row_count > 0 ? t->row_count : 1;
+    double cost = rows, est = rows;
+    int argv_index = 0, unique = 0;
+    size_t len = 0, cap = (size_t)info->nConstraint * 16 + 1;
+    char *plan = sqlite3_malloc64(cap);
+
+    if (!plan) return SQLITE_NOMEM;
+    plan[0] = '\0';
+    for (int i = 0; i < info->nConstraint; ++i) {
+        const struct sqlite3_index_constraint *c = &info->aConstraint[i];
+        char op = constraint_op(c->op);
+        if (!c->usable || !op) continue;
+        if (c->iColumn >= 0) {
+            if (op != '=' || c->iColumn >= t->column_count) continue;
+            if ((t->columns[c->iColumn].type == TYPE_STR || t->columns[c->iColumn].type == TYPE_UNKNOWN) &&
+                sqlite3_stricmp(sqlite3_vtab_collation(info, i), "BINARY") != 0) continue;
+            cost *= 0.5;
+            est /= 10;
+        } else if (op == '=') {
+            unique = 1;
+        } else {
+            cost /= 4;
+            est /= 4;
+        }
+        info->aConstraintUsage[i].argvIndex = ++argv_index;
+        len += (size_t)snprintf(plan + len, cap - len, "%c%d,", op, c->iColumn);
+    }
+    if (unique) {
+        cost = 1;
+        est = 1;
+        info->idxFlags |= SQLITE_INDEX_SCAN_UNIQUE;
+    }
+    if (info->nOrderBy == 1 && info->aOrderBy[0].iColumn < 0 && !info->aOrderBy[0].desc) info->orderByConsumed = 1;
+    info->idxStr = plan;
+    info->needToFreeIdxStr = 1;
+    info->estimatedCost = cost;
+    info->estimatedRows = est < 1 ? 1 : (sqlite3_int64)est;
+    return SQLITE_OK;
+}
+
+static int vtab_open(sqlite3_vtab *vt, sqlite3_vtab_cursor **out) {
+    TableCursor *c = sqlite3_malloc(sizeof(*c));
+    (void)vt;
+    if (!c) return SQLITE_NOMEM;
+    memset(c, 0, sizeof(*c));
+    *out = &c->base;
+    return SQLITE_OK;
+}
+
+static void cursor_clear_conds(TableCursor *c) {
+    for (int i = 0; i < c->cond_count; ++i) sqlite3_value_free(c->conds[i].value);
+    sqlite3_free(c->conds);
+    c->conds = NULL;
+    c->cond_count = 0;
+}
+
+static int vtab_close(sqlite3_vtab_cursor *cur) {
+    cursor_clear_conds((TableCursor *)cur);
+    sqlite3_free(cur);
+    return SQLITE_OK;
+}
+
+static const Table *cursor_table(const TableCursor *c) {
+    return ((const TableVtab *)c->base.pVtab)->table;
+}
+
+// Narrows [*lo, *hi] (rowids) by one comparison. Only numeric values
+// narrow; a fractional bound is widened to the enclosing integers.
+static void narrow_rowid(char op, sqlite3_value *v, long long *lo, long long *hi) {
+    long long n;
+
+    if (sqlite3_value_type(v) == SQLITE_INTEGER) {
+        n = sqlite3_value_int64(v);
+    } else if (sqlite3_value_type(v) == SQLITE_FLOAT) {
+        double d = sqlite3_value_double(v);
+        if (!(d > -9e18 && d < 9e18)) return;
+        n = (long long)d;
+        if ((double)n != d) {
+            if (op == '>' || op == 'g') { if ((double)n > d) n--; op = 'g'; }
+            else if (op == '<' || op == 'l') { if ((double)n < d) n++; op = 'l'; }
+            else return;
+        }
+    } else {
+        return;
+    }
+    switch (op) {
+        case '=': if (n > *lo) *lo = n; if (n < *hi) *hi = n; break;
+        case '>': if (n < LLONG_MAX && n + 1 > *lo) *lo = n + 1; if (n == LLONG_MAX) *hi = 0; break;
+        case 'g': if (n > *lo) *lo = n; break;
+        case '<': if (n > LLONG_MIN && n - 1 < *hi) *hi = n - 1; if (n == LLONG_MIN) *hi = 0; break;
+        case 'l': if (n < *hi) *hi = n; break;
+    }
+}
+
+// Whether cell (row, cond->col) may equal the pushed-down value; values
+// SQLite would convert first (text against a numeric column, ...) pass
+static int cell_may_match(const Table *t, int row, const VtabCond *cond) {
+    const void *v;
+    int vt = sqlite3_value_type(cond->value);
+
+    if (cond->col >= t->column_count) return 1;
+    if (vt == SQLITE_NULL) return 0; // = NULL is never true
+    v = t->rows[row].values ? t->rows[row].values[cond->col] : NULL;
+    switch (t->columns[cond->col].type) {
+        case TYPE_INT:
+        case TYPE_BOOL: {
+            if (vt != SQLITE_INTEGER && vt != SQLITE_FLOAT) return 1;
+            if (!v) return 0;
+            long long x = *(const int *)v;
+            if (t->columns[cond->col].type == TYPE_BOOL) x = x != 0;
+            if (vt == SQLITE_INTEGER) return x == sqlite3_value_int64(cond->value);
+            return (double)x == sqlite3_value_double(cond->value);
+        }
+        case TYPE_FLOAT:
+            if (vt != SQLITE_INTEGER && vt != SQLITE_FLOAT) return 1;
+            if (!v) return 0;
+            return (double)*(const float *)v == sqlite3_value_double(cond->value);
+        default:
+            if (vt != SQLITE_TEXT) return 1;
+            if (!v) return 0;
+            return strcmp((const char *)v, (const char *)sqlite3_value_text(cond->value)) == 0;
+    }
+}
+
+static int cursor_end(const TableCursor *c) {
+    int rows = cursor_table(c)->row_count;
+    return c->end < rows ? c->end : rows;
+}
+
+// Moves to the first row at or after row that the pushed-down
+// conditions let through
+static void cursor_seek(TableCursor *c, int row) {
+    const Table *t = cursor_table(c);
+    int end = cursor_end(c);
+
+    for (; row < end; ++row) {
+        int ok = 1;
+        for (int i = 0; i < c->cond_count && ok; ++i) ok = cell_may_match(t, row, &c->conds[i]);
+        if (ok) break;
+    }
+    c->row = row;
+}
+
+static int vtab_filter(sqlite3_vtab_cursor *cur, int idx_num, const char *idx_str, int argc, sqlite3_value **argv) {
+    TableCursor *c = (TableCursor *)cur;
+    const Table *t = cursor_table(c);
+    long long lo = 1, hi = t->row_count;
+    const char *p = idx_str ? idx_str : "";
+
+    (void)idx_num;
+    cursor_clear_conds(c);
+    if (argc > 0 && !(c->conds = sqlite3_malloc64((sqlite3_uint64)argc * sizeof(*c->conds)))) return SQLITE_NOMEM;
+    for (int i = 0; i < argc && *p; ++i) {
+        char op = *p++;
+        char *next;
+        int col = (int)strtol(p, &next, 10);
+        p = *next == ',' ? next + 1 : next;
+        if (col < 0) {
+            narrow_rowid(op, argv[i], &lo, &hi);
+            continue;
+        }
+        if (!(c->conds[c->cond_count].value = sqlite3_value_dup(argv[i]))) return SQLITE_NOMEM;
+        c->conds[c->cond_count++].col = col;
+    }
+    if (lo < 1) lo = 1;
+    if (hi > t->row_count) hi = t->row_count;
+    c->end = hi >= lo ? (int)hi : 0;
+    cursor_seek(c, hi >= lo ? (int)(lo - 1) : 0);
+    return SQLITE_OK;
+}
+
+static int vtab_next(sqlite3_vtab_cursor *cur) {
+    TableCursor *c = (TableCursor *)cur;
+    cursor_seek(c, c->row + 1);
+    return SQLITE_OK;
+}
+
+static int vtab_eof(sqlite3_vtab_cursor *cur) {
+    const TableCursor *c = (const TableCursor *)cur;
+    return c->row >= cursor_end(c);
+}
+
+static int vtab_column(sqlite3_vtab_cursor *cur, sqlite3_context *ctx, int col) {
+    const TableCursor *c = (const TableCursor *)cur;
+    const Table *t = cursor_table(c);
+    const void *v = NULL;
+
+    if (c->row < t->row_count && col < t->column_count && t->rows[c->row].values) v = t->rows[c->row].values[col];
+    if (!v) {
+        sqlite3_result_null(ctx);
+        return SQLITE_OK;
+    }
+    switch (t->columns[col].type) {
+        case TYPE_INT: sqlite3_result_int(ctx, *(const int *)v); break;
+        case TYPE_FLOAT: sqlite3_result_double(ctx, *(const float *)v); break;
+        case TYPE_BOOL: sqlite3_result_int(ctx, *(const int *)v != 0); break;
+        // The cell itself: the Table does not change while a statement runs
+        default: sqlite3_result_text(ctx, (const char *)v, -1, SQLITE_STATIC); break;
+    }
+    return SQLITE_OK;
+}
+
+static int vtab_rowid(sqlite3_vtab_cursor *cur, sqlite3_int64 *rowid) {
+    *rowid = ((const TableCursor *)cur)->row + 1;
+    return SQLITE_OK;
+}
+
+static sqlite3_module table_module = {
+    .iVersion = 0,
+    .xCreate = vtab_connect,
+    .xConnect = vtab_connect,
+    .xBestIndex = vtab_best_index,
+    .xDisconnect = vtab_disconnect,
+    .xDestroy = vtab_disconnect,
+    .xOpen = vtab_open,
+    .xClose = vtab_close,
+    .xFilter = vtab_filter,
+    .xNext = vtab_next,
+    .xEof = vtab_eof,
+    .xColumn = vtab_column,
+    .xRowid = vtab_rowid,
+};
+
+TableVtabModule *table_vtab_register(sqlite3 *db, char *err, size_t err_sz) {
+    TableVtabModule *m;
+
+    if (!db) { set_err(err, err_sz, "Not connected"); return NULL; }
+    if (!(m = calloc(1, sizeof(*m)))) { set_err(err, err_sz, "Out of memory"); return NULL; }
+    m->db = db;
+    // On failure SQLite calls module_free itself
+    if (sqlite3_create_module_v2(db, TABLE_VTAB_MODULE, &table_module, m, module_free) != SQLITE_OK) {
+        set_err(err, err_sz, sqlite3_errmsg(db));
+        return NULL;
+    }
+    return m;
+}
+
+int table_vtab_attach(TableVtabModule *m, const char *name, const Table *table, char *err, size_t err_sz) {
+    if (!m || !name || !*name || !table) { set_err(err, err_sz, "Invalid args"); return -1; }
+    if (module_find(m, name)) { set_err(err, err_sz, "Table name already attached"); return -1; }
+    if (m->count == m->cap) {
+        int cap = m->cap ? m->cap * 2 : 8;
+        VtabEntry *entries = realloc(m->entries, (size_t)cap * sizeof(*entries));
+        if (!entries) { set_err(err, err_sz, "Out of memory"); return -1; }
+        m->entries = entries;
+        m->cap = cap;
+    }
+    if (!(m->entries[m->count].name = strdup(name))) { set_err(err, err_sz, "Out of memory"); return -1; }
+    m->entries[m->count++].table = table;
+
+    char *sql = sqlite3_mprintf("CREATE VIRTUAL TABLE temp.\"%w\" USING " TABLE_VTAB_MODULE, name);
+    char *errmsg = NULL;
+    int rc = sql ? sqlite3_exec(m->db, sql, NULL, NULL, &errmsg) : SQLITE_NOMEM;
+    sqlite3_free(sql);
+    if (rc != SQLITE_OK) {
+        set_err(err, err_sz, errmsg ? errmsg : "CREATE VIRTUAL TABLE failed");
+        sqlite3_free(errmsg);
+        free(m->entries[--m->count].name);
+        return -1;
+    }
+    return 0;
+}
+
+int table_vtab_detach(TableVtabModule *m, const char *name, char *err, size_t err_sz) {
+    VtabEntry *e = m && name ? module_find(m, name) : NULL;
+    if (!e) { set_err(err, err_sz, "Table not attached"); return -1; }
+
+    char *sql = sqlite3_mprintf("DROP TABLE temp.\"%w\"", name);
+    char *errmsg = NULL;
+    int rc = sql ? sqlite3_exec(m->db, sql, NULL, NULL, &errmsg) : SQLITE_NOMEM;
+    sqlite3_free(sql);
+    if (rc != SQLITE_OK) {
+        set_err(err, err_sz, errmsg ? errmsg : "DROP TABLE failed");
+        sqlite3_free(errmsg);
+        return -1;
+    }
+    free(e->name);
+    *e = m->entries[--m->count];
+    return 0;
+}
+
+// Declared type of a result column when it is one of ours, else from the
+// first row's value (integers beyond 32 bits stay text); collect_rows turns
+// the column into text when a later value does not fit
+static DataType result_type(sqlite3_stmt *st, int col, int have_row) {
+    const char *decl = sqlite3_column_decltype(st, col);
+    if (decl) {
+        if (sqlite3_stricmp(decl, "INTEGER") == 0) return TYPE_INT;
+        if (sqlite3_stricmp(decl, "REAL") == 0) return TYPE_FLOAT;
+        if (sqlite3_stricmp(decl, "BOOLEAN") == 0) return TYPE_BOOL;
+        return TYPE_STR;
+    }
+    if (!have_row) return TYPE_STR;
+    switch (sqlite3_column_type(st, col)) {
+        case SQLITE_INTEGER: {
+            sqlite3_int64 v = sqlite3_column_int64(st, col);
+            return (v >= INT_MIN && v <= INT_MAX) ? TYPE_INT : TYPE_STR;
+        }
+        case SQLITE_FLOAT: return TYPE_FLOAT;
+        default: return TYPE_STR;
+    }
+}
+
+// Whether the current row's value of col can be stored as type
+static int value_fits(sqlite3_stmt *st, int col, DataType type) {
+    if (type == TYPE_STR) return 1;
+    switch (sqlite3_column_type(st, col)) {
+        case SQLITE_NULL: return 1;
+        case SQLITE_INTEGER: {
+            sqlite3_int64 v = sqlite3_column_int64(st, col);
+            if (type == TYPE_BOOL) return v == 0 || v == 1;
+            return type == TYPE_FLOAT || (v >= INT_MIN && v <= INT_MAX);
+        }
+        case SQLITE_FLOAT: return type == TYPE_FLOAT;
+        default: return 0;
+    }
+}
+
+// Steps st to the end into a new Table; cells go through add_row as text,
+// as in db_load_table
+static Table *collect_rows(sqlite3_stmt *st, const char *name, char *err, size_t err_sz) {
+    int cols = sqlite3_column_count(st);
+    int rc = sqlite3_step(st);
+    Table *t;
+    const char **vals;
+
+    if (cols <= 0) { set_err(err, err_sz, "Query returns no columns"); return NULL; }
+    if (rc != SQLITE_ROW && rc != SQLITE_DONE) { set_err(err, err_sz, sqlite3_errmsg(sqlite3_db_handle(st))); return NULL; }
+    if (!(t = create_table(name)) || !(vals = malloc((size_t)cols * sizeof(*vals)))) {
+        free_table(t);
+        set_err(err, err_sz, "Out of memory");
+        return NULL;
+    }
+    for (int c = 0; c < cols; ++c) {
+        const char *col_name = sqlite3_column_name(st, c);
+        add_column(t, col_name ? col_name : "", result_type(st, c, rc == SQLITE_ROW));
+    }
+    for (; rc == SQLITE_ROW; rc = sqlite3_step(st)) {
+        if (t->row_count == INT_MAX) { rc = SQLITE_FULL; break; }
+        for (int c = 0; c < cols && rc == SQLITE_ROW; ++c) {
+            // An untyped expression (IFNULL(real, 0), CASE ...) can change
+            // storage class between rows: keep what came so far as text
+            if (!value_fits(st, c, t->columns[c].type) &&
+                tableop_change_column_type(t, c, TYPE_STR, err, err_sz) != 0) {
+                rc = SQLITE_NOMEM;
+            }
+        }
+        if (rc != SQLITE_ROW) break;
+        for (int c = 0; c < cols; ++c) {
+            const char *txt = (const char *)sqlite3_column_text(st, c);
+            if (t->columns[c].type == TYPE_BOOL && txt) txt = sqlite3_column_int64(st, c) ? "true" : "false";
+            vals[c] = txt ? txt : "";
+        }
+        add_row(t, vals);
+    }
+    free(vals);
+    if (rc == SQLITE_NOMEM) {
+        free_table(t);
+        return NULL;
+    }
+    if (rc != SQLITE_DONE) {
+        set_err(err, err_sz, rc == SQLITE_FULL ? "Too many result rows" : sqlite3_errmsg(sqlite3_db_handle(st)));
+        free_table(t);
+        return NULL;
+    }
+    return t;
+}
+
+Table *table_sql_query(const char *sql, const Table *const *tables, int count, const char *result_name,
+                       char *err, size_t err_sz) {
+    sqlite3 *db = NULL;
+    sqlite3_stmt *st = NULL;
+    TableVtabModule *m;
+    const char *tail = NULL;
+    Table *out = NULL;
+
+    if (!sql || !*sql) { set_err(err, err_sz, "Empty query"); return NULL; }
+    if (sqlite3_open(":memory:", &db) != SQLITE_OK) {
+        set_err(err, err_sz, db ? sqlite3_errmsg(db) : "Failed to open database");
+        sqlite3_close(db);
+        return NULL;
+    }
+    if (!(m = table_vtab_register(db, err, err_sz))) goto done;
+    for (int i = 0; i < count; ++i) {
+        const Table *t = tables[i];
+        if (!t || !t->name || !*t->name || t->column_count <= 0 || module_find(m, t->name)) continue;
+        if (table_vtab_attach(m, t->name, t, err, err_sz) != 0) goto done;
+    }
+
+    if (sqlite3_prepare_v2(db, sql, -1, &st, &tail) != SQLITE_OK) {
+        set_err(err, err_sz, sqlite3_errmsg(db));
+        goto done;
+    }
+    while (tail && (isspace((unsigned char)*tail) || *tail == ';')) tail++;
+    if (!st) {
+        set_err(err, err_sz, "Empty query");
+    } else if (tail && *tail) {
+        set_err(err, err_sz, "Run one statement at a time");
+    } else if (!sqlite3_stmt_readonly(st)) {
+        set_err(err, err_sz, "Only read-only queries (SELECT) are supported");
+    } else {
+        out = collect_rows(st, result_name ? result_name : "Query Result", err, err_sz);
+    }
+
+done:
+    sqlite3_finalize(st);
+    sqlite3_close(db);
+    return out;
+}
@@ -1,5 +1,6 @@
 #include "csv.h"
 #include "settings.h"
+#include "seekdb.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -338,6 +339,184 @@ Table *csv_load_with_progress(const char *path,
     return t;
 }
 
+// Rows read before the column types are fixed when streaming
+#define CSV_STREAM_SAMPLE_ROWS 1000
+
+static void free_cells(char **cells, int count) {
+    for (int i = 0; i < count; ++i) free(cells[i]);
+    free(cells);
+}
+
+static const char *sql_type_name(DataType type) {
+    switch (type) {
+        case TYPE_INT: return "INTEGER";
+        case TYPE_FLOAT: return "REAL";
+        case TYPE_BOOL: return "BOOLEAN";
+        default: return "TEXT";
+    }
+}
+
+// Appends one parsed line; cells beyond the header are dropped, missing
+// ones are NULL, and so are empty cells of typed columns
+static int ingest_cells(seekdb *s, char **cells, int count, const DataType *types, int cols,
+                        const char **values, char *err, size_t err_sz) {
+    for (int c = 0; c < cols; ++c) {
+        const char *v = (c < count) ? cells[c] : NULL;
+        if (v && types[c] != TYPE_STR && v[0] == '\0') v = NULL;
+        if (v && types[c] == TYPE_BOOL) v = seekdb_bool_value(v);
+        values[c] = v;
+    }
+    return seekdb_ingest_append_row(s, values, err, err_sz);
+}
+
+long long csv_stream_to_seekdb(const char *path,
+                               bool infer_types,
+                               seekdb *s,
+                               const char *table,
+                               const char *key,
+                               char *err,
+                               size_t err_sz,
+                               const ProgressReporter *progress) {
+    char *line = NULL;
+    size_t line_cap = 0;
+    int header_count = 0;
+    char **header_cells = NULL;
+    char **col_names = NULL;
+    DataType *col_types = NULL;
+    const char **values = NULL;
+    char ***sample = NULL;
+    int *sample_counts = NULL;
+    int sample_rows = 0;
+    long long loaded = -1;
+    long total_bytes = 0;
+    int ingesting = 0;
+
+    if (err && err_sz) err[0] = '\0';
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        if (err) snprintf(err, err_sz, "Failed to open %s", path);
+        return -1;
+    }
+    if (fseek(f, 0, SEEK_END) == 0) {
+        total_bytes = ftell(f);
+        if (total_bytes < 0) total_bytes = 0;
+        fseek(f, 0, SEEK_SET);
+    }
+
+    report_progress(progress, 0.0, "Reading header...");
+    if (getline(&line, &line_cap, f) < 0) {
+        if (err) snprintf(err, err_sz, "Empty file or read error");
+        goto done;
+    }
+    header_cells = split_csv_line(line, &header_count);
+    if (header_count <= 0) {
+        if (err) snprintf(err, err_sz, "No headers found");
+        goto done;
+    }
+    col_names = (char**)calloc((size_t)header_count, sizeof(char*));
+    col_types = (DataType*)malloc(sizeof(DataType) * (size_t)header_count);
+    values = (const char**)malloc(sizeof(char*) * (size_t)header_count);
+    sample = (char***)malloc(sizeof(char**) * CSV_STREAM_SAMPLE_ROWS);
+    sample_counts = (int*)malloc(sizeof(int) * CSV_STREAM_SAMPLE_ROWS);
+    if (!col_names || !col_types || !values || !sample || !sample_counts) {
+        if (err) snprintf(err, err_sz, "Out of memory");
+        goto done;
+    }
+    for (int c = 0; c < header_count; ++c) parse_header(header_cells[c], &col_names[c], &col_types[c]);
+
+    // Types come from the first rows; values that do not fit later are
+    // stored as they are and the seek view shows such columns as text
+    while (sample_rows < CSV_STREAM_SAMPLE_ROWS && getline(&line, &line_cap, f) >= 0) {
+        sample[sample_rows] = split_csv_line(line, &sample_counts[sample_rows]);
+        sample_rows++;
+    }
+    for (int c = 0; c < header_count; ++c) {
+        if (col_types[c] != TYPE_UNKNOWN) continue;
+        if (!infer_types) { col_types[c] = TYPE_STR; continue; }
+        char **cells = (char**)malloc(sizeof(char*) * (size_t)(sample_rows > 0 ? sample_rows : 1));
+        if (!cells) {
+            if (err) snprintf(err, err_sz, "Out of memory");
+            goto done;
+        }
+        for (int r = 0; r < sample_rows; ++r) cells[r] = (c < sample_counts[r]) ? sample[r][c] : NULL;
+        col_types[c] = sample_rows > 0 ? infer_type_for_column(cells, sample_rows) : TYPE_STR;
+        free(cells);
+    }
+
+    for (int c = 0; c < header_count; ++c) values[c] = sql_type_name(col_types[c]);
+    if (seekdb_ensure_table_columns(s, table, (const char *const *)col_names, values, header_count, err, err_sz) != 0 ||
+        seekdb_ingest_begin(s, table, (const char *const *)col_names, header_count, key, err, err_sz) != 0) {
+        goto done;
+    }
+    ingesting = 1;
+    for (int r = 0; r < sample_rows; ++r) {
+        if (ingest_cells(s, sample[r], sample_counts[r], col_types, header_count, values, err, err_sz) != 0) goto done;
+    }
+    long long rows = sample_rows;
+    while (getline(&line, &line_cap, f) >= 0) {
+        int count = 0;
+        char **cells = split_csv_line(line, &count);
+        int rc = ingest_cells(s, cells, count, col_types, header_count, values, err, err_sz);
+        free_cells(cells, count);
+        if (rc != 0) goto done;
+        if ((++rows & 4095) == 0 && total_bytes > 0) {
+            long pos = ftell(f);
+            report_progress(progress, 0.95 * (double)(pos > 0 ? pos : 0) / (double)total_bytes, "Streaming rows...");
+        }
+    }
+    report_progress(progress, 0.95, "Indexing...");
+    ingesting = 0;
+    loaded = seekdb_ingest_commit(s, err, err_sz);
+    if (loaded >= 0) report_progress(progress, 1.0, "Done");
+
+done:
+    if (ingesting) seekdb_ingest_abort(s);
+    fclose(f);
+    free(line);
+    if (header_cells) free_cells(header_cells, header_count);
+    if (col_names) free_cells(col_names, header_count);
+    for (int r = 0; r < sample_rows; ++r) free_cells(sample[r], sample_counts[r]);
+    free(sample);
+    free(sample_counts);
+    free(values);
+    free(col_types);
+    return loaded;
+}
+
+// Bytes per cell allocation beyond its text (malloc header and rounding)
+#define CSV_CELL_OVERHEAD 32
+
+unsigned long long csv_estimate_load_bytes(const char *path) {
+    FILE *f = fopen(path, "r");
+    char *line = NULL;
+    size_t line_cap = 0;
+    unsigned long long sampled_bytes = 0, sampled_cells = 0, lines = 0;
+    long total_bytes = 0;
+    ssize_t len;
+
+    if (!f) return 0;
+    if (fseek(f, 0, SEEK_END) == 0) total_bytes = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    while (lines < CSV_STREAM_SAMPLE_ROWS && (len = getline(&line, &line_cap, f)) >= 0) {
+        int count = 0;
+        char **cells = split_csv_line(line, &count);
+        free_cells(cells, count);
+        sampled_bytes += (unsigned long long)len;
+        sampled_cells += (unsigned long long)count;
+        lines++;
+    }
+    free(line);
+    fclose(f);
+    if (lines == 0 || sampled_bytes == 0 || total_bytes <= 0) return 0;
+
+    // csv_load keeps every row as strings while it builds the Table, so the
+    // peak is about twice the Table itself
+    unsigned long long rows = (unsigned long long)total_bytes * lines / sampled_bytes;
+    unsigned long long per_row = sizeof(Row) + (sampled_bytes +
+                                 sampled_cells * (sizeof(void*) + CSV_CELL_OVERHEAD)) / lines;
+    return 2 * rows * per_row;
+}
+
 Table *csv_load(const char *path, bool infer_types, char *err, size_t err_sz)
 {
     return csv_load_with_progress(path, infer_types, err, err_sz, NULL);
@@ -371,3 +550,100 @@ int csv_save(const Table *table, const char *path, char *err, size_t err_sz) {
     fclose(f);
     return 0;
 }
+
+// Rows between progress reports of a seek-view export
+#define CSV_EXPORT_REPORT_ROWS 4096
+
+typedef struct {
+    FILE *f;
+    int cols;
+    int key_col;          // left out of the file
+    unsigned char *is_bool;
+    long long rows;
+    long long total;      // <0 when unknown
+    const ProgressReporter *progress;
+} CsvExport;
+
+// Quotes fields that would otherwise split or end the record
+static void put_field(FILE *f, const char *text) {
+    if (!strpbrk(text, ",\"\r\n")) { fputs(text, f); return; }
+    fputc('"', f);
+    for (const char *p = text; *p; ++p) {
+        if (*p == '"') fputc('"', f);
+        fputc(*p, f);
+    }
+    fputc('"', f);
+}
+
+static bool export_row(void *user, sqlite3_stmt *row) {
+    CsvExport *x = (CsvExport*)user;
+    int first = 1;
+
+    for (int j = 0; j < x->cols; ++j) {
+        if (j == x->key_col) continue;
+        if (!first) fputc(',', x->f);
+        first = 0;
+        if (sqlite3_column_type(row, j) == SQLITE_NULL) continue;
+        // Only 0/1 stored as integers are booleans; other values keep their text
+        if (x->is_bool[j] && sqlite3_column_type(row, j) == SQLITE_INTEGER) {
+            fputs(sqlite3_column_int(row, j) ? "true" : "false", x->f);
+        } else put_field(x->f, (const char*)sqlite3_column_text(row, j));
+    }
+    fputc('\n', x->f);
+    if (ferror(x->f)) return false;
+    if (++x->rows % CSV_EXPORT_REPORT_ROWS == 0 && x->progress) {
+        char msg[96];
+        if (x->total > 0) snprintf(msg, sizeof(msg), "Exported %lld of %lld rows...", x->rows, x->total);
+        else snprintf(msg, sizeof(msg), "Exported %lld rows...", x->rows);
+        report_progress(x->progress, x->total > 0 ? (double)x->rows / (double)x->total : 0.0, msg);
+    }
+    return true;
+}
+
+long long csv_export_seekdb(seekdb *s, const char *path, char *err, size_t err_sz,
+                            const ProgressReporter *progress) {
+    CsvExport x = {0};
+    char **names = NULL;
+    char **decls = NULL;
+    long long rows = -1;
+
+    if (err && err_sz) err[0] = '\0';
+    if (!s || !path) { if (err) snprintf(err, err_sz, "Invalid args"); return -1; }
+    x.cols = seekdb_get_view_columns(s, &names, err, err_sz);
+    if (x.cols <= 0) return -1;
+    if (seekdb_get_view_column_types(s, &decls, err, err_sz) != x.cols) goto done;
+    x.is_bool = (unsigned char*)calloc((size_t)x.cols, 1);
+    if (!x.is_bool) { if (err) snprintf(err, err_sz, "Out of memory"); goto done; }
+    for (int j = 0; j < x.cols; ++j) x.is_bool[j] = (unsigned char)seekdb_decl_is_bool(decls[j]);
+    x.key_col = seekdb_view_key_column(s, NULL, 0);
+    x.total = seekdb_count_estimate(s, NULL);
+    x.progress = progress;
+
+    x.f = fopen(path, "w");
+    if (!x.f) { if (err) snprintf(err, err_sz, "Failed to open for write: %s", path); goto done; }
+    report_progress(progress, 0.0, "Exporting rows...");
+    // Plain header names, as csv_save writes them
+    int first = 1;
+    for (int j = 0; j < x.cols; ++j) {
+        if (j == x.key_col) continue;
+        if (!first) fputc(',', x.f);
+        first = 0;
+        put_field(x.f, names[j]);
+    }
+    fputc('\n', x.f);
+
+    rows = seekdb_scan(s, export_row, &x, err, err_sz);
+    if (fclose(x.f) != 0 || (rows >= 0 && rows != x.rows)) {
+        if (err && (rows >= 0 || !err[0])) snprintf(err, err_sz, "Failed to write %s", path);
+        rows = -1;
+    }
+    x.f = NULL;
+    if (rows >= 0) report_progress(progress, 1.0, "Done");
+
+done:
+    if (x.f) fclose(x.f);
+    free(x.is_bool);
+    if (names) free_cells(names, x.cols);
+    if (decls) free_cells(decls, x.cols);
+    return rows;
+}
@@ -1,4 +1,5 @@
 #include "xl.h"
+#include "seekdb.h"
 
 #include <ctype.h>
 #include <stdbool.h>
@@ -17,6 +18,9 @@
 
 #define MAX_SHEET_NAME_LEN 31
 
+#define XL_STREAM_CHUNK       65536
+#define XL_STREAM_SAMPLE_ROWS 1000
+
 typedef struct {
     char **items;
     size_t count;
@@ -54,6 +58,30 @@ struct zip_source {
     uint32_t offset;
 };
 
+/* One archive member read sequentially (stored or deflated). */
+typedef struct {
+    FILE *fp;
+    int method;
+    int inflating;
+    int finished;
+    uint32_t remaining;  /* compressed bytes not read yet */
+    uint32_t total;
+    uint32_t uncompressed;
+    z_stream zs;
+    unsigned char in[XL_STREAM_CHUNK];
+} zip_member_stream;
+
+/* Rows of a worksheet, parsed as they are inflated. buf holds at most the
+   row being read plus one chunk. */
+typedef struct {
+    zip_member_stream zip;
+    char *buf;
+    size_t len;
+    size_t cap;
+    size_t pos;
+    int eof;
+} sheet_stream;
+
 struct string_builder {
     char *data;
     size_t length;
@@ -81,6 +109,17 @@ static int zip_extract_file(const char *archive_path,
                             unsigned char **out_data,
                             size_t *out_size);
 
+static int zip_stream_open(const char *archive_path, const char *file_name, zip_member_stream *zs);
+static long zip_stream_read(zip_member_stream *zs, unsigned char *out, size_t cap);
+static double zip_stream_fraction(const zip_member_stream *zs);
+static void zip_stream_close(zip_member_stream *zs);
+
+static int sheet_stream_next_row(sheet_stream *ss, const string_list *shared, cell_array *cells);
+
+static void put_le32(unsigned char *buf, uint32_t value);
+static void zip_put_local_header(FILE *fp, const struct zip_source *src, uint32_t dos_time, uint32_t dos_date);
+static void zip_put_directory(FILE *fp, const struct zip_source *sources, size_t source_count,
+                              uint32_t dos_time, uint32_t dos_date);
 static int zip_write_files(const char *archive_path,
                            struct zip_source *sources,
                            size_t source_count);
@@ -97,6 +136,10 @@ static size_t parse_column_from_ref(const char *ref);
 static size_t parse_row_index(const char *row_start, size_t *fallback_counter);
 
 static void parse_shared_strings(const char *xml, string_list *strings);
+static void parse_row_cells(const char *row_start,
+                            const char *row_end,
+                            const string_list *shared,
+                            cell_array *cells);
 static int parse_sheet_collect(const char *xml,
                                const string_list *shared,
                                parsed_sheet *sheet);
@@ -333,6 +376,225 @@ Table *xl_load(const char *path, bool infer_types, char *err, size_t err_sz)
     return xl_load_with_progress(path, infer_types, err, err_sz, NULL);
 }
 
+unsigned long long xl_estimate_load_bytes(const char *path)
+{
+    const char *members[] = {"xl/worksheets/sheet1.xml", "xl/sharedStrings.xml"};
+    unsigned long long xml_bytes = 0;
+
+    for (size_t i = 0; i < sizeof(members) / sizeof(members[0]); ++i) {
+        zip_member_stream zs;
+        if (zip_stream_open(path, members[i], &zs) == 0) {
+            xml_bytes += zs.uncompressed;
+            zip_stream_close(&zs);
+        }
+    }
+    /* xl_load holds the inflated XML, the parsed cells and the Table at
+       once; with a small allocation per cell in both, that peaks at about
+       four times the XML. */
+    return 4 * xml_bytes;
+}
+
+static const char *sql_type_name(DataType type)
+{
+    switch (type) {
+        case TYPE_INT: return "INTEGER";
+        case TYPE_FLOAT: return "REAL";
+        case TYPE_BOOL: return "BOOLEAN";
+        default: return "TEXT";
+    }
+}
+
+/* Appends one sheet row; cells past the header are dropped, missing ones
+   are NULL, and so are empty cells of typed columns. */
+static int ingest_row(seekdb *s,
+                      const cell_array *cells,
+                      const DataType *types,
+                      size_t cols,
+                      const char **values,
+                      char *err,
+                      size_t err_sz)
+{
+    for (size_t c = 0; c < cols; ++c) {
+        values[c] = NULL;
+    }
+    for (size_t i = 0; i < cells->count; ++i) {
+        size_t c = cells->items[i].column_index;
+        const char *v = cells->items[i].value;
+        if (c >= cols) {
+            continue;
+        }
+        if (types[c] != TYPE_STR && v[0] == '\0') {
+            v = NULL;
+        } else if (types[c] == TYPE_BOOL) {
+            v = seekdb_bool_value(v);
+        }
+        values[c] = v;
+    }
+    return seekdb_ingest_append_row(s, values, err, err_sz);
+}
+
+long long xl_stream_to_seekdb(const char *path,
+                              bool infer_types,
+                              seekdb *s,
+                              const char *table,
+                              const char *key,
+                              char *err,
+                              size_t err_sz,
+                              const ProgressReporter *progress)
+{
+    sheet_stream ss;
+    string_list shared_strings;
+    parsed_sheet sample;
+    cell_array cells;
+    unsigned char *shared_data = NULL;
+    size_t shared_size = 0;
+    size_t header_count = 0;
+    char **col_names = NULL;
+    DataType *col_types = NULL;
+    const char **values = NULL;
+    long long loaded = -1;
+    long long rows = 0;
+    int ingesting = 0;
+    int rc;
+
+    if (err && err_sz) {
+        err[0] = '\0';
+    }
+    memset(&ss, 0, sizeof(ss));
+    string_list_init(&shared_strings);
+    parsed_sheet_init(&sample);
+    cell_array_init(&cells);
+    if (!path || !s || !table) {
+        if (err) snprintf(err, err_sz, "Invalid arguments");
+        return -1;
+    }
+
+    /* Shared strings are looked up by index from any row, so they are
+       still read whole; only the worksheet is streamed. */
+    report_progress(progress, 0.0, "Reading shared strings...");
+    if (zip_extract_file(path, "xl/sharedStrings.xml", &shared_data, &shared_size) == 0) {
+        parse_shared_strings((const char *)shared_data, &shared_strings);
+        free(shared_data);
+    }
+    if (zip_stream_open(path, "xl/worksheets/sheet1.xml", &ss.zip) != 0) {
+        if (err) snprintf(err, err_sz, "Sheet1 not found in %s", path);
+        goto done;
+    }
+
+    report_progress(progress, 0.05, "Reading header...");
+    while (sample.count < XL_STREAM_SAMPLE_ROWS + 1 &&
+           (rc = sheet_stream_next_row(&ss, &shared_strings, &cells)) > 0) {
+        size_t max_col = cells.items[cells.count - 1].column_index + 1;
+        if (parsed_sheet_push(&sample, &cells, max_col) != 0) {
+            if (err) snprintf(err, err_sz, "Out of memory");
+            goto done;
+        }
+    }
+    if (ss.eof < 0) {
+        if (err) snprintf(err, err_sz, "Failed to parse worksheet");
+        goto done;
+    }
+    if (sample.count == 0 || sample.max_cols == 0) {
+        if (err) snprintf(err, err_sz, "Worksheet is empty");
+        goto done;
+    }
+
+    /* Columns come from the header and the sampled rows; cells further
+       right in later rows are not loaded. */
+    header_count = sample.max_cols;
+    col_names = (char **)calloc(header_count, sizeof(char *));
+    col_types = (DataType *)malloc(sizeof(DataType) * header_count);
+    values = (const char **)malloc(sizeof(char *) * header_count);
+    if (!col_names || !col_types || !values) {
+        if (err) snprintf(err, err_sz, "Out of memory");
+        goto done;
+    }
+    for (size_t c = 0; c < header_count; ++c) {
+        const char *cell = cell_value_at(&sample.rows[0].cells, c);
+        parse_header(cell ? cell : "", &col_names[c], &col_types[c]);
+        if (!col_names[c] || col_names[c][0] == '\0') {
+            free(col_names[c]);
+            char buf[32];
+            snprintf(buf, sizeof(buf), "Column%zu", c + 1);
+            col_names[c] = strdup(buf);
+        }
+        if (col_types[c] != TYPE_UNKNOWN) {
+            continue;
+        }
+        if (!infer_types || sample.count < 2) {
+            col_types[c] = TYPE_STR;
+            continue;
+        }
+        char **column_cells = (char **)malloc(sizeof(char *) * (sample.count - 1));
+        if (!column_cells) {
+            if (err) snprintf(err, err_sz, "Out of memory");
+            goto done;
+        }
+        for (size_t r = 1; r < sample.count; ++r) {
+            const char *cell = cell_value_at(&sample.rows[r].cells, c);
+            column_cells[r - 1] = (cell && cell[0]) ? (char *)cell : "";
+        }
+        col_types[c] = infer_type_for_column(column_cells, (int)(sample.count - 1));
+        free(column_cells);
+    }
+
+    for (size_t c = 0; c < header_count; ++c) {
+        values[c] = sql_type_name(col_types[c]);
+    }
+    if (seekdb_ensure_table_columns(s, table, (const char *const *)col_names, values, (int)header_count,
+                                    err, err_sz) != 0 ||
+        seekdb_ingest_begin(s, table, (const char *const *)col_names, (int)header_count, key, err, err_sz) != 0) {
+        goto done;
+    }
+    ingesting = 1;
+    for (size_t r = 1; r < sample.count; ++r) {
+        if (ingest_row(s, &sample.rows[r].cells, col_types, header_count, values, err, err_sz) != 0) {
+            goto done;
+        }
+        rows++;
+    }
+    parsed_sheet_free(&sample);
+
+    while ((rc = sheet_stream_next_row(&ss, &shared_strings, &cells)) > 0) {
+        rc = ingest_row(s, &cells, col_types, header_count, values, err, err_sz);
+        cell_array_free(&cells);
+        if (rc != 0) {
+            goto done;
+        }
+        if ((++rows & 4095) == 0) {
+            report_progress(progress, 0.05 + 0.9 * zip_stream_fraction(&ss.zip), "Streaming rows...");
+        }
+    }
+    if (rc < 0) {
+        if (err) snprintf(err, err_sz, "Failed to parse worksheet");
+        goto done;
+    }
+
+    report_progress(progress, 0.95, "Indexing...");
+    ingesting = 0;
+    loaded = seekdb_ingest_commit(s, err, err_sz);
+    if (loaded >= 0) {
+        report_progress(progress, 1.0, "Done");
+    }
+
+done:
+    if (ingesting) {
+        seekdb_ingest_abort(s);
+    }
+    zip_stream_close(&ss.zip);
+    free(ss.buf);
+    cell_array_free(&cells);
+    parsed_sheet_free(&sample);
+    string_list_free(&shared_strings);
+    if (col_names) {
+        for (size_t c = 0; c < header_count; ++c) free(col_names[c]);
+    }
+    free(col_names);
+    free(col_types);
+    free(values);
+    return loaded;
+}
+
 static void report_progress(const ProgressReporter *progress,
                             double amount,
                             const char *message)
@@ -712,6 +974,464 @@ static int zip_extract_file(const char *archive_path,
     return found;
 }
 
+static int zip_stream_open(const char *archive_path, const char *file_name, zip_member_stream *zs)
+{
+    memset(zs, 0, sizeof(*zs));
+    zs->fp = fopen(archive_path, "rb");
+    if (!zs->fp) {
+        return -1;
+    }
+
+    for (;;) {
+        unsigned char header[30];
+        if (fread(header, 1, sizeof(header), zs->fp) != sizeof(header) ||
+            read_le32(header) != ZIP_SIG_LOCAL) {
+            break;
+        }
+
+        uint16_t flags = read_le16(header + 6);
+        uint16_t compression = read_le16(header + 8);
+        uint32_t compressed_size = read_le32(header + 18);
+        uint16_t fname_len = read_le16(header + 26);
+        uint16_t extra_len = read_le16(header + 28);
+        char name[512];
+
+        if ((flags & 0x0008u) != 0) {
+            break;
+        }
+        if (fname_len >= sizeof(name) || fread(name, 1, fname_len, zs->fp) != fname_len) {
+            break;
+        }
+        name[fname_len] = '\0';
+        if (fseek(zs->fp, extra_len, SEEK_CUR) != 0) {
+            break;
+        }
+
+        if (strcmp(name, file_name) == 0 && (compression == 0 || compression == 8)) {
+            zs->method = compression;
+            zs->remaining = compressed_size;
+            zs->total = compressed_size;
+            zs->uncompressed = read_le32(header + 22);
+            if (compression == 8) {
+                if (inflateInit2(&zs->zs, -MAX_WBITS) != Z_OK) {
+                    break;
+                }
+                zs->inflating = 1;
+            }
+            return 0;
+        }
+        /* Skip other members without reading them. */
+        if (fseek(zs->fp, (long)compressed_size, SEEK_CUR) != 0) {
+            break;
+        }
+    }
+
+    fclose(zs->fp);
+    zs->fp = NULL;
+    return -1;
+}
+
+/* Bytes of the member's content, 0 at its end, -1 on a broken archive. */
+static long zip_stream_read(zip_member_stream *zs, unsigned char *out, size_t cap)
+{
+    if (!zs->fp || zs->finished) {
+        return 0;
+    }
+    if (zs->method == 0) {
+        size_t want = (cap < zs->remaining) ? cap : zs->remaining;
+        size_t got = fread(out, 1, want, zs->fp);
+        zs->remaining -= (uint32_t)got;
+        if (got < want) {
+            return -1;
+        }
+        zs->finished = (zs->remaining == 0);
+        return (long)got;
+    }
+
+    zs->zs.next_out = out;
+    zs->zs.avail_out = (uInt)cap;
+    while (zs->zs.avail_out == cap) {
+        if (zs->zs.avail_in == 0 && zs->remaining > 0) {
+            size_t want = (zs->remaining < sizeof(zs->in)) ? zs->remaining : sizeof(zs->in);
+            if (fread(zs->in, 1, want, zs->fp) != want) {
+                return -1;
+            }
+            zs->remaining -= (uint32_t)want;
+            zs->zs.next_in = zs->in;
+            zs->zs.avail_in = (uInt)want;
+        }
+        int ret = inflate(&zs->zs, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            zs->finished = 1;
+            break;
+        }
+        if (ret != Z_OK && !(ret == Z_BUF_ERROR && zs->zs.avail_in == 0 && zs->remaining > 0)) {
+            return -1;
+        }
+    }
+    return (long)(cap - zs->zs.avail_out);
+}
+
+static double zip_stream_fraction(const zip_member_stream *zs)
+{
+    if (zs->total == 0) {
+        return 1.0;
+    }
+    return (double)(zs->total - zs->remaining) / (double)zs->total;
+}
+
+static void zip_stream_close(zip_member_stream *zs)
+{
+    if (zs->inflating) {
+        inflateEnd(&zs->zs);
+        zs->inflating = 0;
+    }
+    if (zs->fp) {
+        fclose(zs->fp);
+        zs->fp = NULL;
+    }
+}
+
+/* Finds the next complete <row> element in the buffer, inflating more of
+   the sheet as needed. Returns 1 with its cells (sorted by column), 0 at the
+   end of the sheet, -1 on a broken archive (ss->eof is then -1 too). Rows
+   without values are skipped. */
+static int sheet_stream_next_row(sheet_stream *ss, const string_list *shared, cell_array *cells)
+{
+    for (;;) {
+        char *row = ss->buf ? strstr(ss->buf + ss->pos, "<row") : NULL;
+        /* <rowBreaks> and the like are not rows. */
+        while (row && row[4] != ' ' && row[4] != '>' && row[4] != '/' && row[4] != '\0') {
+            row = strstr(row + 4, "<row");
+        }
+        if (row) {
+            char *open_end = strchr(row, '>');
+            if (open_end && open_end[-1] == '/') {
+                ss->pos = (size_t)(open_end + 1 - ss->buf);
+                continue;
+            }
+            char *row_end = open_end ? strstr(open_end, "</row>") : NULL;
+            if (row_end) {
+                cell_array_init(cells);
+                parse_row_cells(row, row_end, shared, cells);
+                ss->pos = (size_t)(row_end + 6 - ss->buf);
+                if (cells->count == 0) {
+                    cell_array_free(cells);
+                    continue;
+                }
+                cell_array_sort(cells);
+                return 1;
+            }
+        }
+        if (ss->eof) {
+            return ss->eof < 0 ? -1 : 0;
+        }
+
+        /* Keep the partial row (or a tail that may start one) and read on. */
+        size_t tail = ss->len - ss->pos;
+        size_t keep_from = row ? (size_t)(row - ss->buf) : ss->len - (tail < 3 ? tail : 3);
+        if (ss->buf) {
+            memmove(ss->buf, ss->buf + keep_from, ss->len - keep_from);
+            ss->len -= keep_from;
+            ss->pos = 0;
+        }
+        if (ss->cap - ss->len < XL_STREAM_CHUNK + 1) {
+            size_t new_cap = ss->cap ? ss->cap * 2 : 2 * XL_STREAM_CHUNK;
+            while (new_cap - ss->len < XL_STREAM_CHUNK + 1) new_cap *= 2;
+            char *grown = (char *)realloc(ss->buf, new_cap);
+            if (!grown) {
+                ss->eof = -1;
+                return -1;
+            }
+            ss->buf = grown;
+            ss->cap = new_cap;
+        }
+        long got = zip_stream_read(&ss->zip, (unsigned char *)ss->buf + ss->len, XL_STREAM_CHUNK);
+        if (got < 0) {
+            ss->eof = -1;
+        } else if (got == 0) {
+            ss->eof = 1;
+        } else {
+            ss->len += (size_t)got;
+        }
+        ss->buf[ss->len] = '\0';
+    }
+}
+
+/* Rows an XLSX sheet holds, header included */
+#define XL_MAX_ROWS 1048576
+#define XL_EXPORT_REPORT_ROWS 4096
+
+typedef struct {
+    FILE *fp;
+    struct zip_source *sheet;  /* size and crc32 grow as rows are written */
+    struct string_builder row;
+    int cols;
+    int key_col;               /* left out of the sheet */
+    unsigned char *is_bool;
+    long long rows;            /* written, header included */
+    long long total;           /* view rows, <0 when unknown */
+    const char *error;         /* why export_row stopped */
+    const ProgressReporter *progress;
+} xl_export;
+
+static int export_put(xl_export *x, const char *data, size_t len)
+{
+    if (x->sheet->size + len > UINT32_MAX) {
+        x->error = "Export too large for XLSX (over 4 GiB)";
+        return -1;
+    }
+    if (fwrite(data, 1, len, x->fp) != len) {
+        x->error = "Failed to write XLSX";
+        return -1;
+    }
+    x->sheet->crc32 = (uint32_t)crc32(x->sheet->crc32, (const Bytef *)data, (uInt)len);
+    x->sheet->size += len;
+    return 0;
+}
+
+/* Appends one inline-string cell; empty cells are left out, as in build_sheet_xml. */
+static int export_cell(xl_export *x, size_t col, const char *text)
+{
+    char ref[16];
+    if (!text || !text[0]) {
+        return 0;
+    }
+    column_index_to_ref(col, (size_t)x->rows + 1, ref, sizeof(ref));
+    char *escaped = xml_escape(text);
+    if (!escaped) {
+        return -1;
+    }
+    int rc = sb_append_format(&x->row, "      <c r=\"%s\" t=\"inlineStr\"><is><t>%s</t></is></c>\n", ref, escaped);
+    free(escaped);
+    return rc;
+}
+
+static int export_end_row(xl_export *x)
+{
+    if (sb_append(&x->row, "    </row>\n") != 0) {
+        x->error = "Out of memory";
+        return -1;
+    }
+    if (export_put(x, x->row.data, x->row.length) != 0) {
+        return -1;
+    }
+    x->row.length = 0;
+    x->rows++;
+    return 0;
+}
+
+static bool export_row(void *user, sqlite3_stmt *row)
+{
+    xl_export *x = (xl_export *)user;
+    size_t out = 0;
+
+    if (x->rows >= XL_MAX_ROWS) {
+        x->error = "Too many rows for an XLSX sheet (1048576 at most)";
+        return false;
+    }
+    if (sb_append_format(&x->row, "    <row r=\"%lld\">\n", x->rows + 1) != 0) {
+        x->error = "Out of memory";
+        return false;
+    }
+    for (int j = 0; j < x->cols; ++j) {
+        const char *text;
+        if (j == x->key_col) {
+            continue;
+        }
+        if (sqlite3_column_type(row, j) == SQLITE_NULL) {
+            text = NULL;
+        } else if (x->is_bool[j] && sqlite3_column_type(row, j) == SQLITE_INTEGER) {
+            /* other values in a BOOLEAN column keep their text */
+            text = sqlite3_column_int(row, j) ? "true" : "false";
+        } else {
+            text = (const char *)sqlite3_column_text(row, j);
+        }
+        if (export_cell(x, out++, text) != 0) {
+            x->error = "Out of memory";
+            return false;
+        }
+    }
+    if (export_end_row(x) != 0) {
+        return false;
+    }
+    if ((x->rows - 1) % XL_EXPORT_REPORT_ROWS == 0 && x->progress) {
+        char msg[96];
+        long long done = x->rows - 1;
+        if (x->total > 0) {
+            snprintf(msg, sizeof(msg), "Exported %lld of %lld rows...", done, x->total);
+        } else {
+            snprintf(msg, sizeof(msg), "Exported %lld rows...", done);
+        }
+        report_progress(x->progress, x->total > 0 ? 0.98 * (double)done / (double)x->total : 0.0, msg);
+    }
+    return true;
+}
+
+long long xl_export_seekdb(seekdb *s,
+                           const char *sheet_name,
+                           const char *path,
+                           char *err,
+                           size_t err_sz,
+                           const ProgressReporter *progress)
+{
+    char safe_sheet_name[MAX_SHEET_NAME_LEN + 1];
+    char **names = NULL;
+    char **decls = NULL;
+    char *workbook_xml = NULL;
+    long long rows = -1;
+    xl_export x;
+
+    memset(&x, 0, sizeof(x));
+    if (err && err_sz) {
+        err[0] = '\0';
+    }
+    if (!s || !path) {
+        if (err) snprintf(err, err_sz, "Invalid arguments");
+        return -1;
+    }
+    if (ensure_sheet_name(safe_sheet_name, sizeof(safe_sheet_name), sheet_name ? sheet_name : "Sheet1") != 0 ||
+        !(workbook_xml = build_workbook_xml(safe_sheet_name))) {
+        if (err) snprintf(err, err_sz, "Out of memory");
+        return -1;
+    }
+    x.cols = seekdb_get_view_columns(s, &names, err, err_sz);
+    if (x.cols <= 0) {
+        free(workbook_xml);
+        return -1;
+    }
+    if (seekdb_get_view_column_types(s, &decls, err, err_sz) != x.cols) {
+        goto done;
+    }
+    x.is_bool = (unsigned char *)calloc((size_t)x.cols, 1);
+    if (!x.is_bool) {
+        if (err) snprintf(err, err_sz, "Out of memory");
+        goto done;
+    }
+    for (int j = 0; j < x.cols; ++j) {
+        x.is_bool[j] = (unsigned char)seekdb_decl_is_bool(decls[j]);
+    }
+    x.key_col = seekdb_view_key_column(s, NULL, 0);
+    x.total = seekdb_count_estimate(s, NULL);
+    x.progress = progress;
+
+    struct zip_source sources[] = {
+        {.name = "[Content_Types].xml", .data = (const unsigned char *)content_types_xml()},
+        {.name = "_rels/.rels", .data = (const unsigned char *)rels_root_xml()},
+        {.name = "xl/workbook.xml", .data = (const unsigned char *)workbook_xml},
+        {.name = "xl/_rels/workbook.xml.rels", .data = (const unsigned char *)workbook_rels_xml()},
+        {.name = "xl/worksheets/sheet1.xml", .data = NULL},
+        {.name = "xl/styles.xml", .data = (const unsigned char *)styles_xml()},
+    };
+    size_t source_count = sizeof(sources) / sizeof(sources[0]);
+    uint32_t dos_time = static_dos_time();
+    uint32_t dos_date = static_dos_date();
+    x.sheet = &sources[4];
+    for (size_t i = 0; i < source_count; ++i) {
+        if (sources[i].data) {
+            sources[i].size = strlen((const char *)sources[i].data);
+            sources[i].crc32 = crc32(0L, sources[i].data, (uInt)sources[i].size);
+        }
+    }
+
+    x.fp = fopen(path, "wb");
+    if (!x.fp) {
+        if (err) snprintf(err, err_sz, "Failed to open for write: %s", path);
+        goto done;
+    }
+    report_progress(progress, 0.0, "Exporting rows...");
+    for (size_t i = 0; i < source_count && sources[i].data; ++i) {
+        sources[i].offset = (uint32_t)ftell(x.fp);
+        zip_put_local_header(x.fp, &sources[i], dos_time, dos_date);
+        fwrite(sources[i].data, 1, sources[i].size, x.fp);
+    }
+
+    /* The sheet is written stored as rows arrive; its header gets the
+       final size and CRC once they are known. */
+    x.sheet->offset = (uint32_t)ftell(x.fp);
+    zip_put_local_header(x.fp, x.sheet, dos_time, dos_date);
+    const char *head = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+                       "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">\n"
+                       "  <sheetData>\n";
+    const char *tail = "  </sheetData>\n</worksheet>";
+    if (export_put(&x, head, strlen(head)) != 0 ||
+        sb_append_format(&x.row, "    <row r=\"1\">\n") != 0) {
+        if (err) snprintf(err, err_sz, "%s", x.error ? x.error : "Out of memory");
+        goto done;
+    }
+    size_t out = 0;
+    for (int j = 0; j < x.cols; ++j) {
+        if (j != x.key_col && export_cell(&x, out++, names[j]) != 0) {
+            x.error = "Out of memory";
+            break;
+        }
+    }
+    if (x.error || export_end_row(&x) != 0) {
+        if (err) snprintf(err, err_sz, "%s", x.error);
+        goto done;
+    }
+
+    rows = seekdb_scan(s, export_row, &x, err, err_sz);
+    if (rows >= 0 && x.error) {
+        rows = -1;
+    }
+    if (rows >= 0 && export_put(&x, tail, strlen(tail)) != 0) {
+        rows = -1;
+    }
+    if (rows < 0) {
+        if (err && x.error) snprintf(err, err_sz, "%s", x.error);
+        goto done;
+    }
+
+    long end = ftell(x.fp);
+    unsigned char fields[12];
+    put_le32(fields, x.sheet->crc32);
+    put_le32(fields + 4, (uint32_t)x.sheet->size);
+    put_le32(fields + 8, (uint32_t)x.sheet->size);
+    if (fseek(x.fp, (long)x.sheet->offset + 14, SEEK_SET) != 0 ||
+        fwrite(fields, 1, sizeof(fields), x.fp) != sizeof(fields) ||
+        fseek(x.fp, end, SEEK_SET) != 0) {
+        rows = -1;
+    }
+    for (size_t i = 5; i < source_count && rows >= 0; ++i) {
+        sources[i].offset = (uint32_t)ftell(x.fp);
+        zip_put_local_header(x.fp, &sources[i], dos_time, dos_date);
+        fwrite(sources[i].data, 1, sources[i].size, x.fp);
+    }
+    if (rows >= 0) {
+        zip_put_directory(x.fp, sources, source_count, dos_time, dos_date);
+    }
+    if (ferror(x.fp)) {
+        rows = -1;
+    }
+    if (fclose(x.fp) != 0 || rows < 0) {
+        if (err) snprintf(err, err_sz, "Failed to write XLSX");
+        rows = -1;
+    }
+    x.fp = NULL;
+    if (rows >= 0) {
+        report_progress(progress, 1.0, "Done");
+    }
+
+done:
+    if (x.fp) {
+        fclose(x.fp);
+    }
+    if (rows < 0) {
+        remove(path);
+    }
+    free(x.row.data);
+    free(x.is_bool);
+    for (int j = 0; j < x.cols; ++j) {
+        if (names) free(names[j]);
+        if (decls) free(decls[j]);
+    }
+    free(names);
+    free(decls);
+    free(workbook_xml);
+    return rows;
+}
+
 static uint16_t static_dos_time(void)
 {
     struct tm tm_val;
@@ -734,59 +1454,48 @@ static uint16_t static_dos_date(void)
                       (((tm_val.tm_mon + 1) & 0x0F) << 5) | (tm_val.tm_mday & 0x1F));
 }
 
-static int zip_write_files(const char *archive_path,
-                           struct zip_source *sources,
-                           size_t source_count)
+static void put_le32(unsigned char *buf, uint32_t value)
 {
-    FILE *fp = fopen(archive_path, "wb");
-    if (!fp) {
-        return -1;
-    }
-
-    uint32_t dos_time = static_dos_time();
-    uint32_t dos_date = static_dos_date();
-
-    for (size_t i = 0; i < source_count; ++i) {
-        struct zip_source *src = &sources[i];
-        src->offset = (uint32_t)ftell(fp);
-
-        unsigned char header[30];
-        memset(header, 0, sizeof(header));
-        header[0] = 0x50;
-        header[1] = 0x4b;
-        header[2] = 0x03;
-        header[3] = 0x04;
-        header[4] = 0x14;
-        header[5] = 0x00;
-        header[10] = (unsigned char)(dos_time & 0xFF);
-        header[11] = (unsigned char)((dos_time >> 8) & 0xFF);
-        header[12] = (unsigned char)(dos_date & 0xFF);
-        header[13] = (unsigned char)((dos_date >> 8) & 0xFF);
-        header[14] = (unsigned char)(src->crc32 & 0xFF);
-        header[15] = (unsigned char)((src->crc32 >> 8) & 0xFF);
-        header[16] = (unsigned char)((src->crc32 >> 16) & 0xFF);
-        header[17] = (unsigned char)((src->crc32 >> 24) & 0xFF);
-        header[18] = (unsigned char)(src->size & 0xFF);
-        header[19] = (unsigned char)((src->size >> 8) & 0xFF);
-        header[20] = (unsigned char)((src->size >> 16) & 0xFF);
-        header[21] = (unsigned char)((src->size >> 24) & 0xFF);
-        header[22] = header[18];
-        header[23] = header[19];
-        header[24] = header[20];
-        header[25] = header[21];
-        uint16_t name_len = (uint16_t)strlen(src->name);
-        header[26] = (unsigned char)(name_len & 0xFF);
-        header[27] = (unsigned char)((name_len >> 8) & 0xFF);
+    buf[0] = (unsigned char)(value & 0xFF);
+    buf[1] = (unsigned char)((value >> 8) & 0xFF);
+    buf[2] = (unsigned char)((value >> 16) & 0xFF);
+    buf[3] = (unsigned char)((value >> 24) & 0xFF);
+}
 
-        fwrite(header, 1, sizeof(header), fp);
-        fwrite(src->name, 1, name_len, fp);
-        fwrite(src->data, 1, src->size, fp);
-    }
+/* Local header and name of a stored member; its data follows. */
+static void zip_put_local_header(FILE *fp, const struct zip_source *src, uint32_t dos_time, uint32_t dos_date)
+{
+    unsigned char header[30];
+    memset(header, 0, sizeof(header));
+    header[0] = 0x50;
+    header[1] = 0x4b;
+    header[2] = 0x03;
+    header[3] = 0x04;
+    header[4] = 0x14;
+    header[5] = 0x00;
+    header[10] = (unsigned char)(dos_time & 0xFF);
+    header[11] = (unsigned char)((dos_time >> 8) & 0xFF);
+    header[12] = (unsigned char)(dos_date & 0xFF);
+    header[13] = (unsigned char)((dos_date >> 8) & 0xFF);
+    put_le32(header + 14, src->crc32);
+    put_le32(header + 18, (uint32_t)src->size);
+    put_le32(header + 22, (uint32_t)src->size);
+    uint16_t name_len = (uint16_t)strlen(src->name);
+    header[26] = (unsigned char)(name_len & 0xFF);
+    header[27] = (unsigned char)((name_len >> 8) & 0xFF);
+
+    fwrite(header, 1, sizeof(header), fp);
+    fwrite(src->name, 1, name_len, fp);
+}
 
+/* Central directory and end record for members already written. */
+static void zip_put_directory(FILE *fp, const struct zip_source *sources, size_t source_count,
+                              uint32_t dos_time, uint32_t dos_date)
+{
     uint32_t central_offset = (uint32_t)ftell(fp);
 
     for (size_t i = 0; i < source_count; ++i) {
-        struct zip_source *src = &sources[i];
+        const struct zip_source *src = &sources[i];
         unsigned char header[46];
         memset(header, 0, sizeof(header));
         header[0] = 0x50;
@@ -801,25 +1510,13 @@ static int zip_write_files(const char *archive_path,
         header[11] = (unsigned char)((dos_time >> 8) & 0xFF);
         header[12] = (unsigned char)(dos_date & 0xFF);
         header[13] = (unsigned char)((dos_date >> 8) & 0xFF);
-        header[14] = (unsigned char)(src->crc32 & 0xFF);
-        header[15] = (unsigned char)((src->crc32 >> 8) & 0xFF);
-        header[16] = (unsigned char)((src->crc32 >> 16) & 0xFF);
-        header[17] = (unsigned char)((src->crc32 >> 24) & 0xFF);
-        header[18] = (unsigned char)(src->size & 0xFF);
-        header[19] = (unsigned char)((src->size >> 8) & 0xFF);
-        header[20] = (unsigned char)((src->size >> 16) & 0xFF);
-        header[21] = (unsigned char)((src->size >> 24) & 0xFF);
-        header[22] = header[18];
-        header[23] = header[19];
-        header[24] = header[20];
-        header[25] = header[21];
+        put_le32(header + 14, src->crc32);
+        put_le32(header + 18, (uint32_t)src->size);
+        put_le32(header + 22, (uint32_t)src->size);
         uint16_t name_len = (uint16_t)strlen(src->name);
         header[28] = (unsigned char)(name_len & 0xFF);
         header[29] = (unsigned char)((name_len >> 8) & 0xFF);
-        header[42] = (unsigned char)(src->offset & 0xFF);
-        header[43] = (unsigned char)((src->offset >> 8) & 0xFF);
-        header[44] = (unsigned char)((src->offset >> 16) & 0xFF);
-        header[45] = (unsigned char)((src->offset >> 24) & 0xFF);
+        put_le32(header + 42, src->offset);
 
         fwrite(header, 1, sizeof(header), fp);
         fwrite(src->name, 1, name_len, fp);
@@ -837,16 +1534,32 @@ static int zip_write_files(const char *archive_path,
     end_record[9] = (unsigned char)((source_count >> 8) & 0xFF);
     end_record[10] = end_record[8];
     end_record[11] = end_record[9];
-    end_record[12] = (unsigned char)(central_size & 0xFF);
-    end_record[13] = (unsigned char)((central_size >> 8) & 0xFF);
-    end_record[14] = (unsigned char)((central_size >> 16) & 0xFF);
-    end_record[15] = (unsigned char)((central_size >> 24) & 0xFF);
-    end_record[16] = (unsigned char)(central_offset & 0xFF);
-    end_record[17] = (unsigned char)((central_offset >> 8) & 0xFF);
-    end_record[18] = (unsigned char)((central_offset >> 16) & 0xFF);
-    end_record[19] = (unsigned char)((central_offset >> 24) & 0xFF);
+    put_le32(end_record + 12, central_size);
+    put_le32(end_record + 16, central_offset);
 
     fwrite(end_record, 1, sizeof(end_record), fp);
+}
+
+static int zip_write_files(const char *archive_path,
+                           struct zip_source *sources,
+                           size_t source_count)
+{
+    FILE *fp = fopen(archive_path, "wb");
+    if (!fp) {
+        return -1;
+    }
+
+    uint32_t dos_time = static_dos_time();
+    uint32_t dos_date = static_dos_date();
+
+    for (size_t i = 0; i < source_count; ++i) {
+        struct zip_source *src = &sources[i];
+        src->offset = (uint32_t)ftell(fp);
+        zip_put_local_header(fp, src, dos_time, dos_date);
+        fwrite(src->data, 1, src->size, fp);
+    }
+
+    zip_put_directory(fp, sources, source_count, dos_time, dos_date);
     fclose(fp);
     return 0;
 }
@@ -1081,6 +1794,72 @@ static void parse_shared_strings(const char *xml, string_list *strings)
     }
 }
 
+/* Cells of the row element between row_start and row_end, in document order. */
+static void parse_row_cells(const char *row_start,
+                            const char *row_end,
+                            const string_list *shared,
+                            cell_array *cells)
+{
+    const char *cell_cursor = row_start;
+    size_t implicit_col = 0;
+    while ((cell_cursor = strstr(cell_cursor, "<c")) != NULL && cell_cursor < row_end) {
+        const char *cell_end = strstr(cell_cursor, "</c>");
+        if (!cell_end) {
+            break;
+        }
+        const char *ref_attr = strstr(cell_cursor, " r=");
+        size_t column_index = implicit_col++;
+        if (ref_attr && ref_attr < cell_end) {
+            const char *quote = strchr(ref_attr, '"');
+            if (quote && quote < cell_end) {
+                const char *quote_end = strchr(quote + 1, '"');
+                if (quote_end && quote_end < cell_end) {
+                    column_index = parse_column_from_ref(quote + 1);
+                }
+            }
+        }
+
+        const char *type_attr = strstr(cell_cursor, " t=");
+        char type = '\0';
+        if (type_attr && type_attr < cell_end) {
+            const char *quote = strchr(type_attr, '"');
+            if (quote && quote < cell_end) {
+                type = quote[1];
+            }
+        }
+
+        char *text = NULL;
+        if (type == 's') {
+            char *index_text = extract_tag_text(cell_cursor, cell_end, "v");
+            if (index_text) {
+                long idx = strtol(index_text, NULL, 10);
+                free(index_text);
+                if (idx >= 0 && (size_t)idx < shared->count) {
+                    text = heap_strdup(shared->items[idx]);
+                }
+            }
+        } else if (type == 'i') {
+            const char *inline_start = strstr(cell_cursor, "<is>");
+            if (inline_start && inline_start < cell_end) {
+                char *inline_text = extract_tag_text(inline_start, cell_end, "t");
+                if (inline_text) {
+                    text = inline_text;
+                }
+            }
+        } else {
+            char *value_text = extract_tag_text(cell_cursor, cell_end, "v");
+            if (value_text) {
+                text = value_text;
+            }
+        }
+
+        if (text) {
+            cell_array_push(cells, column_index, text);
+        }
+        cell_cursor = cell_end + 4;
+    }
+}
+
 static int parse_sheet_collect(const char *xml,
                                const string_list *shared,
                                parsed_sheet *sheet)
@@ -1097,64 +1876,7 @@ static int parse_sheet_collect(const char *xml,
         cell_array cells;
         cell_array_init(&cells);
 
-        const char *cell_cursor = cursor;
-        size_t implicit_col = 0;
-        while ((cell_cursor = strstr(cell_cursor, "<c")) != NULL && cell_cursor < row_end) {
-            const char *cell_end = strstr(cell_cursor, "</c>");
-            if (!cell_end) {
-                break;
-            }
-            const char *ref_attr = strstr(cell_cursor, " r=");
-            size_t column_index = implicit_col++;
-            if (ref_attr && ref_attr < cell_end) {
-                const char *quote = strchr(ref_attr, '"');
-                if (quote && quote < cell_end) {
-                    const char *quote_end = strchr(quote + 1, '"');
-                    if (quote_end && quote_end < cell_end) {
-                        column_index = parse_column_from_ref(quote + 1);
-                    }
-                }
-            }
-
-            const char *type_attr = strstr(cell_cursor, " t=");
-            char type = '\0';
-            if (type_attr && type_attr < cell_end) {
-                const char *quote = strchr(type_attr, '"');
-                if (quote && quote < cell_end) {
-                    type = quote[1];
-                }
-            }
-
-            char *text = NULL;
-            if (type == 's') {
-                char *index_text = extract_tag_text(cell_cursor, cell_end, "v");
-                if (index_text) {
-                    long idx = strtol(index_text, NULL, 10);
-                    free(index_text);
-                    if (idx >= 0 && (size_t)idx < shared->count) {
-                        text = heap_strdup(shared->items[idx]);
-                    }
-                }
-            } else if (type == 'i') {
-                const char *inline_start = strstr(cell_cursor, "<is>");
-                if (inline_start && inline_start < cell_end) {
-                    char *inline_text = extract_tag_text(inline_start, cell_end, "t");
-                    if (inline_text) {
-                        text = inline_text;
-                    }
-                }
-            } else {
-                char *value_text = extract_tag_text(cell_cursor, cell_end, "v");
-                if (value_text) {
-                    text = value_text;
-                }
-            }
-
-            if (text) {
-                cell_array_push(&cells, column_index, text);
-            }
-            cell_cursor = cell_end + 4;
-        }
+        parse_row_cells(cursor, row_end, shared, &cells);
 
         if (cells.count > 0) {
             cell_array_sort(&cells);
@@ -6,6 +6,9 @@
 #include "ui.h"
 #include "panel_manager.h"
 #include "settings.h"
+#include "text_fold.h"
+#include "mem_budget.h"
+#include "seekdb.h"
 #include "db_manager.h"
 #include "workspace.h"
 #include "errors.h"
@@ -33,7 +36,13 @@ int main(int argc, char **argv) {
     settings_load(settings_default_path(), &s);
     workspace_set_autosave_enabled(s.autosave_enabled);
     low_ram_mode = s.low_ram_enabled ? 1 : 0;
+    low_ram_auto = (!low_ram_mode && s.low_ram_auto) ? 1 : 0;
+    mem_budget_set_mb(s.memory_budget_mb);
+    seekdb_tuning tuning = { s.seekdb_cache_mb, s.seekdb_mmap_mb, s.seekdb_page_size, s.seekdb_spill_mem_mb };
+    seekdb_set_tuning(&tuning);
     row_gutter_enabled = s.show_row_gutter ? 1 : 0;
+    text_fold_set_default_flags(s.fold_accents ? TEXT_FOLD_STRIP_ACCENTS : 0);
+    seek_mode_set_cache_budget((size_t)s.seek_cache_mb << 20);
 
     Table *table = NULL;
     char werr[256] = {0};
@@ -52,6 +61,7 @@ int main(int argc, char **argv) {
 
     start_ui_loop(table);  // From ui_loop.c
 
+    seek_mode_close();  // stops the prefetch thread, removes spill files
     free_table(table);
     workspace_shutdown();
     pm_teardown();
@@ -61,7 +71,9 @@ int main(int argc, char **argv) {
     settings_load(settings_default_path(), &s);
     s.autosave_enabled = workspace_autosave_enabled();
     s.low_ram_enabled = (low_ram_mode != 0);
+    s.low_ram_auto = (low_ram_auto != 0);
     s.show_row_gutter = (row_gutter_enabled != 0);
+    s.fold_accents = (text_fold_default_flags() & TEXT_FOLD_STRIP_ACCENTS) != 0;
     settings_save(settings_default_path(), &s);
     return 0;
 }
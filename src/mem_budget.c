@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mem_budget.h"
+
+static int g_budget_mb = 0;
+
+void mem_budget_set_mb(int mb)
+{
+    g_budget_mb = mb > 0 ? mb : 0;
+}
+
+int mem_budget_mb(void)
+{
+    return g_budget_mb;
+}
+
+unsigned long long mem_available_bytes(void)
+{
+    FILE *f = fopen("/proc/meminfo", "r");
+    char line[128];
+    unsigned long long kib = 0;
+
+    if (f) {
+        while (fgets(line, sizeof(line), f)) {
+            if (sscanf(line, "MemAvailable: %llu kB", &kib) == 1) break;
+        }
+        fclose(f);
+        if (kib > 0) return kib * 1024ULL;
+    }
+#if defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+    {
+        long pages = sysconf(_SC_AVPHYS_PAGES);
+        long page = sysconf(_SC_PAGESIZE);
+        if (pages > 0 && page > 0) return (unsigned long long)pages * (unsigned long long)page;
+    }
+#endif
+    return 0;
+}
+
+unsigned long long mem_budget_bytes(void)
+{
+    if (g_budget_mb > 0) return (unsigned long long)g_budget_mb << 20;
+    return mem_available_bytes() / 2;
+}
+
+int mem_budget_fits(unsigned long long bytes)
+{
+    unsigned long long budget = mem_budget_bytes();
+
+    return budget == 0 || bytes == 0 || bytes <= budget;
+}
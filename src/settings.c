@@ -54,7 +54,15 @@ void settings_init_defaults(AppSettings *s) {
     s->autosave_enabled = true;
     s->type_infer_enabled = true;
     s->low_ram_enabled = false;
+    s->low_ram_auto = false;
+    s->fold_accents = false;
     s->show_row_gutter = true;
+    s->seek_cache_mb = SEEK_CACHE_DEFAULT_MB;
+    s->memory_budget_mb = 0;
+    s->seekdb_cache_mb = 0;
+    s->seekdb_mmap_mb = 0;
+    s->seekdb_page_size = 0;
+    s->seekdb_spill_mem_mb = 0;
     s->theme_id = 0;
 }
 
@@ -77,10 +85,44 @@ int settings_load(const char *path, AppSettings *out) {
     if (json_object_object_get_ex(root, "low_ram_enabled", &jlow)) {
         out->low_ram_enabled = json_object_get_boolean(jlow);
     }
+    struct json_object *jlauto = NULL;
+    if (json_object_object_get_ex(root, "low_ram_auto", &jlauto)) {
+        out->low_ram_auto = json_object_get_boolean(jlauto);
+    }
+    struct json_object *jfold = NULL;
+    if (json_object_object_get_ex(root, "fold_accents", &jfold)) {
+        out->fold_accents = json_object_get_boolean(jfold);
+    }
     struct json_object *jg = NULL;
     if (json_object_object_get_ex(root, "show_row_gutter", &jg)) {
         out->show_row_gutter = json_object_get_boolean(jg);
     }
+    struct json_object *jcache = NULL;
+    if (json_object_object_get_ex(root, "seek_cache_mb", &jcache)) {
+        int mb = json_object_get_int(jcache);
+        out->seek_cache_mb = mb >= 0 ? mb : SEEK_CACHE_DEFAULT_MB;
+    }
+    struct json_object *jbudget = NULL;
+    if (json_object_object_get_ex(root, "memory_budget_mb", &jbudget)) {
+        int mb = json_object_get_int(jbudget);
+        out->memory_budget_mb = mb > 0 ? mb : 0;
+    }
+    // SQLite tuning knobs (JSON only; no settings rows)
+    struct json_object *jsq = NULL;
+    if (json_object_object_get_ex(root, "seekdb_cache_mb", &jsq)) {
+        int mb = json_object_get_int(jsq);
+        out->seekdb_cache_mb = mb > 0 ? mb : 0;
+    }
+    if (json_object_object_get_ex(root, "seekdb_mmap_mb", &jsq)) {
+        out->seekdb_mmap_mb = json_object_get_int(jsq);
+    }
+    if (json_object_object_get_ex(root, "seekdb_page_size", &jsq)) {
+        int size = json_object_get_int(jsq);
+        out->seekdb_page_size = size > 0 ? size : 0;
+    }
+    if (json_object_object_get_ex(root, "seekdb_spill_mem_mb", &jsq)) {
+        out->seekdb_spill_mem_mb = json_object_get_int(jsq);
+    }
     struct json_object *jtheme = NULL;
     if (json_object_object_get_ex(root, "theme_id", &jtheme)) {
         out->theme_id = settings_normalize_theme(json_object_get_int(jtheme));
@@ -99,7 +141,15 @@ int settings_save(const char *path, const AppSettings *s) {
     json_object_object_add(root, "autosave_enabled", json_object_new_boolean(s->autosave_enabled));
     json_object_object_add(root, "type_infer_enabled", json_object_new_boolean(s->type_infer_enabled));
     json_object_object_add(root, "low_ram_enabled", json_object_new_boolean(s->low_ram_enabled));
+    json_object_object_add(root, "low_ram_auto", json_object_new_boolean(s->low_ram_auto));
+    json_object_object_add(root, "fold_accents", json_object_new_boolean(s->fold_accents));
     json_object_object_add(root, "show_row_gutter", json_object_new_boolean(s->show_row_gutter));
+    json_object_object_add(root, "seek_cache_mb", json_object_new_int(s->seek_cache_mb));
+    json_object_object_add(root, "memory_budget_mb", json_object_new_int(s->memory_budget_mb));
+    json_object_object_add(root, "seekdb_cache_mb", json_object_new_int(s->seekdb_cache_mb));
+    json_object_object_add(root, "seekdb_mmap_mb", json_object_new_int(s->seekdb_mmap_mb));
+    json_object_object_add(root, "seekdb_page_size", json_object_new_int(s->seekdb_page_size));
+    json_object_object_add(root, "seekdb_spill_mem_mb", json_object_new_int(s->seekdb_spill_mem_mb));
     json_object_object_add(root, "theme_id", json_object_new_int(settings_normalize_theme(s->theme_id)));
     int rc = json_object_to_file_ext(path, root, JSON_C_TO_STRING_PRETTY);
     json_object_put(root);
@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../include/tablecraft.h"
+#include "../include/text_fold.h"
+#include "../include/cell_arena.h"
 
 Table *create_table(const char *name) {
     Table *t = malloc(sizeof(Table));
@@ -13,6 +15,7 @@ Table *create_table(const char *name) {
     t->capacity_columns = 0;
     t->capacity_rows = 0;
     t->dirty = 0;
+    t->arena = NULL;
     return t;
 }
 
@@ -20,6 +23,7 @@ void free_table(Table *t) {
     if (!t) return;
 
     if (t->name) free(t->name);
+    table_invalidate_fold_keys(t, -1);
     for (int i = 0; i < t->column_count; i++) {
         if (t->columns[i].name) free(t->columns[i].name);
     }
@@ -28,15 +32,14 @@ void free_table(Table *t) {
     for (int i = 0; i < t->row_count; i++) {
         if (t->rows[i].values) {
             for (int j = 0; j < t->column_count; j++) {
-                if (t->rows[i].values[j]) {
-                    free(t->rows[i].values[j]);
-                }
+                cell_free(t->arena, t->rows[i].values[j]);
             }
             free(t->rows[i].values);
         }
     }
 
     free(t->rows);
+    cell_arena_free(t->arena);
     free(t);
 }
 
@@ -47,6 +50,7 @@ void clear_table(Table *t, const char *name) {
     int old_rows = t->row_count;
 
     if (t->name) free(t->name);
+    table_invalidate_fold_keys(t, -1);
     for (int i = 0; i < old_cols; i++) {
         if (t->columns[i].name) free(t->columns[i].name);
     }
@@ -55,12 +59,13 @@ void clear_table(Table *t, const char *name) {
     for (int i = 0; i < old_rows; i++) {
         if (t->rows[i].values) {
             for (int j = 0; j < old_cols; j++) {
-                if (t->rows[i].values[j]) free(t->rows[i].values[j]);
+                cell_free(t->arena, t->rows[i].values[j]);
             }
             free(t->rows[i].values);
         }
     }
     free(t->rows);
+    cell_arena_free(t->arena);
 
     t->name = strdup(name ? name : "Untitled Table");
     t->columns = NULL;
@@ -70,6 +75,7 @@ void clear_table(Table *t, const char *name) {
     t->capacity_columns = 0;
     t->capacity_rows = 0;
     t->dirty = 0;
+    t->arena = NULL;
 }
 
 int replace_table_contents(Table *dest, Table *src) {
@@ -85,6 +91,7 @@ int replace_table_contents(Table *dest, Table *src) {
     dest->capacity_columns = src->capacity_columns;
     dest->capacity_rows = src->capacity_rows;
     dest->dirty = src->dirty;
+    dest->arena = src->arena;
 
     src->name = NULL;
     src->columns = NULL;
@@ -94,6 +101,7 @@ int replace_table_contents(Table *dest, Table *src) {
     src->capacity_columns = 0;
     src->capacity_rows = 0;
     src->dirty = 0;
+    src->arena = NULL;
     free(src);
     return 0;
 }
@@ -106,6 +114,9 @@ int add_column(Table *t, const char *name, DataType type) {
 
     t->columns[t->column_count].name = strdup(name);
     t->columns[t->column_count].type = type;
+    t->columns[t->column_count].fold_keys = NULL;
+    t->columns[t->column_count].fold_key_count = 0;
+    t->columns[t->column_count].fold_flags = 0;
 
     // 🌈 Assign rainbow color
     int color_cycle[] = {10, 11, 12, 13, 14, 15, 16};
@@ -129,6 +140,7 @@ int add_row(Table *t, const char **input_strings) {
         t->rows = realloc(t->rows, t->capacity_rows * sizeof(Row));
     }
 
+    table_invalidate_fold_keys(t, -1);
     Row *r = &t->rows[t->row_count];
     r->values = malloc(t->column_count * sizeof(void *));
 
@@ -155,6 +167,72 @@ int add_row(Table *t, const char **input_strings) {
     return 0;
 }
 
+static void free_fold_keys(Column *c) {
+    if (!c->fold_keys) return;
+    for (int r = 0; r < c->fold_key_count; r++) free(c->fold_keys[r]);
+    free(c->fold_keys);
+    c->fold_keys = NULL;
+    c->fold_key_count = 0;
+}
+
+void table_invalidate_fold_keys(Table *t, int col) {
+    if (!t || !t->columns) return;
+    if (col >= 0) {
+        if (col < t->column_count) free_fold_keys(&t->columns[col]);
+        return;
+    }
+    for (int i = 0; i < t->column_count; i++) free_fold_keys(&t->columns[i]);
+}
+
+// Folds every cell of a string column once; later sorts and searches reuse
+// the keys until an edit invalidates them. Returns -1 only when out of memory.
+int table_fold_keys_ensure(Table *t, int col) {
+    if (!t || col < 0 || col >= t->column_count) return 0;
+    Column *c = &t->columns[col];
+    int flags = text_fold_default_flags();
+    if (c->type != TYPE_STR) return 0;
+    if (c->fold_keys && c->fold_key_count == t->row_count && c->fold_flags == flags) return 0;
+    free_fold_keys(c);
+    if (t->row_count == 0) return 0;
+
+    char **keys = calloc((size_t)t->row_count, sizeof(char *));
+    if (!keys) return -1;
+    for (int r = 0; r < t->row_count; r++) {
+        const char *raw = t->rows[r].values ? (const char *)t->rows[r].values[col] : NULL;
+        int oom = 0;
+        keys[r] = text_fold_dup(raw, flags, &oom);
+        if (oom) {
+            for (int i = 0; i < r; i++) free(keys[i]);
+            free(keys);
+            return -1;
+        }
+    }
+    c->fold_keys = keys;
+    c->fold_key_count = t->row_count;
+    c->fold_flags = flags;
+    return 0;
+}
+
+void table_update_fold_key(Table *t, int row, int col) {
+    if (!t || row < 0 || col < 0 || col >= t->column_count) return;
+    Column *c = &t->columns[col];
+    if (!c->fold_keys || row >= c->fold_key_count) return;
+    const char *raw = t->rows[row].values ? (const char *)t->rows[row].values[col] : NULL;
+    int oom = 0;
+    free(c->fold_keys[row]);
+    c->fold_keys[row] = text_fold_dup(raw, c->fold_flags, &oom);
+    if (oom) free_fold_keys(c);
+}
+
+const char *table_fold_key(const Table *t, int row, int col) {
+    if (!t || row < 0 || row >= t->row_count || col < 0 || col >= t->column_count) return NULL;
+    const Column *c = &t->columns[col];
+    if (c->type != TYPE_STR) return NULL;
+    const char *raw = t->rows[row].values ? (const char *)t->rows[row].values[col] : NULL;
+    if (c->fold_keys && row < c->fold_key_count && c->fold_keys[row]) return c->fold_keys[row];
+    return raw;
+}
+
 const char *type_to_string(DataType type) {
     switch (type) {
         case TYPE_INT: return "int";
@@ -4,6 +4,7 @@
 #include <stdio.h>
 
 #include "table_ops.h"
+#include "cell_arena.h"
 
 static void set_err(char *err, size_t err_sz, const char *msg)
 {
@@ -194,8 +195,9 @@ int tableop_set_cell(Table *table, int row, int col, const char *input, char *er
         return -1;
     }
 
-    free(table->rows[row].values[col]);
+    cell_free(table->arena, table->rows[row].values[col]);
     table->rows[row].values[col] = parsed;
+    table_update_fold_key(table, row, col);
     table->dirty = 1;
     return 0;
 }
@@ -206,8 +208,9 @@ int tableop_clear_cell(Table *table, int row, int col, char *err, size_t err_sz)
         set_err(err, err_sz, "Invalid cell");
         return -1;
     }
-    free(table->rows[row].values[col]);
+    cell_free(table->arena, table->rows[row].values[col]);
     table->rows[row].values[col] = NULL;
+    table_update_fold_key(table, row, col);
     table->dirty = 1;
     return 0;
 }
@@ -220,7 +223,7 @@ int tableop_delete_row(Table *table, int row, char *err, size_t err_sz)
     }
     if (table->rows[row].values) {
         for (int c = 0; c < table->column_count; ++c) {
-            free(table->rows[row].values[c]);
+            cell_free(table->arena, table->rows[row].values[c]);
         }
         free(table->rows[row].values);
     }
@@ -228,6 +231,7 @@ int tableop_delete_row(Table *table, int row, char *err, size_t err_sz)
         memmove(&table->rows[row], &table->rows[row + 1], (size_t)(table->row_count - row - 1) * sizeof(Row));
     }
     table->row_count--;
+    table_invalidate_fold_keys(table, -1);
     table->dirty = 1;
     return 0;
 }
@@ -243,6 +247,7 @@ int tableop_delete_column(Table *table, int col, char *err, size_t err_sz)
         return -1;
     }
 
+    table_invalidate_fold_keys(table, col);
     free(table->columns[col].name);
     if (col < table->column_count - 1) {
         memmove(&table->columns[col], &table->columns[col + 1], (size_t)(table->column_count - col - 1) * sizeof(Column));
@@ -255,7 +260,7 @@ int tableop_delete_column(Table *table, int col, char *err, size_t err_sz)
 
     for (int r = 0; r < table->row_count; ++r) {
         if (!table->rows[r].values) continue;
-        free(table->rows[r].values[col]);
+        cell_free(table->arena, table->rows[r].values[col]);
         if (col < table->column_count) {
             memmove(&table->rows[r].values[col],
                     &table->rows[r].values[col + 1],
@@ -308,6 +313,7 @@ int tableop_move_row(Table *table, int src_row, int dst_row, int place_after, ch
     }
 
     table->rows[insert_index] = moved_row;
+    table_invalidate_fold_keys(table, -1);
     table->dirty = 1;
     return 0;
 }
@@ -390,6 +396,7 @@ int tableop_swap_rows(Table *table, int row_a, int row_b, char *err, size_t err_
     tmp = table->rows[row_a];
     table->rows[row_a] = table->rows[row_b];
     table->rows[row_b] = tmp;
+    table_invalidate_fold_keys(table, -1);
     table->dirty = 1;
     return 0;
 }
@@ -470,6 +477,7 @@ int tableop_insert_row_at(Table *table, int row_index, const char **values, char
     }
     table->rows[row_index] = new_row;
     table->row_count++;
+    table_invalidate_fold_keys(table, -1);
     table->dirty = 1;
     return 0;
 }
@@ -572,6 +580,9 @@ int tableop_insert_column_at(Table *table, int col_index, const char *name, Data
     table->columns[col_index].name = name_copy;
     table->columns[col_index].type = type;
     table->columns[col_index].color_pair_id = 0;
+    table->columns[col_index].fold_keys = NULL;
+    table->columns[col_index].fold_key_count = 0;
+    table->columns[col_index].fold_flags = 0;
     table->column_count = new_column_count;
 
     for (int c = col_index; c < table->column_count; ++c) {
@@ -665,12 +676,13 @@ int tableop_change_column_type(Table *table, int col, DataType type, char *err,
     }
 
     for (int r = 0; r < table->row_count; ++r) {
-        free(table->rows[r].values[col]);
+        cell_free(table->arena, table->rows[r].values[col]);
         table->rows[r].values[col] = new_values[r];
     }
     free(new_values);
 
     table->columns[col].type = type;
+    table_invalidate_fold_keys(table, col);
     table->dirty = 1;
     return 0;
 }
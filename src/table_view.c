@@ -4,6 +4,8 @@
 #include <stdio.h>
 
 #include "table_view.h"
+#include "text_regex.h"
+#include "text_fold.h"
 
 typedef struct {
     const Table *table;
@@ -81,30 +83,9 @@ static int cell_to_string(const Table *table, int row, int col, char *buf, size_
     return 0;
 }
 
-static int ci_contains(const char *hay, const char *need)
-{
-    size_t nlen;
-
-    if (!hay || !need) return 0;
-    nlen = strlen(need);
-    if (nlen == 0) return 1;
-
-    for (int pos = 0; hay[pos]; ++pos) {
-        size_t i = 0;
-        while (hay[pos + i] && i < nlen) {
-            char a = hay[pos + i];
-            char b = need[i];
-            if (a >= 'A' && a <= 'Z') a = (char)(a - 'A' + 'a');
-            if (b >= 'A' && b <= 'Z') b = (char)(b - 'A' + 'a');
-            if (a != b) break;
-            i++;
-        }
-        if (i == nlen) return 1;
-    }
-    return 0;
-}
-
-static int row_matches_filter(const Table *table, int row, const FilterRule *rule)
+/* needle_key is rule->value folded with text_fold_default_flags(); string
+   cells compare through the column's cached fold keys. */
+static int row_matches_filter(const Table *table, int row, const FilterRule *rule, TextRegex *re, const char *needle_key)
 {
     char cell_buf[128];
     DataType type;
@@ -114,13 +95,23 @@ static int row_matches_filter(const Table *table, int row, const FilterRule *rul
 
     type = table->columns[rule->col].type;
     if (rule->op == FILTER_CONTAINS) {
-        return ci_contains(cell_buf, rule->value);
+        if (type == TYPE_STR) {
+            const char *key = table_fold_key(table, row, rule->col);
+            return strstr(key ? key : "", needle_key) != NULL;
+        }
+        return text_fold_find(cell_buf, NULL, needle_key, text_fold_default_flags(), NULL, NULL);
+    }
+    if (rule->op == FILTER_REGEX) {
+        return re && text_regex_search(re, cell_buf, NULL, NULL);
     }
 
     if (type == TYPE_STR) {
         int cmp = strcmp(cell_buf, rule->value);
         switch (rule->op) {
-            case FILTER_EQUALS: return strcasecmp(cell_buf, rule->value) == 0;
+            case FILTER_EQUALS: {
+                const char *key = table_fold_key(table, row, rule->col);
+                return strcmp(key ? key : "", needle_key) == 0;
+            }
             case FILTER_GT: return cmp > 0;
             case FILTER_LT: return cmp < 0;
             case FILTER_GTE: return cmp >= 0;
@@ -182,7 +173,8 @@ static int compare_rows(const void *a, const void *b)
                 break;
             }
             case TYPE_STR:
-                cmp = strcasecmp((char *)va, (char *)vb);
+                cmp = strcmp(table_fold_key(table, row_a, col), table_fold_key(table, row_b, col));
+                if (cmp == 0) cmp = strcmp((char *)va, (char *)vb);
                 break;
             default:
                 cmp = 0;
@@ -213,32 +205,43 @@ int tableview_rebuild(Table *table, TableView *view, char *err, size_t err_sz)
 {
     int *map = NULL;
     int count = 0;
+    TextRegex *re = NULL;
+    char needle_key[256] = "";
 
     if (!table || !view) {
         set_err(err, err_sz, "No table view");
         return -1;
     }
 
-    if (!view->filter_active && !view->sort_active) {
+    if ((!view->filter_active && !view->sort_active) || view->pushed_down) {
         free(view->row_map);
         view->row_map = NULL;
         view->row_map_count = 0;
         return 0;
     }
 
-    if (table->row_count > 0) {
-        map = malloc((size_t)table->row_count * sizeof(int));
-        if (!map) {
-            set_err(err, err_sz, "Out of memory");
-            return -1;
-        }
+    if (view->filter_active && view->filter_rule.op == FILTER_REGEX) {
+        re = text_regex_compile(view->filter_rule.value, 1, err, err_sz);
+        if (!re) return -1;
+    }
+
+    if (view->filter_active) {
+        text_fold_into(view->filter_rule.value, text_fold_default_flags(), needle_key, sizeof(needle_key));
+    }
+    if ((view->filter_active && table_fold_keys_ensure(table, view->filter_rule.col) != 0) ||
+        (view->sort_active && table_fold_keys_ensure(table, view->sort_col) != 0) ||
+        (table->row_count > 0 && !(map = malloc((size_t)table->row_count * sizeof(int))))) {
+        text_regex_free(re);
+        set_err(err, err_sz, "Out of memory");
+        return -1;
     }
 
     for (int row = 0; row < table->row_count; ++row) {
-        if (!view->filter_active || row_matches_filter(table, row, &view->filter_rule)) {
+        if (!view->filter_active || row_matches_filter(table, row, &view->filter_rule, re, needle_key)) {
             map[count++] = row;
         }
     }
+    text_regex_free(re);
 
     if (view->sort_active && count > 1) {
         g_sort_ctx.table = table;
@@ -288,7 +291,11 @@ int tableview_apply_filter(Table *table, TableView *view, const FilterRule *rule
     }
 
     type = table->columns[rule->col].type;
-    if (rule->op != FILTER_CONTAINS && type != TYPE_STR) {
+    if (rule->op == FILTER_REGEX) {
+        TextRegex *re = text_regex_compile(rule->value, 1, err, err_sz);
+        if (!re) return -1;
+        text_regex_free(re);
+    } else if (rule->op != FILTER_CONTAINS && type != TYPE_STR) {
         if (parse_numeric_value(type, rule->value, &numeric_value) != 0) {
             set_err(err, err_sz, "Filter value does not match column type");
             return -1;
@@ -312,7 +319,7 @@ void tableview_clear_filter(TableView *view)
 int tableview_row_to_actual(const Table *table, const TableView *view, int visible_row)
 {
     if (!table || visible_row < 0) return -1;
-    if (!view || (!view->filter_active && !view->sort_active)) {
+    if (!view || (!view->filter_active && !view->sort_active) || view->pushed_down) {
         return (visible_row < table->row_count) ? visible_row : -1;
     }
     if (visible_row >= view->row_map_count) return -1;
@@ -322,7 +329,7 @@ int tableview_row_to_actual(const Table *table, const TableView *view, int visib
 int tableview_visible_row_count(const Table *table, const TableView *view)
 {
     if (!table) return 0;
-    if (!view || (!view->filter_active && !view->sort_active)) return table->row_count;
+    if (!view || (!view->filter_active && !view->sort_active) || view->pushed_down) return table->row_count;
     return view->row_map_count;
 }
 
@@ -335,6 +342,7 @@ const char *tableview_filter_op_label(FilterOp op)
         case FILTER_LT: return "<";
         case FILTER_GTE: return ">=";
         case FILTER_LTE: return "<=";
+        case FILTER_REGEX: return "matches";
         default: return "?";
     }
 }
@@ -346,7 +354,8 @@ int tableview_describe(const Table *table, const TableView *view, char *buf, siz
 
     if (!buf || buf_sz == 0 || !table) return -1;
     visible_rows = tableview_visible_row_count(table, view);
-    written = snprintf(buf, buf_sz, "View: %d/%d rows", visible_rows, table->row_count);
+    if (view && view->pushed_down) written = snprintf(buf, buf_sz, "View: database");
+    else written = snprintf(buf, buf_sz, "View: %d/%d rows", visible_rows, table->row_count);
     if (written < 0 || (size_t)written >= buf_sz) return -1;
 
     if (!view || (!view->filter_active && !view->sort_active)) return 0;
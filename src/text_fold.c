@@ -0,0 +1,264 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "text_fold.h"
+
+static int g_default_flags = 0;
+
+/* Base letters for U+00E0..U+00FF and U+0100..U+017F; '.' keeps the
+   letter as is (ligatures, eth, thorn, ...). */
+static const char latin1_bases[] = "aaaaaa.ceeeeiiii.nooooo.ouuuuy.y";
+static const char latin_ext_a_bases[] =
+    "aaaaaa" "cccccccc" "dddd" "eeeeeeeeee" "gggggggg" "hhhh" "iiiiiiiiii"
+    ".." "jj" "kk." "llllllllll" "nnnnnnn" ".." "oooooo" ".." "rrrrrr"
+    "ssssssss" "tttttt" "uuuuuuuuuuuu" "ww" "yyy" "zzzzzz" "s";
+
+_Static_assert(sizeof(latin1_bases) == 0x20 + 1, "latin1_bases covers U+00E0..U+00FF");
+_Static_assert(sizeof(latin_ext_a_bases) == 0x80 + 1, "latin_ext_a_bases covers U+0100..U+017F");
+
+void text_fold_set_default_flags(int flags)
+{
+    g_default_flags = flags;
+}
+
+int text_fold_default_flags(void)
+{
+    return g_default_flags;
+}
+
+/* Decodes one code point; invalid or truncated sequences decode as a
+   single raw byte (*valid = 0) so they are copied through untouched. */
+static size_t utf8_decode(const unsigned char *s, uint32_t *cp, int *valid)
+{
+    size_t len;
+    uint32_t c = s[0];
+
+    *valid = 1;
+    if (c < 0x80) { *cp = c; return 1; }
+    if ((c & 0xE0) == 0xC0) { len = 2; c &= 0x1F; }
+    else if ((c & 0xF0) == 0xE0) { len = 3; c &= 0x0F; }
+    else if ((c & 0xF8) == 0xF0) { len = 4; c &= 0x07; }
+    else { *valid = 0; *cp = s[0]; return 1; }
+
+    for (size_t i = 1; i < len; ++i) {
+        if ((s[i] & 0xC0) != 0x80) { *valid = 0; *cp = s[0]; return 1; }
+        c = (c << 6) | (s[i] & 0x3F);
+    }
+    *cp = c;
+    return len;
+}
+
+static size_t utf8_encode(uint32_t c, char *out)
+{
+    if (c < 0x80) { out[0] = (char)c; return 1; }
+    if (c < 0x800) {
+        out[0] = (char)(0xC0 | (c >> 6));
+        out[1] = (char)(0x80 | (c & 0x3F));
+        return 2;
+    }
+    if (c < 0x10000) {
+        out[0] = (char)(0xE0 | (c >> 12));
+        out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (c & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (c >> 18));
+    out[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (c & 0x3F));
+    return 4;
+}
+
+/* Simple (one-to-one) case folding for the supported blocks. */
+static uint32_t fold_case(uint32_t c)
+{
+    if (c < 0x80) return (c >= 'A' && c <= 'Z') ? c + 32 : c;
+    if (c >= 0xC0 && c <= 0xDE && c != 0xD7) return c + 32;
+    if (c >= 0x100 && c <= 0x17F) {
+        if (c == 0x130) return 'i';
+        if (c == 0x178) return 0xFF;
+        if (c == 0x17F) return 's';
+        if (c <= 0x137 || (c >= 0x14A && c <= 0x177)) return (c == 0x131) ? c : (c | 1);
+        if ((c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E)) return (c & 1) ? c + 1 : c;
+        return c;
+    }
+    if (c >= 0x370 && c <= 0x3FF) {
+        if (c >= 0x391 && c <= 0x3A9 && c != 0x3A2) return c + 32;
+        if (c == 0x386) return 0x3AC;
+        if (c >= 0x388 && c <= 0x38A) return c + 37;
+        if (c == 0x38C) return 0x3CC;
+        if (c == 0x38E || c == 0x38F) return c + 63;
+        if (c == 0x3C2) return 0x3C3;
+        return c;
+    }
+    if (c >= 0x400 && c <= 0x52F) {
+        if (c <= 0x40F) return c + 80;
+        if (c <= 0x42F) return c + 32;
+        if ((c >= 0x460 && c <= 0x481) || (c >= 0x48A && c <= 0x4BF) || (c >= 0x4D0 && c <= 0x52F)) return c | 1;
+        return c;
+    }
+    if ((c >= 0x1E00 && c <= 0x1E95) || (c >= 0x1EA0 && c <= 0x1EFF)) return c | 1;
+    if (c >= 0xFF21 && c <= 0xFF3A) return c + 32;
+    return c;
+}
+
+static uint32_t strip_accent(uint32_t c)
+{
+    char base;
+
+    if (c >= 0xE0 && c <= 0xFF) {
+        base = latin1_bases[c - 0xE0];
+        return base == '.' ? c : (uint32_t)base;
+    }
+    if (c >= 0x100 && c <= 0x17F) {
+        base = latin_ext_a_bases[c - 0x100];
+        return base == '.' ? c : (uint32_t)base;
+    }
+    switch (c) {
+        case 0x3AC: return 0x3B1;
+        case 0x3AD: return 0x3B5;
+        case 0x3AE: return 0x3B7;
+        case 0x3AF: case 0x3CA: case 0x390: return 0x3B9;
+        case 0x3CC: return 0x3BF;
+        case 0x3CD: case 0x3CB: case 0x3B0: return 0x3C5;
+        case 0x3CE: return 0x3C9;
+        case 0x451: return 0x435;
+        default: return c;
+    }
+}
+
+/* Folds the code point at s into out (at most 4 bytes); *consumed gets the
+   raw byte length. Returns the folded byte length (0 for dropped marks). */
+static size_t fold_one(const char *s, int flags, char *out, size_t *consumed)
+{
+    uint32_t c;
+    int valid;
+
+    *consumed = utf8_decode((const unsigned char *)s, &c, &valid);
+    if (!valid) {
+        out[0] = s[0];
+        return 1;
+    }
+    if (c == 0xDF || c == 0x1E9E) {
+        out[0] = 's';
+        out[1] = 's';
+        return 2;
+    }
+    c = fold_case(c);
+    if (flags & TEXT_FOLD_STRIP_ACCENTS) {
+        if (c >= 0x300 && c <= 0x36F) return 0;
+        c = strip_accent(c);
+    }
+    return utf8_encode(c, out);
+}
+
+size_t text_fold_into(const char *text, int flags, char *out, size_t out_sz)
+{
+    size_t total = 0;
+    size_t used = 0;
+    int full = (out_sz == 0);
+
+    if (!text) {
+        if (out && out_sz > 0) out[0] = '\0';
+        return 0;
+    }
+    for (size_t i = 0; text[i]; ) {
+        char tmp[4];
+        size_t consumed;
+        size_t n = fold_one(text + i, flags, tmp, &consumed);
+        if (!full && out && used + n < out_sz) {
+            memcpy(out + used, tmp, n);
+            used += n;
+        } else {
+            full = 1;
+        }
+        total += n;
+        i += consumed;
+    }
+    if (out && out_sz > 0) out[used] = '\0';
+    return total;
+}
+
+char *text_fold_dup(const char *text, int flags, int *out_oom)
+{
+    size_t len;
+    char *key;
+
+    if (out_oom) *out_oom = 0;
+    if (!text) return NULL;
+    len = text_fold_into(text, flags, NULL, 0);
+    key = malloc(len + 1);
+    if (!key) {
+        if (out_oom) *out_oom = 1;
+        return NULL;
+    }
+    text_fold_into(text, flags, key, len + 1);
+    if (strcmp(key, text) == 0) {
+        free(key);
+        return NULL;
+    }
+    return key;
+}
+
+void text_fold_map_range(const char *text, int flags, size_t key_start, size_t key_len,
+                         int *match_start, int *match_len)
+{
+    size_t fp = 0, i = 0;
+    size_t fe = key_start + key_len;
+    int start = -1, end = -1;
+
+    /* Walk the raw text to translate key offsets back to raw offsets. */
+    while (text[i]) {
+        char tmp[4];
+        size_t consumed;
+        size_t n;
+        if (start < 0 && key_len == 0 && fp >= key_start) start = end = (int)i;
+        if (end >= 0) break;
+        n = fold_one(text + i, flags, tmp, &consumed);
+        if (start < 0 && n > 0 && fp + n > key_start) start = (int)i;
+        fp += n;
+        i += consumed;
+        if (start >= 0 && fp >= fe) end = (int)i;
+    }
+    if (start < 0) start = (int)i;
+    if (end < 0) end = (int)i;
+    if (match_start) *match_start = start;
+    if (match_len) *match_len = end - start;
+}
+
+int text_fold_find(const char *text, const char *hay_key, const char *needle_key, int flags,
+                   int *match_start, int *match_len)
+{
+    char stack_key[256];
+    char *owned = NULL;
+    const char *hit;
+    size_t fs;
+
+    if (!text || !needle_key) return 0;
+    if (needle_key[0] == '\0') {
+        if (match_start) *match_start = 0;
+        if (match_len) *match_len = 0;
+        return 1;
+    }
+    if (!hay_key) {
+        size_t len = text_fold_into(text, flags, stack_key, sizeof(stack_key));
+        hay_key = stack_key;
+        if (len >= sizeof(stack_key)) {
+            owned = malloc(len + 1);
+            if (!owned) return 0;
+            text_fold_into(text, flags, owned, len + 1);
+            hay_key = owned;
+        }
+    }
+
+    hit = strstr(hay_key, needle_key);
+    if (!hit) {
+        free(owned);
+        return 0;
+    }
+    fs = (size_t)(hit - hay_key);
+    free(owned);
+    text_fold_map_range(text, flags, fs, strlen(needle_key), match_start, match_len);
+    return 1;
+}
@@ -0,0 +1,887 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "text_fold.h"
+#include "text_regex.h"
+
+#define RX_MAX_NODES 16384
+#define RX_MAX_INSTS 4096
+#define RX_MAX_REPEAT 100
+#define RX_MAX_DEPTH 64
+#define RX_MAX_PREFIX 32
+
+typedef enum {
+    RX_CLASS,
+    RX_SPLIT,
+    RX_JMP,
+    RX_BOL,
+    RX_EOL,
+    RX_MATCH
+} RxOp;
+
+typedef struct {
+    unsigned char op;
+    int x;
+    int y;
+} RxInst;
+
+typedef struct {
+    unsigned char bits[32];
+} RxSet;
+
+typedef struct {
+    int pc;
+    int start;
+} RxThread;
+
+struct TextRegex {
+    RxInst *prog;
+    int prog_len;
+    RxSet *sets;
+    int set_count;
+
+    // Literal bytes every match starts with; used to skip to candidates
+    char prefix[RX_MAX_PREFIX];
+    int prefix_len;
+    int literal;   // whole pattern is the prefix
+    int anchored;  // pattern starts with ^
+    int icase;
+    int fold_flags; // text_fold flags for non-ASCII text when icase
+
+    // Matching scratch (hence one handle per thread)
+    RxThread *clist;
+    RxThread *nlist;
+    int *mark;
+    int gen;
+};
+
+typedef enum {
+    N_SET,
+    N_CAT,
+    N_ALT,
+    N_STAR,
+    N_PLUS,
+    N_QUEST,
+    N_EMPTY,
+    N_BOL,
+    N_EOL
+} RxNodeKind;
+
+typedef struct {
+    RxNodeKind kind;
+    int a;
+    int b;
+    int set;
+    int lit; // byte for plain literal characters, -1 otherwise
+} RxNode;
+
+typedef struct {
+    const char *p;
+    int icase;
+    int depth;
+    RxNode *nodes;
+    int node_count;
+    int node_cap;
+    RxSet *sets;
+    int set_count;
+    int set_cap;
+    int utf8_sets; // index of the first UTF-8 lead/continuation set, or -1
+    RxInst *prog;
+    int prog_len;
+    char *err;
+    size_t err_sz;
+    int failed;
+} RxParser;
+
+static void set_err(char *err, size_t err_sz, const char *msg)
+{
+    if (!err || err_sz == 0 || !msg) return;
+    strncpy(err, msg, err_sz - 1);
+    err[err_sz - 1] = '\0';
+}
+
+static void fail(RxParser *ps, const char *msg)
+{
+    if (ps->failed) return;
+    ps->failed = 1;
+    set_err(ps->err, ps->err_sz, msg);
+}
+
+static int lower_ascii(int c)
+{
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+static int upper_ascii(int c)
+{
+    return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c;
+}
+
+/* --------------------------
+   Parser (pattern -> AST)
+   -------------------------- */
+
+static int new_set(RxParser *ps)
+{
+    if (ps->set_count == ps->set_cap) {
+        int cap = ps->set_cap ? ps->set_cap * 2 : 16;
+        RxSet *grown = realloc(ps->sets, (size_t)cap * sizeof(RxSet));
+        if (!grown) { fail(ps, "Out of memory"); return -1; }
+        ps->sets = grown;
+        ps->set_cap = cap;
+    }
+    memset(&ps->sets[ps->set_count], 0, sizeof(RxSet));
+    return ps->set_count++;
+}
+
+static void set_add(RxParser *ps, int set, int c)
+{
+    RxSet *s = &ps->sets[set];
+    c &= 0xff;
+    s->bits[c >> 3] |= (unsigned char)(1u << (c & 7));
+    if (ps->icase) {
+        int l = lower_ascii(c);
+        int u = upper_ascii(c);
+        s->bits[l >> 3] |= (unsigned char)(1u << (l & 7));
+        s->bits[u >> 3] |= (unsigned char)(1u << (u & 7));
+    }
+}
+
+static void set_add_range(RxParser *ps, int set, int lo, int hi)
+{
+    for (int c = lo; c <= hi; ++c) set_add(ps, set, c);
+}
+
+static int set_has(const RxSet *s, int c)
+{
+    return (s->bits[c >> 3] >> (c & 7)) & 1;
+}
+
+static int new_node(RxParser *ps, RxNodeKind kind, int a, int b)
+{
+    if (ps->failed) return -1;
+    if (ps->node_count == ps->node_cap) {
+        if (ps->node_cap >= RX_MAX_NODES) { fail(ps, "Pattern too complex"); return -1; }
+        int cap = ps->node_cap ? ps->node_cap * 2 : 64;
+        RxNode *grown = realloc(ps->nodes, (size_t)cap * sizeof(RxNode));
+        if (!grown) { fail(ps, "Out of memory"); return -1; }
+        ps->nodes = grown;
+        ps->node_cap = cap;
+    }
+    RxNode *n = &ps->nodes[ps->node_count];
+    n->kind = kind;
+    n->a = a;
+    n->b = b;
+    n->set = -1;
+    n->lit = -1;
+    return ps->node_count++;
+}
+
+static int set_node(RxParser *ps, int set)
+{
+    int idx = new_node(ps, N_SET, -1, -1);
+    if (idx >= 0) ps->nodes[idx].set = set;
+    return idx;
+}
+
+static int literal_node(RxParser *ps, int c)
+{
+    int set = new_set(ps);
+    if (set < 0) return -1;
+    set_add(ps, set, c);
+    int idx = set_node(ps, set);
+    if (idx >= 0) ps->nodes[idx].lit = ps->icase ? lower_ascii(c & 0xff) : (c & 0xff);
+    return idx;
+}
+
+static int cat_node(RxParser *ps, int a, int b)
+{
+    if (a < 0) return b;
+    return new_node(ps, N_CAT, a, b);
+}
+
+/* One code point whose ASCII form must be in ascii_set, or any non-ASCII
+   UTF-8 sequence; keeps '.' and [^...] from splitting multi-byte chars. */
+static int utf8_any_node(RxParser *ps, int ascii_set)
+{
+    if (ps->utf8_sets < 0) {
+        int lead2 = new_set(ps), lead3 = new_set(ps), lead4 = new_set(ps), cont = new_set(ps);
+        if (cont < 0) return -1;
+        int icase = ps->icase;
+        ps->icase = 0;
+        set_add_range(ps, lead2, 0xc2, 0xdf);
+        set_add_range(ps, lead3, 0xe0, 0xef);
+        set_add_range(ps, lead4, 0xf0, 0xf4);
+        set_add_range(ps, cont, 0x80, 0xbf);
+        ps->icase = icase;
+        ps->utf8_sets = lead2;
+    }
+    int cont = set_node(ps, ps->utf8_sets + 3);
+    int two = cat_node(ps, set_node(ps, ps->utf8_sets), cont);
+    int three = cat_node(ps, cat_node(ps, set_node(ps, ps->utf8_sets + 1), cont), cont);
+    int four = cat_node(ps, cat_node(ps, cat_node(ps, set_node(ps, ps->utf8_sets + 2), cont), cont), cont);
+    int multi = new_node(ps, N_ALT, two, new_node(ps, N_ALT, three, four));
+    return new_node(ps, N_ALT, set_node(ps, ascii_set), multi);
+}
+
+static void add_escape_class(RxParser *ps, int set, char e)
+{
+    switch (e) {
+        case 'd':
+            set_add_range(ps, set, '0', '9');
+            break;
+        case 'w':
+            set_add_range(ps, set, 'a', 'z');
+            set_add_range(ps, set, 'A', 'Z');
+            set_add_range(ps, set, '0', '9');
+            set_add(ps, set, '_');
+            break;
+        case 's':
+            set_add(ps, set, ' ');
+            set_add_range(ps, set, '\t', '\r');
+            break;
+        default:
+            break;
+    }
+}
+
+static int is_class_escape(char e)
+{
+    return e == 'd' || e == 'w' || e == 's' || e == 'D' || e == 'W' || e == 'S';
+}
+
+static int escape_byte(char e)
+{
+    switch (e) {
+        case 't': return '\t';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        default: return (unsigned char)e;
+    }
+}
+
+static void complement_ascii(RxParser *ps, int dst, const RxSet *src)
+{
+    int icase = ps->icase;
+    ps->icase = 0;
+    for (int c = 0; c < 0x80; ++c) {
+        if (!set_has(src, c)) set_add(ps, dst, c);
+    }
+    ps->icase = icase;
+}
+
+static int parse_class(RxParser *ps)
+{
+    int negate = 0;
+    int set = new_set(ps);
+    if (set < 0) return -1;
+
+    if (*ps->p == '^') { negate = 1; ps->p++; }
+    int first = 1;
+    while (*ps->p && (*ps->p != ']' || first)) {
+        int lo;
+        first = 0;
+        if (*ps->p == '\\' && ps->p[1]) {
+            char e = ps->p[1];
+            ps->p += 2;
+            if (is_class_escape(e)) {
+                if (e >= 'a') {
+                    add_escape_class(ps, set, e);
+                } else {
+                    RxSet tmp;
+                    int t = new_set(ps);
+                    if (t < 0) return -1;
+                    add_escape_class(ps, t, (char)lower_ascii(e));
+                    tmp = ps->sets[t];
+                    complement_ascii(ps, set, &tmp);
+                }
+                continue;
+            }
+            lo = escape_byte(e);
+        } else {
+            lo = (unsigned char)*ps->p++;
+        }
+        if (*ps->p == '-' && ps->p[1] && ps->p[1] != ']') {
+            int hi;
+            ps->p++;
+            if (*ps->p == '\\' && ps->p[1]) {
+                hi = escape_byte(ps->p[1]);
+                ps->p += 2;
+            } else {
+                hi = (unsigned char)*ps->p++;
+            }
+            if (hi < lo) { fail(ps, "Invalid class range"); return -1; }
+            set_add_range(ps, set, lo, hi);
+        } else {
+            set_add(ps, set, lo);
+        }
+    }
+    if (*ps->p != ']') { fail(ps, "Missing ]"); return -1; }
+    ps->p++;
+
+    if (!negate) return set_node(ps, set);
+    int ascii = new_set(ps);
+    if (ascii < 0) return -1;
+    RxSet tmp = ps->sets[set];
+    complement_ascii(ps, ascii, &tmp);
+    return utf8_any_node(ps, ascii);
+}
+
+static int parse_alt(RxParser *ps);
+
+static int parse_atom(RxParser *ps)
+{
+    char c = *ps->p;
+
+    if (c == '(') {
+        ps->p++;
+        if (ps->p[0] == '?' && ps->p[1] == ':') ps->p += 2;
+        if (++ps->depth > RX_MAX_DEPTH) { fail(ps, "Pattern nested too deeply"); return -1; }
+        int inner = parse_alt(ps);
+        ps->depth--;
+        if (ps->failed) return -1;
+        if (*ps->p != ')') { fail(ps, "Missing )"); return -1; }
+        ps->p++;
+        return inner;
+    }
+    if (c == '[') {
+        ps->p++;
+        return parse_class(ps);
+    }
+    if (c == '.') {
+        ps->p++;
+        int ascii = new_set(ps);
+        if (ascii < 0) return -1;
+        int icase = ps->icase;
+        ps->icase = 0;
+        set_add_range(ps, ascii, 0x00, 0x7f);
+        ps->sets[ascii].bits['\n' >> 3] &= (unsigned char)~(1u << ('\n' & 7));
+        ps->icase = icase;
+        return utf8_any_node(ps, ascii);
+    }
+    if (c == '^') { ps->p++; return new_node(ps, N_BOL, -1, -1); }
+    if (c == '$') { ps->p++; return new_node(ps, N_EOL, -1, -1); }
+    if (c == '*' || c == '+' || c == '?') {
+        fail(ps, "Nothing to repeat");
+        return -1;
+    }
+    if (c == '\\') {
+        char e = ps->p[1];
+        if (!e) { fail(ps, "Trailing backslash"); return -1; }
+        ps->p += 2;
+        if (is_class_escape(e)) {
+            int set = new_set(ps);
+            if (set < 0) return -1;
+            if (e >= 'a') {
+                add_escape_class(ps, set, e);
+                return set_node(ps, set);
+            }
+            add_escape_class(ps, set, (char)lower_ascii(e));
+            int ascii = new_set(ps);
+            if (ascii < 0) return -1;
+            RxSet tmp = ps->sets[set];
+            complement_ascii(ps, ascii, &tmp);
+            return utf8_any_node(ps, ascii);
+        }
+        return literal_node(ps, escape_byte(e));
+    }
+    ps->p++;
+    int out = literal_node(ps, (unsigned char)c);
+    // A multi-byte char is one atom, so a repeat covers all of its bytes
+    if ((unsigned char)c >= 0xc0) {
+        while (((unsigned char)*ps->p & 0xc0) == 0x80) {
+            out = cat_node(ps, out, literal_node(ps, (unsigned char)*ps->p));
+            ps->p++;
+        }
+    }
+    return out;
+}
+
+static int clone_node(RxParser *ps, int idx)
+{
+    if (idx < 0 || ps->failed) return -1;
+    RxNode n = ps->nodes[idx];
+    int a = (n.a >= 0) ? clone_node(ps, n.a) : -1;
+    int b = (n.b >= 0) ? clone_node(ps, n.b) : -1;
+    int copy = new_node(ps, n.kind, a, b);
+    if (copy >= 0) {
+        ps->nodes[copy].set = n.set;
+        ps->nodes[copy].lit = n.lit;
+    }
+    return copy;
+}
+
+// Parses "{m}", "{m,}" or "{m,n}"; returns 0 and leaves p untouched otherwise.
+static int parse_bounds(RxParser *ps, int *min, int *max)
+{
+    const char *p = ps->p + 1;
+    int lo = 0, hi;
+    if (*p < '0' || *p > '9') return 0;
+    while (*p >= '0' && *p <= '9') { lo = lo * 10 + (*p - '0'); if (lo > RX_MAX_REPEAT) lo = RX_MAX_REPEAT + 1; p++; }
+    hi = lo;
+    if (*p == ',') {
+        p++;
+        if (*p == '}') {
+            hi = -1;
+        } else {
+            if (*p < '0' || *p > '9') return 0;
+            hi = 0;
+            while (*p >= '0' && *p <= '9') { hi = hi * 10 + (*p - '0'); if (hi > RX_MAX_REPEAT) hi = RX_MAX_REPEAT + 1; p++; }
+        }
+    }
+    if (*p != '}') return 0;
+    ps->p = p + 1;
+    *min = lo;
+    *max = hi;
+    return 1;
+}
+
+static int expand_repeat(RxParser *ps, int atom, int min, int max)
+{
+    int out = -1;
+
+    if (min > RX_MAX_REPEAT || max > RX_MAX_REPEAT) { fail(ps, "Repeat count too large"); return -1; }
+    if (max >= 0 && max < min) { fail(ps, "Invalid repeat range"); return -1; }
+    for (int i = 0; i < min; ++i) {
+        out = cat_node(ps, out, i == 0 ? atom : clone_node(ps, atom));
+    }
+    if (max < 0) {
+        int star = new_node(ps, N_STAR, min == 0 ? atom : clone_node(ps, atom), -1);
+        return cat_node(ps, out, star);
+    }
+    // Optional tail nests so x{0,3} is (x(x(x)?)?)?
+    int tail = -1;
+    for (int i = max - min; i > 0; --i) {
+        int part = (min == 0 && i == 1) ? atom : clone_node(ps, atom);
+        tail = new_node(ps, N_QUEST, cat_node(ps, part, tail), -1);
+    }
+    if (out < 0 && tail < 0) return new_node(ps, N_EMPTY, -1, -1);
+    if (tail < 0) return out;
+    return cat_node(ps, out, tail);
+}
+
+static int parse_repeat(RxParser *ps)
+{
+    int atom = parse_atom(ps);
+    while (!ps->failed) {
+        char c = *ps->p;
+        int min, max;
+        if (c == '*') { ps->p++; atom = new_node(ps, N_STAR, atom, -1); }
+        else if (c == '+') { ps->p++; atom = new_node(ps, N_PLUS, atom, -1); }
+        else if (c == '?') { ps->p++; atom = new_node(ps, N_QUEST, atom, -1); }
+        else if (c == '{' && parse_bounds(ps, &min, &max)) atom = expand_repeat(ps, atom, min, max);
+        else break;
+    }
+    return atom;
+}
+
+static int parse_cat(RxParser *ps)
+{
+    int out = -1;
+    while (!ps->failed && *ps->p && *ps->p != '|' && *ps->p != ')') {
+        out = cat_node(ps, out, parse_repeat(ps));
+    }
+    if (out < 0 && !ps->failed) out = new_node(ps, N_EMPTY, -1, -1);
+    return out;
+}
+
+static int parse_alt(RxParser *ps)
+{
+    int out = parse_cat(ps);
+    while (!ps->failed && *ps->p == '|') {
+        ps->p++;
+        out = new_node(ps, N_ALT, out, parse_cat(ps));
+    }
+    return out;
+}
+
+/* --------------------------
+   Compiler (AST -> program)
+   -------------------------- */
+
+static int emit(RxParser *ps, RxOp op, int x, int y)
+{
+    if (ps->failed) return -1;
+    if (ps->prog_len >= RX_MAX_INSTS) { fail(ps, "Pattern too complex"); return -1; }
+    if (ps->prog_len % 256 == 0) {
+        RxInst *grown = realloc(ps->prog, (size_t)(ps->prog_len + 256) * sizeof(RxInst));
+        if (!grown) { fail(ps, "Out of memory"); return -1; }
+        ps->prog = grown;
+    }
+    ps->prog[ps->prog_len].op = (unsigned char)op;
+    ps->prog[ps->prog_len].x = x;
+    ps->prog[ps->prog_len].y = y;
+    return ps->prog_len++;
+}
+
+static void compile_node(RxParser *ps, int idx)
+{
+    if (ps->failed || idx < 0) return;
+    const RxNode n = ps->nodes[idx];
+    int l1, l2;
+
+    switch (n.kind) {
+        case N_SET:
+            emit(ps, RX_CLASS, n.set, 0);
+            break;
+        case N_CAT:
+            compile_node(ps, n.a);
+            compile_node(ps, n.b);
+            break;
+        case N_ALT:
+            l1 = emit(ps, RX_SPLIT, 0, 0);
+            compile_node(ps, n.a);
+            l2 = emit(ps, RX_JMP, 0, 0);
+            if (ps->failed) return;
+            ps->prog[l1].x = l1 + 1;
+            ps->prog[l1].y = ps->prog_len;
+            compile_node(ps, n.b);
+            if (!ps->failed) ps->prog[l2].x = ps->prog_len;
+            break;
+        case N_STAR:
+            l1 = emit(ps, RX_SPLIT, 0, 0);
+            compile_node(ps, n.a);
+            emit(ps, RX_JMP, l1, 0);
+            if (ps->failed) return;
+            ps->prog[l1].x = l1 + 1;
+            ps->prog[l1].y = ps->prog_len;
+            break;
+        case N_PLUS:
+            l1 = ps->prog_len;
+            compile_node(ps, n.a);
+            l2 = emit(ps, RX_SPLIT, l1, 0);
+            if (!ps->failed) ps->prog[l2].y = ps->prog_len;
+            break;
+        case N_QUEST:
+            l1 = emit(ps, RX_SPLIT, 0, 0);
+            compile_node(ps, n.a);
+            if (ps->failed) return;
+            ps->prog[l1].x = l1 + 1;
+            ps->prog[l1].y = ps->prog_len;
+            break;
+        case N_BOL:
+            emit(ps, RX_BOL, 0, 0);
+            break;
+        case N_EOL:
+            emit(ps, RX_EOL, 0, 0);
+            break;
+        case N_EMPTY:
+        default:
+            break;
+    }
+}
+
+// Returns 1 while every node seen so far is a literal byte (or a leading ^).
+static int collect_prefix(const RxParser *ps, int idx, TextRegex *re)
+{
+    const RxNode *n = &ps->nodes[idx];
+
+    switch (n->kind) {
+        case N_CAT:
+            return collect_prefix(ps, n->a, re) && collect_prefix(ps, n->b, re);
+        case N_EMPTY:
+            return 1;
+        case N_BOL:
+            if (re->prefix_len == 0 && !re->anchored) { re->anchored = 1; return 1; }
+            return 0;
+        case N_SET:
+            if (n->lit < 0 || re->prefix_len >= RX_MAX_PREFIX) return 0;
+            re->prefix[re->prefix_len++] = (char)n->lit;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* Folds the non-ASCII runs of a pattern so its literals compare against
+   folded text; ASCII (and so every escape and class syntax) is kept as is
+   and left to the sets. A backslash before a non-ASCII char is dropped. */
+static char *fold_pattern(const char *pattern, int flags)
+{
+    size_t len = strlen(pattern);
+    size_t cap = len + 1, used = 0;
+    char *out = malloc(cap);
+    char *run = malloc(len + 1);
+
+    if (!out || !run) {
+        free(out);
+        free(run);
+        return NULL;
+    }
+    for (size_t i = 0; pattern[i]; ) {
+        unsigned char c = (unsigned char)pattern[i];
+        if (c == '\\' && pattern[i + 1] && !((unsigned char)pattern[i + 1] & 0x80)) {
+            out[used++] = pattern[i++];
+            out[used++] = pattern[i++];
+        } else if (c == '\\' && pattern[i + 1]) {
+            i++;
+        } else if (c < 0x80) {
+            out[used++] = pattern[i++];
+        } else {
+            size_t n = 0, folded;
+            while (pattern[i] && ((unsigned char)pattern[i] & 0x80)) run[n++] = pattern[i++];
+            run[n] = '\0';
+            folded = text_fold_into(run, flags, NULL, 0);
+            if (used + folded + (len - i) + 1 > cap) {
+                char *grown;
+                cap = used + folded + (len - i) + 1;
+                grown = realloc(out, cap);
+                if (!grown) {
+                    free(out);
+                    free(run);
+                    return NULL;
+                }
+                out = grown;
+            }
+            used += text_fold_into(run, flags, out + used, cap - used);
+        }
+    }
+    out[used] = '\0';
+    free(run);
+    return out;
+}
+
+TextRegex *text_regex_compile(const char *pattern, int icase, char *err, size_t err_sz)
+{
+    RxParser ps;
+    TextRegex *re;
+    char *folded = NULL;
+    int fold_flags = text_fold_default_flags();
+    int root;
+
+    if (!pattern) {
+        set_err(err, err_sz, "Missing pattern");
+        return NULL;
+    }
+    if (icase) {
+        folded = fold_pattern(pattern, fold_flags);
+        if (!folded) {
+            set_err(err, err_sz, "Out of memory");
+            return NULL;
+        }
+        pattern = folded;
+    }
+    memset(&ps, 0, sizeof(ps));
+    ps.p = pattern;
+    ps.icase = icase ? 1 : 0;
+    ps.utf8_sets = -1;
+    ps.err = err;
+    ps.err_sz = err_sz;
+
+    root = parse_alt(&ps);
+    if (!ps.failed && *ps.p == ')') fail(&ps, "Unmatched )");
+    if (!ps.failed) {
+        compile_node(&ps, root);
+        emit(&ps, RX_MATCH, 0, 0);
+    }
+    free(folded);
+    re = ps.failed ? NULL : calloc(1, sizeof(*re));
+    if (!ps.failed && !re) fail(&ps, "Out of memory");
+    if (ps.failed) {
+        free(ps.nodes);
+        free(ps.sets);
+        free(ps.prog);
+        free(re);
+        return NULL;
+    }
+
+    re->icase = ps.icase;
+    re->fold_flags = fold_flags;
+    re->literal = collect_prefix(&ps, root, re) && !re->anchored && re->prefix_len > 0;
+    re->prog = ps.prog;
+    re->prog_len = ps.prog_len;
+    re->sets = ps.sets;
+    re->set_count = ps.set_count;
+    free(ps.nodes);
+
+    re->clist = malloc((size_t)re->prog_len * sizeof(RxThread));
+    re->nlist = malloc((size_t)re->prog_len * sizeof(RxThread));
+    re->mark = calloc((size_t)re->prog_len, sizeof(int));
+    if (!re->clist || !re->nlist || !re->mark) {
+        text_regex_free(re);
+        set_err(err, err_sz, "Out of memory");
+        return NULL;
+    }
+    return re;
+}
+
+void text_regex_free(TextRegex *re)
+{
+    if (!re) return;
+    free(re->prog);
+    free(re->sets);
+    free(re->clist);
+    free(re->nlist);
+    free(re->mark);
+    free(re);
+}
+
+/* --------------------------
+   Matching
+   -------------------------- */
+
+static int prefix_at(const TextRegex *re, const char *text, size_t pos)
+{
+    for (int i = 1; i < re->prefix_len; ++i) {
+        int c = (unsigned char)text[pos + (size_t)i];
+        if (re->icase) c = lower_ascii(c);
+        if (c != (unsigned char)re->prefix[i]) return 0;
+    }
+    return 1;
+}
+
+// Next offset >= from where the literal prefix occurs, or -1.
+static long find_prefix(const TextRegex *re, const char *text, size_t len, size_t from)
+{
+    int first = (unsigned char)re->prefix[0];
+    int alt = re->icase ? upper_ascii(first) : first;
+
+    while (from + (size_t)re->prefix_len <= len) {
+        const char *hit = memchr(text + from, first, len - from);
+        if (alt != first) {
+            const char *hit2 = memchr(text + from, alt, hit ? (size_t)(hit - (text + from)) : len - from);
+            if (hit2) hit = hit2;
+        }
+        if (!hit) return -1;
+        size_t pos = (size_t)(hit - text);
+        if (pos + (size_t)re->prefix_len > len) return -1;
+        if (prefix_at(re, text, pos)) return (long)pos;
+        from = pos + 1;
+    }
+    return -1;
+}
+
+static int next_gen(TextRegex *re)
+{
+    if (re->gen == INT_MAX) {
+        memset(re->mark, 0, (size_t)re->prog_len * sizeof(int));
+        re->gen = 0;
+    }
+    return ++re->gen;
+}
+
+static void add_thread(TextRegex *re, RxThread *list, int *n, int gen, int pc, int start, size_t pos, size_t len)
+{
+    if (re->mark[pc] == gen) return;
+    re->mark[pc] = gen;
+    switch (re->prog[pc].op) {
+        case RX_JMP:
+            add_thread(re, list, n, gen, re->prog[pc].x, start, pos, len);
+            break;
+        case RX_SPLIT:
+            add_thread(re, list, n, gen, re->prog[pc].x, start, pos, len);
+            add_thread(re, list, n, gen, re->prog[pc].y, start, pos, len);
+            break;
+        case RX_BOL:
+            if (pos == 0) add_thread(re, list, n, gen, pc + 1, start, pos, len);
+            break;
+        case RX_EOL:
+            if (pos == len) add_thread(re, list, n, gen, pc + 1, start, pos, len);
+            break;
+        default:
+            list[(*n)++] = (RxThread){ pc, start };
+            break;
+    }
+}
+
+static int search_bytes(TextRegex *re, const char *text, int *match_start, int *match_len)
+{
+    size_t len, pos = 0;
+    long cand = -1;
+    int use_prefix;
+    int nc = 0;
+    int cur_gen;
+    long best_start = -1;
+    size_t best_end = 0;
+
+    len = strlen(text);
+    use_prefix = re->prefix_len > 0 && !re->anchored;
+
+    if (use_prefix) {
+        cand = find_prefix(re, text, len, 0);
+        if (cand < 0) return 0;
+        if (re->literal) {
+            if (match_start) *match_start = (int)cand;
+            if (match_len) *match_len = re->prefix_len;
+            return 1;
+        }
+        pos = (size_t)cand;
+    }
+
+    cur_gen = next_gen(re);
+    for (;;) {
+        // Seed a new thread here unless a match already fixed the start
+        if (best_start < 0 && (!re->anchored || pos == 0) && (!use_prefix || (long)pos == cand)) {
+            add_thread(re, re->clist, &nc, cur_gen, 0, (int)pos, pos, len);
+            if (use_prefix) cand = find_prefix(re, text, len, pos + 1);
+        }
+        if (nc == 0) {
+            if (best_start >= 0 || pos >= len || re->anchored) break;
+            if (use_prefix) {
+                if (cand < 0) break;
+                pos = (size_t)cand; // skip straight to the next candidate
+                cur_gen = next_gen(re);
+                continue;
+            }
+        }
+
+        int nn = 0;
+        int gen = next_gen(re);
+        for (int i = 0; i < nc; ++i) {
+            RxThread t = re->clist[i];
+            const RxInst *inst = &re->prog[t.pc];
+            if (best_start >= 0 && t.start > best_start) continue;
+            if (inst->op == RX_MATCH) {
+                if (best_start < 0 || t.start < best_start || pos > best_end) {
+                    best_start = t.start;
+                    best_end = pos;
+                }
+            } else if (inst->op == RX_CLASS && pos < len &&
+                       set_has(&re->sets[inst->x], (unsigned char)text[pos])) {
+                add_thread(re, re->nlist, &nn, gen, t.pc + 1, t.start, pos + 1, len);
+            }
+        }
+        if (pos >= len) break;
+
+        RxThread *swap = re->clist;
+        re->clist = re->nlist;
+        re->nlist = swap;
+        nc = nn;
+        cur_gen = gen;
+        pos++;
+    }
+
+    if (best_start < 0) return 0;
+    if (match_start) *match_start = (int)best_start;
+    if (match_len) *match_len = (int)(best_end - (size_t)best_start);
+    return 1;
+}
+
+int text_regex_search(TextRegex *re, const char *text, int *match_start, int *match_len)
+{
+    char stack_key[256];
+    char *key = stack_key;
+    size_t len;
+    int start, mlen, found;
+
+    if (!re || !text) return 0;
+    if (!re->icase) return search_bytes(re, text, match_start, match_len);
+
+    // ASCII case is handled by the sets; only non-ASCII text needs folding
+    const char *p = text;
+    while (*p && !((unsigned char)*p & 0x80)) p++;
+    if (!*p) return search_bytes(re, text, match_start, match_len);
+
+    len = text_fold_into(text, re->fold_flags, stack_key, sizeof(stack_key));
+    if (len >= sizeof(stack_key)) {
+        key = malloc(len + 1);
+        if (!key) return 0;
+        text_fold_into(text, re->fold_flags, key, len + 1);
+    }
+    found = search_bytes(re, key, &start, &mlen);
+    if (key != stack_key) free(key);
+    if (!found) return 0;
+    text_fold_map_range(text, re->fold_flags, (size_t)start, (size_t)mlen, match_start, match_len);
+    return 1;
+}
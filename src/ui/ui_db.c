@@ -10,6 +10,7 @@
 #include "db_manager.h"
 #include "workspace.h"
 #include "ui.h"
+#include "mem_budget.h"
 
 // Active DB connection managed via db_manager singleton helpers
 
@@ -258,10 +259,13 @@ void show_db_manager(Table *table) {
             const char **items = (const char**)tables; int pick = 0;
             draw_list_modal("Select table to load", items, tcount, &pick);
             if (pick >= 0) {
-                if (low_ram_mode) {
+                int use_seek = low_ram_mode ||
+                               (low_ram_auto && !mem_budget_fits(db_estimate_table_bytes(cur, tables[pick])));
+                if (use_seek) {
                     // Low-RAM seek-only view over selected table
                     const char *db_path = db_current_path(cur);
                     int page = 200; // initial default; UI will recompute per screen
+                    ui_reset_table_view(table);
                     if (seek_mode_open_for_table(db_path, tables[pick], table, page, err, sizeof(err)) != 0) {
                         show_error_message(err[0] ? err : "Seek view failed");
                     } else {
@@ -271,6 +275,7 @@ void show_db_manager(Table *table) {
                     Table *loaded = db_load_table(cur, tables[pick], err, sizeof(err));
                     if (!loaded) { show_error_message(err[0] ? err : "Load failed"); }
                     else if (table) {
+                        seek_mode_close();
                         replace_table_contents(table, loaded);
                         workspace_manual_save(table, NULL, 0);
                         db_autosave_table(table, err, sizeof(err));
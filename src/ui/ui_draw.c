@@ -149,6 +149,30 @@ static void draw_footer_separator(int y, int *x, int max_x)
     draw_status_segment(y, x, max_x, COLOR_PAIR(8) | A_BOLD, "  |  ");
 }
 
+// Row page label. In seek mode pages count through the whole view, not the
+// loaded window; its total reads "~" while estimated and "?" until counted.
+static void format_row_pages(char *buf, size_t buf_sz)
+{
+    if (seek_mode_active()) {
+        int exact = 0;
+        int page_rows = (rows_visible > 0) ? rows_visible : 1;
+        long long first = seek_mode_row_base() + (long long)row_page * page_rows;
+        long long page = (first - 1) / page_rows + 1;
+        long long total = seek_mode_row_count(&exact);
+        long long pages;
+
+        if (total < 0) {
+            snprintf(buf, buf_sz, "Rows Pg %lld/?", page);
+            return;
+        }
+        pages = (total + page_rows - 1) / page_rows;
+        if (pages < page) pages = page;
+        snprintf(buf, buf_sz, "Rows Pg %lld/%s%lld", page, exact ? "" : "~", pages);
+        return;
+    }
+    snprintf(buf, buf_sz, "Rows Pg %d/%d", row_page + 1, total_row_pages);
+}
+
 static void draw_footer_box(void)
 {
     int left = 1;
@@ -170,6 +194,24 @@ static void draw_footer_box(void)
     attroff(COLOR_PAIR(6));
 }
 
+// Last measured width of each column in seek mode. Columns the window did
+// not fetch keep it, so column pages do not shift as the fetched range moves.
+static int *seek_col_widths = NULL;
+static int seek_col_width_count = 0;
+
+static int seek_column_width(int col, int measured, int column_count) {
+    if (seek_col_width_count != column_count) {
+        int *w = realloc(seek_col_widths, sizeof(int) * (size_t)column_count);
+        if (!w) return measured;
+        for (int j = 0; j < column_count; ++j) w[j] = 0;
+        seek_col_widths = w;
+        seek_col_width_count = column_count;
+    }
+    if (seek_mode_column_loaded(col)) seek_col_widths[col] = measured;
+    else if (seek_col_widths[col] > measured) measured = seek_col_widths[col];
+    return measured;
+}
+
 void draw_table_grid(Table *t) {
     int visible_row_count = ui_visible_row_count(t);
 
@@ -207,6 +249,7 @@ void draw_table_grid(Table *t) {
             int len = ui_text_width(buf) + 2;
             if (len > max) max = len;
         }
+        if (seek_mode_active()) max = seek_column_width(j, max, t->column_count);
         col_widths[j] = max;
     }
 
@@ -517,36 +560,44 @@ void draw_ui(Table *table) {
         draw_action_hint_segment(fy, &fx, max_x, "[←][→][↑][↓] Prev/Next Match");
         draw_footer_separator(fy, &fx, max_x);
         draw_action_hint_segment(fy, &fx, max_x, "[Esc] Exit Search");
-        extern int search_hit_index; extern int search_hit_count;
         {
             char match_buf[64];
             draw_footer_separator(fy, &fx, max_x);
-            snprintf(match_buf, sizeof(match_buf), "Matches %d/%d", (search_hit_count > 0 ? (search_hit_index + 1) : 0), search_hit_count);
+            if (search_db_wide) {
+                snprintf(match_buf, sizeof(match_buf), "Rows matching %d", search_hit_count);
+            } else if (search_hit_index >= 0) {
+                snprintf(match_buf, sizeof(match_buf), "Matches %d/%d%s", search_hit_index + 1, search_hit_count,
+                         search_count_done ? "" : "+");
+            } else {
+                snprintf(match_buf, sizeof(match_buf), "Matches ?/%d%s", search_hit_count, search_count_done ? "" : "+");
+            }
             draw_status_segment(fy, &fx, max_x, COLOR_PAIR(4), match_buf);
         }
     } else if (!editing_mode) {
         draw_action_hint_segment(fy, &fx, max_x, "[C] Add Column  [R] Add Row");
         draw_footer_separator(fy, &fx, max_x);
-        draw_action_hint_segment(fy, &fx, max_x, "[F] Search  [E] Edit Mode");
+        draw_action_hint_segment(fy, &fx, max_x, "[F] Search  [/] Regex  [E] Edit Mode");
         draw_footer_separator(fy, &fx, max_x);
         draw_action_hint_segment(fy, &fx, max_x, "[M] Menu  [S] Save  [Q] Quit");
         draw_footer_separator(fy, &fx, max_x);
-        draw_action_hint_segment(fy, &fx, max_x, "[Ctrl+H] Top-Left");
+        draw_action_hint_segment(fy, &fx, max_x, "[Ctrl+H] Top-Left  [G] Go to Row");
         if (ui_visible_row_count(table) == 0 && ui_table_view_is_active()) {
             draw_footer_separator(fy, &fx, max_x);
             draw_status_segment(fy, &fx, max_x, COLOR_PAIR(10) | A_BOLD, "0 results");
         }
-        if (total_pages > 1 || total_row_pages > 1) {
+        if (total_pages > 1 || total_row_pages > 1 || seek_mode_active()) {
             if (total_pages > 1) {
                 char buf[64];
                 draw_footer_separator(fy, &fx, max_x);
                 snprintf(buf, sizeof(buf), "Cols Pg %d/%d [←][→] Columns", col_page + 1, total_pages);
                 draw_status_segment(fy, &fx, max_x, COLOR_PAIR(4), buf);
             }
-            if (total_row_pages > 1) {
-                char buf[64];
+            if (total_row_pages > 1 || seek_mode_active()) {
+                char pages[64];
+                char buf[96];
+                format_row_pages(pages, sizeof(pages));
                 draw_footer_separator(fy, &fx, max_x);
-                snprintf(buf, sizeof(buf), "Rows Pg %d/%d [↑][↓] Rows", row_page + 1, total_row_pages);
+                snprintf(buf, sizeof(buf), "%s [↑][↓] Rows", pages);
                 draw_status_segment(fy, &fx, max_x, COLOR_PAIR(4), buf);
             }
         }
@@ -601,17 +652,17 @@ void draw_ui(Table *table) {
             draw_footer_separator(fy, &fx, max_x);
             draw_status_segment(fy, &fx, max_x, COLOR_PAIR(10) | A_BOLD, "0 results");
         }
-        if (total_pages > 1 || total_row_pages > 1) {
+        if (total_pages > 1 || total_row_pages > 1 || seek_mode_active()) {
             if (total_pages > 1) {
                 char buf[32];
                 draw_footer_separator(fy, &fx, max_x);
                 snprintf(buf, sizeof(buf), "Cols Pg %d/%d", col_page + 1, total_pages);
                 draw_status_segment(fy, &fx, max_x, COLOR_PAIR(4), buf);
             }
-            if (total_row_pages > 1) {
-                char buf[32];
+            if (total_row_pages > 1 || seek_mode_active()) {
+                char buf[64];
+                format_row_pages(buf, sizeof(buf));
                 draw_footer_separator(fy, &fx, max_x);
-                snprintf(buf, sizeof(buf), "Rows Pg %d/%d", row_page + 1, total_row_pages);
                 draw_status_segment(fy, &fx, max_x, COLOR_PAIR(4), buf);
             }
         }
@@ -11,6 +11,19 @@
 
 #define MAX_INPUT 128
 
+// Low-RAM seek view: edits write through to the database (ui_seek.c)
+static int seek_view_active(void)
+{
+    return seek_mode_active();
+}
+
+static int seek_key_cell(int col)
+{
+    if (!seek_view_active() || col != seek_mode_key_column()) return 0;
+    show_error_message("The row key cannot be edited.");
+    return 1;
+}
+
 // Allow editing header cell: rename or change type with validation warning
 void edit_header_cell(Table *t, int col) {
     int selected = 0; /* 0=rename,1=change type */
@@ -57,6 +70,10 @@ void edit_header_cell(Table *t, int col) {
     pm_remove(shadow);
     pm_update();
     if (selected < 0) return;
+    if (selected == 0 && seek_view_active()) {
+        show_error_message("Columns cannot be renamed in the low-RAM database view.");
+        return;
+    }
 
     if (selected == 0) {
         // Rename column
@@ -180,7 +197,8 @@ void edit_header_cell(Table *t, int col) {
                         show_error_message(err[0] ? err : "Type change failed.");
                     } else {
                         ui_rebuild_table_view(t, NULL, 0);
-                        db_autosave_table(t, err, sizeof(err));
+                        // In the seek view the type only changes how windows are shown
+                        if (!seek_view_active()) db_autosave_table(t, err, sizeof(err));
                     }
                 }
             } else {
@@ -189,7 +207,7 @@ void edit_header_cell(Table *t, int col) {
                     show_error_message(err[0] ? err : "Type change failed.");
                 } else {
                     ui_rebuild_table_view(t, NULL, 0);
-                    db_autosave_table(t, err, sizeof(err));
+                    if (!seek_view_active()) db_autosave_table(t, err, sizeof(err));
                 }
             }
         }
@@ -199,7 +217,7 @@ void edit_header_cell(Table *t, int col) {
 }
 
 void edit_body_cell(Table *t, int row, int col) {
-    if (!t) return;
+    if (!t || seek_key_cell(col)) return;
 
     const char *col_name = t->columns[col].name;
     const char *type_str = type_to_string(t->columns[col].type);
@@ -227,13 +245,15 @@ void edit_body_cell(Table *t, int row, int col) {
 
         {
             char err[256] = {0};
-            if (tableop_set_cell(t, row, col, value, err, sizeof(err)) != 0) {
+            int rc = seek_view_active() ? seek_mode_set_cell(t, row, col, value, err, sizeof(err))
+                                        : tableop_set_cell(t, row, col, value, err, sizeof(err));
+            if (rc != 0) {
                 show_error_message(err[0] ? err : "Failed to update cell.");
                 value[0] = '\0';
                 continue;
             }
             ui_rebuild_table_view(t, NULL, 0);
-            db_autosave_table(t, err, sizeof(err));
+            if (!seek_view_active()) db_autosave_table(t, err, sizeof(err));
         }
         break;
     }
@@ -296,17 +316,20 @@ void confirm_delete_row_at(Table *t, int row) {
     int pick = list_confirm(title, opts, 2);
     if (pick != 0) return;
     char err[256] = {0};
-    if (tableop_delete_row(t, row, err, sizeof(err)) != 0) {
+    int rc = seek_view_active() ? seek_mode_delete_row(t, row, err, sizeof(err))
+                                : tableop_delete_row(t, row, err, sizeof(err));
+    if (rc != 0) {
         show_error_message(err[0] ? err : "Failed to delete row.");
     } else {
         ui_rebuild_table_view(t, NULL, 0);
-        db_autosave_table(t, err, sizeof(err));
+        if (!seek_view_active()) db_autosave_table(t, err, sizeof(err));
     }
 }
 
 void confirm_delete_column_at(Table *t, int col) {
     if (!t || t->column_count <= 0 || col < 0 || col >= t->column_count) { show_error_message("No column to delete."); return; }
     if (t->column_count == 1) { show_error_message("Cannot delete the last column."); return; }
+    if (seek_view_active()) { show_error_message("Columns cannot be deleted in the low-RAM database view."); return; }
     const char *opts[] = { "Yes", "No" };
     char title[96]; snprintf(title, sizeof(title), "Delete Column '%s'?", t->columns[col].name);
     int pick = list_confirm(title, opts, 2);
@@ -322,6 +345,7 @@ void confirm_delete_column_at(Table *t, int col) {
 
 void prompt_clear_cell(Table *t, int row, int col) {
     if (!t || row < 0 || row >= t->row_count || col < 0 || col >= t->column_count) { show_error_message("No cell to clear."); return; }
+    if (seek_key_cell(col)) return;
     int h = 5; int w = COLS - 8; int y = (LINES - h) / 2; int x = 4;
     PmNode *sh = pm_add(y + 1, x + 2, h, w, PM_LAYER_MODAL_SHADOW, PM_LAYER_MODAL_SHADOW);
     PmNode *mo = pm_add(y, x, h, w, PM_LAYER_MODAL, PM_LAYER_MODAL);
@@ -336,11 +360,13 @@ void prompt_clear_cell(Table *t, int row, int col) {
 
     {
         char err[256] = {0};
-        if (tableop_clear_cell(t, row, col, err, sizeof(err)) != 0) {
+        int rc = seek_view_active() ? seek_mode_set_cell(t, row, col, NULL, err, sizeof(err))
+                                    : tableop_clear_cell(t, row, col, err, sizeof(err));
+        if (rc != 0) {
             show_error_message(err[0] ? err : "Failed to clear cell.");
             return;
         }
         ui_rebuild_table_view(t, NULL, 0);
-        db_autosave_table(t, err, sizeof(err));
+        if (!seek_view_active()) db_autosave_table(t, err, sizeof(err));
     }
 }
@@ -14,6 +14,7 @@
 #include "workspace.h"
 #include "ui.h"
 #include "ui_loading.h"
+#include "mem_budget.h"
 
 typedef struct {
     char *name;
@@ -72,12 +73,26 @@ static void replace_loaded_table(Table *table, Table *loaded)
     ui_reset_table_view(table);
 }
 
+// A seek view only holds a window of its database, so it never goes into
+// the book: close it and put the book's copy of the active table back
+static int leave_seek_view(Table *table, char *err, size_t err_sz)
+{
+    Table *saved;
+
+    if (!seek_mode_active()) return 0;
+    seek_mode_close();
+    saved = ttbx_load_table(workspace_project_path(), workspace_active_table_id(), err, err_sz);
+    if (!saved) return -1;
+    replace_table_contents(table, saved);
+    return 0;
+}
+
 static int prepare_for_single_table_open(Table *table)
 {
     if (!table) return 0;
 
     if ((table->column_count > 0 || table->row_count > 0) &&
-        !workspace_autosave_enabled()) {
+        !workspace_autosave_enabled() && !seek_mode_active()) {
         int h = 5;
         int w = COLS - 4;
         int y = (LINES - h) / 2;
@@ -103,7 +118,7 @@ static int prepare_for_single_table_open(Table *table)
 
     {
         char err[256] = {0};
-        if (workspace_new_table(table, err, sizeof(err)) != 0) {
+        if (leave_seek_view(table, err, sizeof(err)) != 0 || workspace_new_table(table, err, sizeof(err)) != 0) {
             show_error_message(err[0] ? err : "Failed to prepare new table.");
             return -1;
         }
@@ -152,7 +167,35 @@ int ui_open_path(Table *table, const char *path, int preserve_current_table, int
     settings_init_defaults(&s);
     settings_load(settings_default_path(), &s);
 
-    if (is_csv) {
+    int use_seek = (is_csv || is_xlsx) && low_ram_mode;
+    if ((is_csv || is_xlsx) && !use_seek && low_ram_auto) {
+        use_seek = !mem_budget_fits(is_csv ? csv_estimate_load_bytes(path) : xl_estimate_load_bytes(path));
+    }
+
+    if (use_seek) {
+        // Rows go straight into a spill database; the table only ever holds a window
+        int rc;
+        loading_modal = ui_loading_modal_start(is_csv ? "Import CSV" : "Import XLSX",
+                                               is_csv ? "Reading file..." : "Streaming worksheet...", &reporter);
+        const ProgressReporter *cb = (loading_modal && reporter.update) ? &reporter : NULL;
+        ui_reset_table_view(table);
+        if (is_csv) {
+            rc = seek_mode_open_csv(path, s.type_infer_enabled, table, 200, cb, err, sizeof(err));
+        } else {
+            rc = seek_mode_open_xlsx(path, s.type_infer_enabled, table, 200, cb, err, sizeof(err));
+        }
+        if (loading_modal) {
+            ui_loading_modal_finish(loading_modal);
+        }
+        if (rc != 0) {
+            show_error_message(err[0] ? err : "Failed to load file");
+            return -1;
+        }
+        if (!low_ram_mode) {
+            show_error_message("File exceeds the memory budget; opened in Low-RAM view.");
+        }
+        return 0;
+    } else if (is_csv) {
         loading_modal = ui_loading_modal_start("Import CSV", "Reading file...", &reporter);
         const ProgressReporter *cb = (loading_modal && reporter.update) ? &reporter : NULL;
         loaded = csv_load_with_progress(path, s.type_infer_enabled, err, sizeof(err), cb);
@@ -165,6 +208,7 @@ int ui_open_path(Table *table, const char *path, int preserve_current_table, int
     } else if (!ttbx_is_book_dir(path)) {
         snprintf(err, sizeof(err), "Legacy .ttbx files are not supported. Open a .ttbx directory book.");
     } else if (workspace_open_book(table, path, err, sizeof(err)) == 0) {
+        seek_mode_close();
         workspace_set_active_table(table);
         ui_reset_table_view(table);
     }
@@ -186,6 +230,7 @@ int ui_open_path(Table *table, const char *path, int preserve_current_table, int
         return -1;
     }
 
+    seek_mode_close();
     replace_loaded_table(table, loaded);
     if (workspace_manual_save(table, err, sizeof(err)) != 0) {
         show_error_message(err[0] ? err : "Failed to save opened file.");
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <limits.h>
 #include "tablecraft.h"
 #include "ui.h"
 #include "errors.h"  // Added to provide declaration for show_error_message
@@ -10,6 +11,9 @@
 #include "workspace.h"
 #include "db_manager.h"
 #include "table_ops.h"
+#include "text_regex.h"
+#include "text_fold.h"
+#include "ui_loading.h"
 
 // Define global UI state variables
 int editing_mode = 0;
@@ -28,6 +32,7 @@ int row_page = 0;
 int rows_visible = 0;
 int total_row_pages = 1;
 int low_ram_mode = 0; // exported in ui.h
+int low_ram_auto = 0; // exported in ui.h
 int row_gutter_enabled = 1; // exported in ui.h
 int footer_page = 0;
 UiReorderMode reorder_mode = UI_REORDER_NONE;
@@ -35,12 +40,17 @@ int reorder_source_row = -1;
 int reorder_source_col = -1;
 TableView ui_table_view;
 
-// Local search state (current in-memory table/window)
-typedef struct { int row; int col; int start; int len; } SearchHit;
-static SearchHit *hits = NULL;
+// Local search state (current in-memory table/window). Navigation scans
+// lazily from the current match; the total is counted a slice per frame.
+#define SEARCH_COUNT_CELLS_PER_FRAME 65536
 char search_query[128];
 int search_sel_start = -1;
 int search_sel_len = 0;
+int search_count_done = 0;
+int search_db_wide = 0;
+static int search_count_row = 0;
+static TextRegex *search_regex = NULL; // set in regex search mode
+static char search_key[256];           // search_query casefolded (text_fold)
 
 static void exit_search(void);
 
@@ -134,10 +144,15 @@ static void move_cursor_down_paged(Table *table)
     ensure_cursor_row_visible(table);
 }
 
-static void clear_search_hits(void) {
-    if (hits) { free(hits); hits = NULL; }
+static void clear_search_state(void) {
     search_hit_count = 0; search_hit_index = 0;
+    search_count_done = 0;
+    search_db_wide = 0;
+    search_count_row = 0;
+    text_regex_free(search_regex);
+    search_regex = NULL;
     search_query[0] = '\0';
+    search_key[0] = '\0';
     search_sel_start = -1;
     search_sel_len = 0;
 }
@@ -252,24 +267,6 @@ static void clamp_cursor_viewport(const Table *table) {
     if (visible_rows <= 0) cursor_row = -1;
 }
 
-// Case-insensitive ASCII substring
-static int ci_find(const char *hay, const char *need) {
-    if (!hay || !need) return -1;
-    size_t nlen = strlen(need);
-    if (nlen == 0) return 0;
-    for (int pos = 0; hay[pos]; ++pos) {
-        size_t i = 0;
-        while (hay[pos + i] && i < nlen) {
-            char a = hay[pos + i]; if (a >= 'A' && a <= 'Z') a = (char)(a - 'A' + 'a');
-            char b = need[i];      if (b >= 'A' && b <= 'Z') b = (char)(b - 'A' + 'a');
-            if (a != b) break;
-            i++;
-        }
-        if (i == nlen) return pos;
-    }
-    return -1;
-}
-
 int ui_format_cell_value(const Table *t, int row, int col, char *buf, size_t buf_sz)
 {
     if (!buf || buf_sz == 0) return -1;
@@ -289,30 +286,115 @@ int ui_format_cell_value(const Table *t, int row, int col, char *buf, size_t buf
     return 0;
 }
 
-static void gather_search_hits(Table *t, const char *query) {
-    clear_search_hits();
+static int search_match_cell(Table *t, int visible_row, int col, int *start, int *len) {
+    int actual_row = ui_actual_row_for_visible(t, visible_row);
+    char buf[128] = "";
+    if (actual_row < 0) return 0;
+    ui_format_cell_value(t, actual_row, col, buf, sizeof(buf));
+    if (buf[0] == '\0') return 0;
+    if (search_regex) return text_regex_search(search_regex, buf, start, len);
+    if (t->columns[col].type == TYPE_STR) {
+        // Match on the cached folded key, then map the hit back onto buf
+        if (table_fold_keys_ensure(t, col) == 0) {
+            const char *key = table_fold_key(t, actual_row, col);
+            if (!key || !strstr(key, search_key)) return 0;
+        }
+    }
+    return text_fold_find(buf, NULL, search_key, text_fold_default_flags(), start, len);
+}
+
+// Scan cells row-major from (*row, *col), exclusive, in direction dir (+1/-1),
+// wrapping once. On a match updates *row/*col/*start/*len and returns 1;
+// *wrapped tells whether the scan passed the end (or start) of the view.
+static int search_scan(Table *t, int dir, int *row, int *col, int *start, int *len, int *wrapped) {
+    int cols = t ? t->column_count : 0;
+    long long total = (long long)ui_visible_row_count(t) * cols;
+    *wrapped = 0;
+    if (total <= 0 || search_query[0] == '\0') return 0;
+    long long pos = (long long)(*row) * cols + *col;
+    for (long long step = 0; step < total; ++step) {
+        pos += dir;
+        if (pos >= total) { pos = 0; *wrapped = 1; }
+        else if (pos < 0) { pos = total - 1; *wrapped = 1; }
+        int r = (int)(pos / cols);
+        int c = (int)(pos % cols);
+        if (search_match_cell(t, r, c, start, len)) {
+            *row = r;
+            *col = c;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void search_select(int row, int col, int start, int len) {
+    cursor_row = row;
+    cursor_col = col;
+    search_sel_start = start;
+    search_sel_len = len;
+    if (rows_visible > 0) row_page = cursor_row / rows_visible;
+}
+
+// Seek mode: scan the loaded window without wrapping, then let the FTS index
+// pick the next window holding a match (its first row is the hit).
+static int search_step_db(Table *t, int dir) {
+    int row = cursor_row, col = cursor_col, start = 0, len = 0, wrapped = 0;
+    if (row < 0) row = 0;
+    if (search_scan(t, dir, &row, &col, &start, &len, &wrapped) && !wrapped) {
+        search_select(row, col, start, len);
+        return 1;
+    }
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        char err[256] = {0};
+        int page = (rows_visible > 0 ? rows_visible : 200);
+        int got = seek_mode_search_jump(t, search_query, dir, page, &wrapped, err, sizeof(err));
+        if (got <= 0) {
+            if (err[0]) show_error_message(err);
+            return 0;
+        }
+        // Index and cell text can disagree (e.g. non-ASCII case folding); then try the next hit
+        row = 0;
+        col = (dir > 0) ? -1 : t->column_count;
+        if (search_scan(t, dir, &row, &col, &start, &len, &wrapped) && row == 0) {
+            search_select(row, col, start, len);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void search_step(Table *t, int dir) {
+    int row = cursor_row, col = cursor_col, start = 0, len = 0, wrapped = 0;
+    if (search_db_wide) {
+        search_step_db(t, dir);
+        return;
+    }
+    if (row < 0) row = 0;
+    if (!search_scan(t, dir, &row, &col, &start, &len, &wrapped)) return;
+    if (dir > 0) {
+        if (wrapped) search_hit_index = 0;
+        else if (search_hit_index >= 0) search_hit_index++;
+    } else {
+        if (wrapped) search_hit_index = search_count_done ? search_hit_count - 1 : -1;
+        else if (search_hit_index > 0) search_hit_index--;
+    }
+    search_select(row, col, start, len);
+}
+
+// Count a bounded slice of the view per frame so the total fills in without
+// blocking navigation; search_count_done flags when the total is final.
+static void search_count_step(Table *t) {
+    if (!search_mode || search_count_done || search_db_wide || !t) return;
     int visible_rows = ui_visible_row_count(t);
-    if (!t || t->column_count <= 0 || visible_rows <= 0) return;
-    strncpy(search_query, query, sizeof(search_query)-1); search_query[sizeof(search_query)-1] = '\0';
-    trim_ascii(search_query);
-    if (search_query[0] == '\0') return;
-    int cap = 0;
-    for (int r = 0; r < visible_rows; ++r) {
-        int actual_row = ui_actual_row_for_visible(t, r);
-        if (actual_row < 0) continue;
+    int budget = SEARCH_COUNT_CELLS_PER_FRAME;
+    while (search_count_row < visible_rows && budget > 0) {
         for (int c = 0; c < t->column_count; ++c) {
-            char buf[128] = "";
-            ui_format_cell_value(t, actual_row, c, buf, sizeof(buf));
-            if (buf[0] == '\0') continue;
-            int start = ci_find(buf, search_query);
-            if (start >= 0) {
-                if (search_hit_count == cap) { cap = cap ? cap * 2 : 16; hits = realloc(hits, sizeof(SearchHit) * cap); }
-                hits[search_hit_count].row = r; hits[search_hit_count].col = c;
-                hits[search_hit_count].start = start; hits[search_hit_count].len = (int)strlen(search_query);
-                search_hit_count++;
-            }
+            if (search_match_cell(t, search_count_row, c, NULL, NULL)) search_hit_count++;
         }
+        budget -= (t->column_count > 0) ? t->column_count : 1;
+        search_count_row++;
     }
+    if (search_count_row >= visible_rows) search_count_done = 1;
 }
 
 static int prompt_search_query(const char *title, const char *prompt, char *out, size_t out_sz) {
@@ -324,23 +406,105 @@ static int prompt_search_query(const char *title, const char *prompt, char *out,
                                  false);
 }
 
-static void enter_search(Table *table) {
+// Low-RAM seek view: search the whole database through the FTS index
+static void enter_search_db(Table *table) {
+    char err[256] = {0};
+    ProgressReporter reporter;
+    UiLoadingModal *modal = ui_loading_modal_start("Search", "Preparing search index...", &reporter);
+    int rc = seek_mode_search_prepare(err, sizeof(err));
+    long long total = (rc == 0) ? seek_mode_search_count(search_query, err, sizeof(err)) : -1;
+    ui_loading_modal_finish(modal);
+    if (rc != 0 || total < 0) {
+        clear_search_state();
+        show_error_message(err[0] ? err : "Search failed.");
+        return;
+    }
+    if (total == 0) {
+        clear_search_state();
+        show_error_message("No matches found.");
+        return;
+    }
+    search_db_wide = 1;
+    search_hit_count = (total > INT_MAX) ? INT_MAX : (int)total;
+    search_count_done = 1;
+    search_hit_index = -1;
+    cursor_row = 0;
+    cursor_col = -1;
+    if (!search_step_db(table, +1)) {
+        clear_search_state();
+        show_error_message("No matches found.");
+        return;
+    }
+    search_mode = 1;
+}
+
+static void enter_search(Table *table, int regex) {
     char query[128] = {0};
-    if (prompt_search_query("Search", "Query: ", query, sizeof(query)) <= 0) return;
-    gather_search_hits(table, query);
-    if (search_hit_count <= 0) { show_error_message("No matches found."); return; }
+    if (prompt_search_query(regex ? "Regex Search" : "Search", regex ? "Pattern: " : "Query: ", query, sizeof(query)) <= 0) return;
+    clear_search_state();
+    strncpy(search_query, query, sizeof(search_query)-1); search_query[sizeof(search_query)-1] = '\0';
+    if (!regex) trim_ascii(search_query);
+    text_fold_into(search_query, text_fold_default_flags(), search_key, sizeof(search_key));
+    if (regex && search_query[0]) {
+        char err[128] = {0};
+        search_regex = text_regex_compile(search_query, 1, err, sizeof(err));
+        if (!search_regex) {
+            clear_search_state();
+            show_error_message(err[0] ? err : "Invalid pattern.");
+            return;
+        }
+    }
+    if (!regex && search_query[0] && seek_mode_active()) {
+        enter_search_db(table);
+        return;
+    }
+    int row = 0, col = -1, start = 0, len = 0, wrapped = 0;
+    if (!search_scan(table, +1, &row, &col, &start, &len, &wrapped)) {
+        clear_search_state();
+        show_error_message("No matches found.");
+        return;
+    }
     search_mode = 1;
     search_hit_index = 0;
-    cursor_row = hits[0].row;
-    cursor_col = hits[0].col;
-    search_sel_start = hits[0].start;
-    search_sel_len = hits[0].len;
-    if (rows_visible > 0) row_page = cursor_row / rows_visible;
+    search_select(row, col, start, len);
+}
+
+void ui_search_select_cell(Table *table, const char *query, int row, int col)
+{
+    int start = -1, len = 0;
+    clear_search_state();
+    if (!table || !query) return;
+    strncpy(search_query, query, sizeof(search_query)-1); search_query[sizeof(search_query)-1] = '\0';
+    if (search_query[0] == '\0') return;
+    text_fold_into(search_query, text_fold_default_flags(), search_key, sizeof(search_key));
+    if (!search_match_cell(table, row, col, &start, &len)) { start = -1; len = 0; }
+    search_mode = 1;
+    search_hit_index = -1;
+    search_select(row, col, start, len);
 }
 
 static void exit_search(void) {
     search_mode = 0;
-    clear_search_hits();
+    clear_search_state();
+}
+
+// The low-RAM view holds one window of its database, not a book table, so
+// it is never saved into the book (Export writes out the whole view)
+static void save_workspace(Table *table)
+{
+    char serr[256] = {0};
+
+    if (seek_mode_active()) {
+        show_error_message("The low-RAM view is not saved to the book; use Export to keep it.");
+        return;
+    }
+    if (workspace_manual_save(table, serr, sizeof(serr)) != 0) {
+        if (serr[0]) show_error_message(serr);
+        else show_error_message("Save failed.");
+    }
+    else {
+        show_error_message("Workspace saved.");
+    }
 }
 
 static void finish_reorder_action(Table *table, int keep_header_cursor)
@@ -363,6 +527,12 @@ void start_ui_loop(Table *table) {
 
     while (1) {
         draw_ui(table);
+        if (seek_mode_active()) {
+            // Fetch columns paged into view, then draw again with them
+            char err[128] = {0};
+            int page = (rows_visible > 0 ? rows_visible : 200);
+            if (seek_mode_show_columns(table, col_start, cols_visible, page, err, sizeof err) > 0) draw_ui(table);
+        }
         wnoutrefresh(stdscr); // stage stdscr changes
         pm_update(); // update panels and flush
         int fetched = 0; // limit DB window fetches to once per frame
@@ -375,23 +545,9 @@ void start_ui_loop(Table *table) {
             if (search_mode) {
             // In search mode, arrow keys navigate matches, ESC exits
             if (ch == KEY_LEFT || ch == KEY_UP) {
-                if (search_hit_count > 0) {
-                    search_hit_index = (search_hit_index > 0) ? (search_hit_index - 1) : (search_hit_count - 1);
-                    cursor_row = hits[search_hit_index].row;
-                    cursor_col = hits[search_hit_index].col;
-                    search_sel_start = hits[search_hit_index].start;
-                    search_sel_len = hits[search_hit_index].len;
-                    if (rows_visible > 0) row_page = cursor_row / rows_visible;
-                }
+                search_step(table, -1);
             } else if (ch == KEY_RIGHT || ch == KEY_DOWN) {
-                if (search_hit_count > 0) {
-                    search_hit_index = (search_hit_index + 1) % (search_hit_count > 0 ? search_hit_count : 1);
-                    cursor_row = hits[search_hit_index].row;
-                    cursor_col = hits[search_hit_index].col;
-                    search_sel_start = hits[search_hit_index].start;
-                    search_sel_len = hits[search_hit_index].len;
-                    if (rows_visible > 0) row_page = cursor_row / rows_visible;
-                }
+                search_step(table, +1);
             } else if (ch == 27) { // ESC
                 exit_search();
             }
@@ -401,21 +557,13 @@ void start_ui_loop(Table *table) {
             else if (ch == 8 /* Ctrl+H */ || ch == KEY_HOME) {
                 // Go to top-left of dataset; in seek mode, fetch first window
                 col_page = 0; row_page = 0; cursor_col = 0; cursor_row = -1;
-                if (low_ram_mode && seek_mode_active()) {
+                if (seek_mode_active()) {
                     char err[128]={0}; int page=(rows_visible>0?rows_visible:200);
                     seek_mode_fetch_first(table, page, err, sizeof err);
                 }
             }
-            else if (ch == 's' || ch == 'S') {
-                char serr[256] = {0};
-                if (workspace_manual_save(table, serr, sizeof(serr)) != 0) {
-                    if (serr[0]) show_error_message(serr);
-                    else show_error_message("Save failed.");
-                }
-                else {
-                    show_error_message("Workspace saved.");
-                }
-            }
+            else if (ch == 's' || ch == 'S')
+                save_workspace(table);
             else if (ch == 'c' || ch == 'C')
                 prompt_add_column(table);
             else if (ch == 'r' || ch == 'R') {
@@ -425,7 +573,13 @@ void start_ui_loop(Table *table) {
                     prompt_add_row(table);
             }
             else if (ch == 'f' || ch == 'F') {
-                enter_search(table);
+                enter_search(table, 0);
+            }
+            else if (ch == 'g' || ch == 'G') {
+                prompt_goto_row(table);
+            }
+            else if (ch == '/') {
+                enter_search(table, 1);
             }
             else if (ch == 'e' || ch == 'E') {
                 editing_mode = 1;
@@ -446,7 +600,7 @@ void start_ui_loop(Table *table) {
             } else if (ch == KEY_UP) {
                 final_vdir = -1;
                 vcount++;
-                if (low_ram_mode && seek_mode_active()) {
+                if (seek_mode_active()) {
                     if (cursor_row <= 0) {
                         char err[128]={0};
                         int page = (rows_visible>0?rows_visible:200);
@@ -464,7 +618,7 @@ void start_ui_loop(Table *table) {
             } else if (ch == KEY_DOWN) {
                 final_vdir = +1;
                 vcount++;
-                if (low_ram_mode && seek_mode_active()) {
+                if (seek_mode_active()) {
                     if (cursor_row >= table->row_count - 1) {
                         char err[128]={0};
                         int page = (rows_visible>0?rows_visible:200);
@@ -483,14 +637,7 @@ void start_ui_loop(Table *table) {
         } else {
             // If in interactive delete modes, override edit controls for navigation + confirm
             if (ch == 's' || ch == 'S') {
-                char serr[256] = {0};
-                if (workspace_manual_save(table, serr, sizeof(serr)) != 0) {
-                    if (serr[0]) show_error_message(serr);
-                    else show_error_message("Save failed.");
-                }
-                else {
-                    show_error_message("Workspace saved.");
-                }
+                save_workspace(table);
                 continue;
             }
             if (ch == '\t') {
@@ -695,7 +842,7 @@ void start_ui_loop(Table *table) {
                     if (ch == 8 /* Ctrl+H */) { /* already handled */ }
                     final_vdir = -1;
                     vcount++;
-                    if (low_ram_mode && seek_mode_active()) {
+                    if (seek_mode_active()) {
                         if (cursor_row <= 0) {
                             char err[128]={0}; int page=(rows_visible>0?rows_visible:200);
                             if (!fetched && seek_mode_fetch_prev(table, page, err, sizeof err) > 0) {
@@ -722,7 +869,7 @@ void start_ui_loop(Table *table) {
                 case KEY_DOWN:
                     final_vdir = +1;
                     vcount++;
-                    if (low_ram_mode && seek_mode_active()) {
+                    if (seek_mode_active()) {
                         if (cursor_row >= table->row_count - 1) {
                             char err[128]={0}; int page=(rows_visible>0?rows_visible:200);
                             if (!fetched && seek_mode_fetch_next(table, page, err, sizeof err) > 0) {
@@ -750,14 +897,17 @@ void start_ui_loop(Table *table) {
                     col_page = 0; row_page = 0; cursor_col = col_start; cursor_row = (row_page * (rows_visible>0?rows_visible:1));
                     if (cursor_row >= ui_visible_row_count(table)) cursor_row = ui_visible_row_count(table) - 1;
                     if (cursor_row < 0) cursor_row = -1; // header if empty
-                    if (low_ram_mode && seek_mode_active()) {
+                    if (seek_mode_active()) {
                         char err[128]={0}; int page=(rows_visible>0?rows_visible:200);
                         seek_mode_fetch_first(table, page, err, sizeof err);
                     }
                     break;
                 case 'f':
                 case 'F':
-                    enter_search(table);
+                    enter_search(table, 0);
+                    break;
+                case '/':
+                    enter_search(table, 1);
                     break;
                 case '\n': // Enter key
                     if (cursor_row == -1)
@@ -773,6 +923,10 @@ void start_ui_loop(Table *table) {
                     del_row_mode = 1; del_col_mode = 0;
                     break;
                 case 'v':
+                    if (seek_mode_active()) {
+                        show_error_message("The low-RAM database view keeps rows and columns in database order.");
+                        break;
+                    }
                     if (cursor_row < 0) {
                         if (table->column_count <= 0) {
                             show_error_message("No columns to move.");
@@ -835,6 +989,10 @@ void start_ui_loop(Table *table) {
                     del_col_mode = 1; del_row_mode = 0;
                     break;
                 case 'V':
+                    if (seek_mode_active()) {
+                        show_error_message("The low-RAM database view keeps rows and columns in database order.");
+                        break;
+                    }
                     if (cursor_row < 0) {
                         if (table->column_count <= 0) {
                             show_error_message("No columns to swap.");
@@ -891,6 +1049,7 @@ void start_ui_loop(Table *table) {
             }
         }
         if (quit) break;
+        search_count_step(table);
         // Final hard clamp to viewport
         clamp_cursor_viewport(table);
         napms(16); // ~60 FPS; coalesces many key repeats into one redraw
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <ncurses.h>
 #include <string.h>
 #include <strings.h>
@@ -15,8 +16,12 @@
 #include "workspace.h"
 #include "errors.h"
 #include "panel_manager.h"
+#include "ui_loading.h"
+#include "book_search.h"
+#include "table_vtab.h"
 
 #define MAX_INPUT 128
+#define BOOK_SEARCH_HITS_PER_TABLE 200
 
 typedef enum {
     TABLE_MENU_ACTION_RENAME_TABLE = 0,
@@ -27,6 +32,8 @@ typedef enum {
     TABLE_MENU_ACTION_EXPORT,
     TABLE_MENU_ACTION_OPEN_FILE,
     TABLE_MENU_ACTION_BOOK_TABLES,
+    TABLE_MENU_ACTION_SEARCH_BOOK,
+    TABLE_MENU_ACTION_SQL_QUERY,
     TABLE_MENU_ACTION_NEW_TABLE,
     TABLE_MENU_ACTION_SETTINGS,
     TABLE_MENU_ACTION_BACK
@@ -49,6 +56,8 @@ static int draw_simple_list_modal(const char *title, const char **items, int cou
 static UiMenuResult prompt_rename_active_table(Table *table);
 static UiMenuResult prompt_rename_book(void);
 static UiMenuResult show_book_tables_page(Table *table);
+static UiMenuResult show_book_search_page(Table *table);
+static UiMenuResult show_sql_query_page(Table *table);
 int show_text_input_modal(const char *title,
                           const char *hint,
                           const char *prompt,
@@ -60,6 +69,7 @@ static int has_extension(const char *name, const char *ext);
 // (no local string-list helpers required here)
 static int prompt_add_column_at_internal(Table *table, int col_index, int focus_inserted, const char *title);
 static int prompt_add_row_at_internal(Table *table, int row_index, int focus_inserted, const char *title);
+static int seek_view_active(void);
 
 static int table_menu_next_selectable(const TableMenuEntry *entries, int count, int start, int dir)
 {
@@ -261,10 +271,12 @@ int show_text_input_modal(const char *title,
 
         int field_width = (w - 2) - input_x + 1;
         if (field_width < 0) field_width = 0;
+        // Longer input scrolls so its end and the cursor stay in view
+        int scroll = (field_width > 0 && len >= field_width) ? len - field_width + 1 : 0;
 
         if (field_width > 0) {
             mvwaddch(modal->win, input_y, 2, '>');
-            mvwprintw(modal->win, input_y, input_x, "%.*s", field_width, out);
+            mvwprintw(modal->win, input_y, input_x, "%.*s", field_width, out + scroll);
             if (len < field_width) {
                 for (int i = len; i < field_width; ++i) {
                     mvwaddch(modal->win, input_y, input_x + i, ' ');
@@ -282,7 +294,7 @@ int show_text_input_modal(const char *title,
         pm_wnoutrefresh(modal);
         pm_update();
 
-        int cursor_x = input_x + len;
+        int cursor_x = input_x + len - scroll;
         int cursor_max = w - 2;
         if (cursor_x > cursor_max) {
             cursor_x = cursor_max;
@@ -364,6 +376,11 @@ int prompt_insert_column_at(Table *table, int col_index)
 static int prompt_add_column_at_internal(Table *table, int col_index, int focus_inserted, const char *title)
 {
     char name[MAX_INPUT];
+
+    if (seek_view_active()) {
+        show_error_message("Columns cannot be added in the low-RAM database view.");
+        return -1;
+    }
     int name_len = show_text_input_modal(title ? title : "Add Column",
                                      "[Enter] Next   [Esc] Cancel",
                                      "Name:",
@@ -447,6 +464,8 @@ static int prompt_add_row_at_internal(Table *table, int row_index, int focus_ins
             cancelled = true;
             break;
         }
+        // The database assigns the row key
+        if (seek_view_active() && i == seek_mode_key_column()) continue;
 
         const char *col_name = table->columns[i].name;
         const char *col_type = type_to_string(table->columns[i].type);
@@ -484,7 +503,10 @@ static int prompt_add_row_at_internal(Table *table, int row_index, int focus_ins
 
     if (!cancelled) {
         char err[256] = {0};
-        if (tableop_insert_row_at(table, row_index, (const char **)input_strings, err, sizeof(err)) != 0) {
+        int rc = seek_view_active()
+                     ? seek_mode_insert_row(table, row_index, (const char **)input_strings, err, sizeof(err))
+                     : tableop_insert_row_at(table, row_index, (const char **)input_strings, err, sizeof(err));
+        if (rc != 0) {
             show_error_message(err[0] ? err : "Failed to add row.");
         } else {
             ui_rebuild_table_view(table, NULL, 0);
@@ -498,7 +520,7 @@ static int prompt_add_row_at_internal(Table *table, int row_index, int focus_ins
                     row_page = 0;
                 }
             }
-            db_autosave_table(table, err, sizeof(err));
+            if (!seek_view_active()) db_autosave_table(table, err, sizeof(err));
             for (int i = 0; i < table->column_count; ++i) {
                 free(input_strings[i]);
             }
@@ -575,6 +597,12 @@ static UiMenuResult show_book_tables_page(Table *table)
 {
     int sel = 0;
 
+    // The seek view is not a book table: switching away would save its
+    // window over the active one
+    if (seek_mode_active()) {
+        show_error_message("Book tables are unavailable in the low-RAM database view.");
+        return UI_MENU_BACK;
+    }
     noecho();
     curs_set(0);
 
@@ -718,13 +746,261 @@ static UiMenuResult show_book_tables_page(Table *table)
     }
 }
 
+// One list row per table heading and per hit; hit_index is -1 on headings.
+typedef struct {
+    int table_index;
+    int hit_index;
+} BookSearchItem;
+
+static UiMenuResult show_book_search_page(Table *table)
+{
+    char query[MAX_INPUT] = {0};
+    char err[256] = {0};
+    BookSearchResult result;
+    ProgressReporter reporter;
+    UiLoadingModal *modal;
+    int rc;
+
+    if (seek_mode_active()) {
+        show_error_message("Book search is unavailable in the low-RAM database view.");
+        return UI_MENU_BACK;
+    }
+    if (show_text_input_modal("Search Book",
+                              "[Enter] Search   [Esc] Back",
+                              "Query:",
+                              query,
+                              sizeof(query),
+                              false) <= 0) {
+        return UI_MENU_BACK;
+    }
+
+    // The active table is searched in memory, so unsaved edits are found
+    // without writing them to the book
+    modal = ui_loading_modal_start("Search Book", "Searching tables...", &reporter);
+    rc = book_search_run(workspace_project_path(), table, workspace_active_table_id(),
+                         query, BOOK_SEARCH_HITS_PER_TABLE,
+                         (modal && reporter.update) ? &reporter : NULL,
+                         &result, err, sizeof(err));
+    if (modal) ui_loading_modal_finish(modal);
+    if (rc != 0) {
+        show_error_message(err[0] ? err : "Book search failed.");
+        return UI_MENU_BACK;
+    }
+    if (result.total_matches == 0) {
+        book_search_result_free(&result);
+        show_error_message("No matches found in this book.");
+        return UI_MENU_BACK;
+    }
+
+    int cap = 0;
+    for (int t = 0; t < result.table_count; ++t) {
+        if (result.tables[t].match_count > 0 || result.tables[t].error) cap += 1 + result.tables[t].hit_count;
+    }
+    char **labels = calloc((size_t)cap, sizeof(char *));
+    BookSearchItem *items = calloc((size_t)cap, sizeof(BookSearchItem));
+    int count = 0;
+    if (!labels || !items) {
+        free(labels);
+        free(items);
+        book_search_result_free(&result);
+        show_error_message("Out of memory");
+        return UI_MENU_BACK;
+    }
+    for (int t = 0; t < result.table_count; ++t) {
+        const BookSearchTable *bt = &result.tables[t];
+        char buf[256];
+        if (bt->match_count == 0 && !bt->error) continue;
+        if (bt->error) {
+            snprintf(buf, sizeof(buf), "%s (not searched: %s)", bt->name, bt->error);
+        } else if (bt->match_count > bt->hit_count) {
+            snprintf(buf, sizeof(buf), "%s (%d matches, first %d shown)", bt->name, bt->match_count, bt->hit_count);
+        } else {
+            snprintf(buf, sizeof(buf), "%s (%d match%s)", bt->name, bt->match_count, bt->match_count == 1 ? "" : "es");
+        }
+        labels[count] = strdup(buf);
+        items[count].table_index = t;
+        items[count].hit_index = -1;
+        count++;
+        for (int h = 0; h < bt->hit_count; ++h) {
+            snprintf(buf, sizeof(buf), "    Row %d, Col %d: %s", bt->hits[h].row + 1, bt->hits[h].col + 1,
+                     bt->hits[h].text ? bt->hits[h].text : "");
+            labels[count] = strdup(buf);
+            items[count].table_index = t;
+            items[count].hit_index = h;
+            count++;
+        }
+    }
+
+    char title[192];
+    UiMenuResult out = UI_MENU_BACK;
+    snprintf(title, sizeof(title), "Book matches for \"%s\": %d", query, result.total_matches);
+    int pick = draw_simple_list_modal(title, (const char **)labels, count, 0);
+    if (pick >= 0) {
+        const BookSearchTable *bt = &result.tables[items[pick].table_index];
+        int h = items[pick].hit_index;
+        // A heading jumps to the table's first hit
+        if (h < 0 && bt->hit_count > 0) h = 0;
+        if (bt->error || h < 0) {
+            show_error_message(bt->error ? bt->error : "No hits to show.");
+        } else if (!bt->active && workspace_switch_table(table, bt->id, err, sizeof(err)) != 0) {
+            show_error_message(err[0] ? err : "Failed to switch table.");
+        } else {
+            reset_table_view_state(table);
+            ui_search_select_cell(table, query, bt->hits[h].row, bt->hits[h].col);
+            out = UI_MENU_DONE;
+        }
+    }
+
+    free_string_list(labels, count);
+    free(items);
+    book_search_result_free(&result);
+    return out;
+}
+
+static int is_sql_ident_char(char c)
+{
+    return isalnum((unsigned char)c) || c == '_' || c == '$' || (unsigned char)c >= 0x80;
+}
+
+// Whether sql names the table: name occurs (any case) as a whole identifier,
+// bare or quoted, not inside a longer one ("a" does not match "name")
+static int sql_mentions_table(const char *sql, const char *name)
+{
+    size_t len = strlen(name);
+
+    for (const char *p = sql; (p = strcasestr(p, name)) != NULL; ++p) {
+        int starts = (p == sql) || !is_sql_ident_char(p[-1]) || !is_sql_ident_char(name[0]);
+        int ends = !is_sql_ident_char(p[len]) || !is_sql_ident_char(name[len - 1]);
+        if (starts && ends) return 1;
+    }
+    return 0;
+}
+
+// Runs one SELECT over the book: the active table is read in place through
+// the ttb_table virtual table, book tables the query names are loaded from
+// disk for it. The result opens as a new book table.
+static UiMenuResult show_sql_query_page(Table *table)
+{
+    char sql[1024] = {0};
+    char err[256] = {0};
+    char **names = NULL, **ids = NULL;
+    int count = 0, n = 0;
+    const Table **tables = NULL;
+    Table **loaded = NULL;
+    Table *result = NULL;
+    ProgressReporter reporter;
+    UiLoadingModal *modal;
+
+    if (seek_mode_active()) {
+        show_error_message("SQL queries are unavailable in the low-RAM database view.");
+        return UI_MENU_BACK;
+    }
+    if (show_text_input_modal("SQL Query",
+                              "[Enter] Run   [Esc] Back   Tables by name, rowid = stored row",
+                              "SELECT statement:",
+                              sql,
+                              sizeof(sql),
+                              false) <= 0) {
+        return UI_MENU_BACK;
+    }
+    if (workspace_list_book_tables(&names, &ids, &count, err, sizeof(err)) != 0) {
+        show_error_message(err[0] ? err : "Failed to list book tables.");
+        return UI_MENU_BACK;
+    }
+    tables = calloc((size_t)count + 1, sizeof(*tables));
+    loaded = calloc((size_t)count + 1, sizeof(*loaded));
+    if (!tables || !loaded) {
+        snprintf(err, sizeof(err), "Out of memory");
+        goto done;
+    }
+
+    // The active table goes first, so it wins over a book table of the same name
+    tables[n++] = table;
+    const char *active_id = workspace_active_table_id();
+    for (int i = 0; i < count; ++i) {
+        if ((active_id && strcmp(ids[i], active_id) == 0) || !names[i][0] || !sql_mentions_table(sql, names[i])) continue;
+        if (!(loaded[i] = ttbx_load_table(workspace_project_path(), ids[i], err, sizeof(err)))) goto done;
+        // Queried under the name the book lists it by
+        if (!loaded[i]->name || strcmp(loaded[i]->name, names[i]) != 0) {
+            free(loaded[i]->name);
+            loaded[i]->name = strdup(names[i]);
+        }
+        tables[n++] = loaded[i];
+    }
+
+    modal = ui_loading_modal_start("SQL Query", "Running query...", &reporter);
+    result = table_sql_query(sql, tables, n, "Query Result", err, sizeof(err));
+    if (modal) ui_loading_modal_finish(modal);
+
+done:
+    for (int i = 0; loaded && i < count; ++i) free_table(loaded[i]);
+    free(loaded);
+    free(tables);
+    free_string_list(names, count);
+    free_string_list(ids, count);
+    if (!result) {
+        show_error_message(err[0] ? err : "Query failed.");
+        return UI_MENU_BACK;
+    }
+    if (workspace_new_table(table, err, sizeof(err)) != 0) {
+        free_table(result);
+        show_error_message(err[0] ? err : "Failed to create table.");
+        return UI_MENU_BACK;
+    }
+    replace_table_contents(table, result);
+    reset_table_view_state(table);
+    cursor_row = -1; cursor_col = 0; col_page = 0;
+    if (workspace_manual_save(table, err, sizeof(err)) != 0) {
+        show_error_message(err[0] ? err : "Failed to save the query result.");
+    } else {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Query returned %d row%s.", table->row_count, table->row_count == 1 ? "" : "s");
+        show_error_message(msg);
+    }
+    return UI_MENU_DONE;
+}
+
+// Low-RAM seek view: SQLite filters and sorts (seek_mode_apply_view), so the
+// spec is pushed down and each fetched window is shown as is.
+static int seek_view_active(void)
+{
+    return seek_mode_active();
+}
+
+// Applies next to the seek view and adopts it; on failure the current
+// spec is re-applied so the window stays consistent.
+static int push_down_view(Table *table, TableView next, char *err, size_t err_sz)
+{
+    ProgressReporter reporter;
+    UiLoadingModal *modal;
+    int page = (rows_visible > 0) ? rows_visible : 200;
+    int rc;
+
+    next.row_map = NULL;
+    next.row_map_count = 0;
+    next.pushed_down = next.filter_active || next.sort_active;
+    modal = ui_loading_modal_start("Database View", "Updating view (first use may build an index)...", &reporter);
+    rc = seek_mode_apply_view(table, &next, page, err, err_sz);
+    if (rc < 0) seek_mode_apply_view(table, &ui_table_view, page, NULL, 0);
+    if (modal) ui_loading_modal_finish(modal);
+    if (rc < 0) return -1;
+
+    tableview_free(&ui_table_view);
+    ui_table_view = next;
+    cursor_row = (table->row_count > 0) ? 0 : -1;
+    cursor_col = 0;
+    row_page = 0;
+    col_page = 0;
+    return 0;
+}
+
 void prompt_sort_rows(Table *table)
 {
     if (!table || table->column_count <= 0) {
         show_error_message("Add at least one column first.");
         return;
     }
-    if (low_ram_mode) {
+    if (low_ram_mode && !seek_mode_active()) {
         show_error_message("Sort is disabled in low-RAM mode.");
         return;
     }
@@ -764,7 +1040,13 @@ void prompt_sort_rows(Table *table)
         if (selected_order < 0) continue;
 
         char err[256] = {0};
-        if (tableview_sort(table, &ui_table_view, selected_col, selected_order == 1, err, sizeof(err)) != 0) {
+        if (seek_view_active()) {
+            TableView next = ui_table_view;
+            next.sort_active = 1;
+            next.sort_col = selected_col;
+            next.sort_desc = (selected_order == 1);
+            if (push_down_view(table, next, err, sizeof(err)) != 0) show_error_message(err[0] ? err : "Failed to sort rows.");
+        } else if (tableview_sort(table, &ui_table_view, selected_col, selected_order == 1, err, sizeof(err)) != 0) {
             show_error_message(err[0] ? err : "Failed to sort rows.");
         } else {
             cursor_row = (ui_visible_row_count(table) > 0) ? 0 : -1;
@@ -785,7 +1067,7 @@ void prompt_filter_rows(Table *table)
         show_error_message("Add at least one column first.");
         return;
     }
-    if (low_ram_mode) {
+    if (low_ram_mode && !seek_mode_active()) {
         show_error_message("Filter is disabled in low-RAM mode.");
         return;
     }
@@ -818,7 +1100,7 @@ void prompt_filter_rows(Table *table)
     }
 
     while (1) {
-        const char *op_items[] = {"Contains", "Equals", ">", "<", ">=", "<="};
+        const char *op_items[] = {"Contains", "Equals", ">", "<", ">=", "<=", "Matches Regex"};
         int restart_column = 0;
 
         selected_col = draw_simple_list_modal("Filter Rows By Column", labels, table->column_count, selected_col);
@@ -827,7 +1109,7 @@ void prompt_filter_rows(Table *table)
         while (1) {
             char err[256] = {0};
 
-            selected_op = draw_simple_list_modal("Filter Operator", op_items, 6, selected_op);
+            selected_op = draw_simple_list_modal("Filter Operator", op_items, 7, selected_op);
             if (selected_op < 0) {
                 restart_column = 1;
                 break;
@@ -835,7 +1117,7 @@ void prompt_filter_rows(Table *table)
 
             if (show_text_input_modal("Filter Rows",
                                       "[Enter] Apply   [Esc] Back",
-                                      "Filter value:",
+                                      selected_op == FILTER_REGEX ? "Pattern:" : "Filter value:",
                                       value,
                                       sizeof(value),
                                       false) < 0) {
@@ -847,7 +1129,15 @@ void prompt_filter_rows(Table *table)
             rule.op = (FilterOp)selected_op;
             strncpy(rule.value, value, sizeof(rule.value) - 1);
 
-            if (tableview_apply_filter(table, &ui_table_view, &rule, err, sizeof(err)) != 0) {
+            if (seek_view_active()) {
+                TableView next = ui_table_view;
+                next.filter_active = 1;
+                next.filter_rule = rule;
+                if (push_down_view(table, next, err, sizeof(err)) != 0) {
+                    show_error_message(err[0] ? err : "Failed to apply filter.");
+                    continue;
+                }
+            } else if (tableview_apply_filter(table, &ui_table_view, &rule, err, sizeof(err)) != 0) {
                 show_error_message(err[0] ? err : "Failed to apply filter.");
                 continue;
             }
@@ -873,11 +1163,16 @@ void clear_table_view_prompt(Table *table)
 {
     char err[256] = {0};
 
-    (void)table;
     if (!ui_table_view_is_active()) {
         show_error_message("No active sort or filter.");
         return;
     }
+    if (seek_view_active()) {
+        TableView next;
+        tableview_init(&next);
+        if (push_down_view(table, next, err, sizeof(err)) != 0) show_error_message(err[0] ? err : "Failed to clear view.");
+        return;
+    }
     tableview_clear_filter(&ui_table_view);
     tableview_clear_sort(&ui_table_view);
     if (ui_rebuild_table_view(table, err, sizeof(err)) != 0) {
@@ -890,6 +1185,66 @@ void clear_table_view_prompt(Table *table)
     col_page = 0;
 }
 
+// Jumps to a row number or a percentage of the visible rows. The seek view
+// counts and locates rows through its checkpoint index.
+void prompt_goto_row(Table *table)
+{
+    char input[32] = {0};
+    char *end = NULL;
+    double value;
+    long long total;
+    long long row;
+    int percent;
+
+    if (!table) return;
+    if (show_text_input_modal("Go to Row",
+                              "[Enter] Go   [Esc] Cancel",
+                              "Row or percent (e.g. 50%):",
+                              input,
+                              sizeof(input),
+                              false) <= 0) {
+        return;
+    }
+    value = strtod(input, &end);
+    while (isspace((unsigned char)*end)) end++;
+    percent = (*end == '%');
+    if (percent) end++;
+    while (isspace((unsigned char)*end)) end++;
+    if (end == input || *end != '\0' || value < 0) {
+        show_error_message("Enter a row number or a percentage.");
+        return;
+    }
+
+    total = seek_view_active() ? seek_mode_row_total() : ui_visible_row_count(table);
+    if (percent) {
+        if (total < 0) {
+            show_error_message("Rows are still being indexed; try again shortly.");
+            return;
+        }
+        if (value > 100) value = 100;
+        row = (long long)(value / 100.0 * (double)total);
+    } else {
+        row = (long long)((value > 1e18) ? 1e18 : value);  // clamped to the view below
+    }
+    if (row < 1) row = 1;
+
+    if (seek_view_active()) {
+        char err[256] = {0};
+        int page = (rows_visible > 0) ? rows_visible : 200;
+        if (seek_mode_goto_row(table, row, page, err, sizeof(err)) < 0) {
+            show_error_message(err[0] ? err : "Failed to go to row.");
+            return;
+        }
+        cursor_row = -1;
+        row_page = 0;
+        return;
+    }
+    if (total <= 0) return;
+    if (row > total) row = total;
+    cursor_row = -1;
+    row_page = (rows_visible > 0) ? (int)((row - 1) / rows_visible) : 0;
+}
+
 void show_table_menu(Table *table) {
     int keep_open = 1;
 
@@ -900,6 +1255,8 @@ void show_table_menu(Table *table) {
             {TABLE_MENU_ROW_ACTION, "Rename Table", TABLE_MENU_ACTION_RENAME_TABLE},
             {TABLE_MENU_ROW_ACTION, "New Table", TABLE_MENU_ACTION_NEW_TABLE},
             {TABLE_MENU_ROW_ACTION, "Book Tables", TABLE_MENU_ACTION_BOOK_TABLES},
+            {TABLE_MENU_ROW_ACTION, "Search Book", TABLE_MENU_ACTION_SEARCH_BOOK},
+            {TABLE_MENU_ROW_ACTION, "SQL Query", TABLE_MENU_ACTION_SQL_QUERY},
             {TABLE_MENU_ROW_SPACER, "", -1},
             {TABLE_MENU_ROW_HEADING, "View", -1},
             {TABLE_MENU_ROW_UNDERLINE, "View", -1},
@@ -1049,7 +1406,17 @@ void show_table_menu(Table *table) {
             case TABLE_MENU_ACTION_BOOK_TABLES:
                 if (show_book_tables_page(table) == UI_MENU_DONE) keep_open = 0;
                 break;
+            case TABLE_MENU_ACTION_SEARCH_BOOK:
+                if (show_book_search_page(table) == UI_MENU_DONE) keep_open = 0;
+                break;
+            case TABLE_MENU_ACTION_SQL_QUERY:
+                if (show_sql_query_page(table) == UI_MENU_DONE) keep_open = 0;
+                break;
             case TABLE_MENU_ACTION_NEW_TABLE: {
+                if (seek_mode_active()) {
+                    show_error_message("New tables are unavailable in the low-RAM database view.");
+                    break;
+                }
                 if (table->column_count > 0 && !workspace_autosave_enabled()) {
                     int h = 5; int w = COLS - 4; int y = (LINES - h) / 2; int x = 2;
                     PmNode *sh = pm_add(y + 1, x + 2, h, w, PM_LAYER_MODAL_SHADOW, PM_LAYER_MODAL_SHADOW);
@@ -1085,6 +1452,25 @@ void show_table_menu(Table *table) {
     }
 }
 
+enum { SEEK_EXPORT_CSV, SEEK_EXPORT_XLSX, SEEK_EXPORT_DB };
+
+// The seek view only holds a window of rows: stream the whole view (its
+// filter and order included) out of SQLite instead
+static int export_seek_view(int format, const Table *table, const char *path, char *err, size_t err_sz)
+{
+    ProgressReporter reporter;
+    UiLoadingModal *modal = ui_loading_modal_start("Export", "Exporting rows...", &reporter);
+    const ProgressReporter *progress = modal ? &reporter : NULL;
+    const char *name = table->name ? table->name : "Sheet1";
+    long long rows;
+
+    if (format == SEEK_EXPORT_CSV) rows = seek_mode_export_csv(path, progress, err, err_sz);
+    else if (format == SEEK_EXPORT_XLSX) rows = seek_mode_export_xlsx(name, path, progress, err, err_sz);
+    else rows = seek_mode_export_db(name, path, progress, err, err_sz);
+    if (modal) ui_loading_modal_finish(modal);
+    return rows < 0 ? -1 : 0;
+}
+
 UiMenuResult show_export_menu(Table *table) {
     /* Selection uses keys only: hide cursor */
     while (1) {
@@ -1180,6 +1566,8 @@ UiMenuResult show_export_menu(Table *table) {
         } else if (selected == 1) {
             if (build_export_path(outpath, sizeof(outpath), directory, filename, ".ttbx") != 0) {
                 show_error_message("Export path is too long.");
+            } else if (seek_mode_active()) {
+                show_error_message("Book exports are unavailable in the low-RAM database view.");
             } else if (workspace_export_book(outpath, err, sizeof(err)) != 0) {
                 show_error_message(err[0] ? err : "Failed to export .ttbx");
             } else {
@@ -1188,7 +1576,8 @@ UiMenuResult show_export_menu(Table *table) {
         } else if (selected == 2) {
             if (build_export_path(outpath, sizeof(outpath), directory, filename, ".csv") != 0) {
                 show_error_message("Export path is too long.");
-            } else if (csv_save(table, outpath, err, sizeof(err)) != 0) {
+            } else if (seek_mode_active() ? export_seek_view(SEEK_EXPORT_CSV, table, outpath, err, sizeof(err)) != 0
+                                          : csv_save(table, outpath, err, sizeof(err)) != 0) {
                 show_error_message(err[0] ? err : "Failed to save CSV");
             } else {
                 show_error_message("Exported CSV.");
@@ -1196,7 +1585,8 @@ UiMenuResult show_export_menu(Table *table) {
         } else if (selected == 3) {
             if (build_export_path(outpath, sizeof(outpath), directory, filename, ".xlsx") != 0) {
                 show_error_message("Export path is too long.");
-            } else if (xl_save(table, outpath, err, sizeof(err)) != 0) {
+            } else if (seek_mode_active() ? export_seek_view(SEEK_EXPORT_XLSX, table, outpath, err, sizeof(err)) != 0
+                                          : xl_save(table, outpath, err, sizeof(err)) != 0) {
                 show_error_message(err[0] ? err : "Failed to save XLSX");
             } else {
                 show_error_message("Exported XLSX.");
@@ -1222,7 +1612,11 @@ UiMenuResult show_export_menu(Table *table) {
             }
             if (build_export_path(outpath, sizeof(outpath), directory, filename, ".db") != 0) {
                 show_error_message("Export path is too long.");
-            } else if ((scope_pick == 0 && db_export_table_path(table, outpath, err, sizeof(err)) != 0) ||
+            } else if (scope_pick == 1 && seek_mode_active()) {
+                show_error_message("Book exports are unavailable in the low-RAM database view.");
+            } else if ((scope_pick == 0 && seek_mode_active() &&
+                        export_seek_view(SEEK_EXPORT_DB, table, outpath, err, sizeof(err)) != 0) ||
+                       (scope_pick == 0 && !seek_mode_active() && db_export_table_path(table, outpath, err, sizeof(err)) != 0) ||
                 (scope_pick == 1 && workspace_export_book_db(outpath, err, sizeof(err)) != 0)) {
                 show_error_message(err[0] ? err : "Failed to export SQLite DB");
             } else {
@@ -1,43 +1,117 @@
 #include <sqlite3.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <strings.h>
 #include "ui.h"
 #include "seekdb.h"
+#include "seekdb_pool.h"
+#include "settings.h"
 #include "errors.h"
+#include "cell_arena.h"
+#include "table_ops.h"
+#include "csv.h"
+#include "xl.h"
+#include "db_manager.h"
+
+// How a window can be fetched again: it is what seek_after(after_anchor)
+// and/or seek_before(before_anchor) return for page_size rows (after_anchor
+// LLONG_MIN is the first window). Keys the window cache.
+typedef struct {
+    int page_size;
+    int has_after, has_before;
+    long long after_anchor, before_anchor;
+} WindowLinks;
 
 typedef struct {
     seekdb *s;
     char table[256];
     char key[64];
+    const Table *view; // the table the windows go into
     int key_col; // index in current view, -1 unknown
     long long first_id;
     long long last_id;
     int active;
     long long row_base;   // 1-based index of first row in current window
     int last_count;       // size of last window fetched
+    WindowLinks links;    // of the current window
+    seekdb_checkpoints *checkpoints; // row positions of the view, once built
+    seekdb_pool *pool;    // background readers over the view (NULL: none)
+    // Columns [want_lo, want_hi) (plus the key) are what window reads fetch;
+    // the current window holds [have_lo, have_hi). See seek_mode_show_columns.
+    int want_lo, want_hi;
+    int have_lo, have_hi;
+    int patched;          // window edited in place (inserts/deletes): never cached
+    int order_col;        // view column SQLite sorts on (-1: the key)
+    int filter_col;       // view column SQLite filters on (-1: none)
 } SeekSession;
 
 static SeekSession G = {0};
 
+// Columns fetched for a window before the grid has said what it shows
+#define SEEK_OPEN_COLUMNS 64
+
 // low_ram_mode declared and defined in ui_loop.c
 
+// The cells of a window live in one arena, which moves with the window
+// between the view, the cache and the prefetcher. Arenas of dropped windows
+// are reset and handed to the next fetch (prefetch jobs fetch too,
+// hence the lock).
+#define SEEK_ARENA_CHUNK (16 << 10)
+#define SEEK_SPARE_ARENAS 4
+
+static struct {
+    pthread_mutex_t lock;
+    CellArena *spare[SEEK_SPARE_ARENAS];
+    int n;
+} A = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static CellArena *arena_get(void) {
+    CellArena *a = NULL;
+    pthread_mutex_lock(&A.lock);
+    if (A.n > 0) a = A.spare[--A.n];
+    pthread_mutex_unlock(&A.lock);
+    return a ? a : cell_arena_create(SEEK_ARENA_CHUNK);
+}
+
+static void arena_put(CellArena *a) {
+    if (!a) return;
+    cell_arena_reset(a);
+    pthread_mutex_lock(&A.lock);
+    if (A.n < SEEK_SPARE_ARENAS) { A.spare[A.n++] = a; a = NULL; }
+    pthread_mutex_unlock(&A.lock);
+    cell_arena_free(a);
+}
+
+static void arena_drain(void) {
+    pthread_mutex_lock(&A.lock);
+    while (A.n > 0) cell_arena_free(A.spare[--A.n]);
+    pthread_mutex_unlock(&A.lock);
+}
+
 static void clear_table_rows(Table *t) {
     if (!t) return;
+    table_invalidate_fold_keys(t, -1);
     for (int i = 0; i < t->row_count; ++i) {
         if (t->rows[i].values) {
-            for (int j = 0; j < t->column_count; ++j) {
-                if (t->rows[i].values[j]) free(t->rows[i].values[j]);
-            }
+            for (int j = 0; j < t->column_count; ++j) cell_free(t->arena, t->rows[i].values[j]);
             free(t->rows[i].values);
         }
     }
     free(t->rows);
     t->rows = NULL; t->row_count = 0; t->capacity_rows = 0;
+    arena_put(t->arena);
+    t->arena = NULL;
 }
 
 static void clear_table_columns(Table *t) {
     if (!t) return;
+    table_invalidate_fold_keys(t, -1);
     for (int j = 0; j < t->column_count; ++j) if (t->columns[j].name) free(t->columns[j].name);
     free(t->columns); t->columns = NULL; t->column_count = 0; t->capacity_columns = 0;
 }
@@ -49,143 +123,1294 @@ static void ensure_key_col(const char *const*names, int n) {
     }
 }
 
-static int fill_columns(Table *view, char **names, int count) {
-    // All columns are displayed as strings for the view; types can be refined later
+// Grid type for a declared column type, by SQLite's affinity rules. BOOL is
+// checked first: it has NUMERIC affinity but is how booleans get declared.
+static DataType type_from_decl(const char *decl) {
+    char up[64];
+    size_t i;
+    if (seekdb_decl_is_bool(decl)) return TYPE_BOOL;
+    for (i = 0; decl && decl[i] && i < sizeof(up) - 1; ++i) up[i] = (char)toupper((unsigned char)decl[i]);
+    up[i] = '\0';
+    if (strstr(up, "INT")) return TYPE_INT;
+    if (strstr(up, "CHAR") || strstr(up, "CLOB") || strstr(up, "TEXT")) return TYPE_STR;
+    if (strstr(up, "REAL") || strstr(up, "FLOA") || strstr(up, "DOUB")) return TYPE_FLOAT;
+    return TYPE_STR;
+}
+
+static int fill_columns(Table *view, char **names, char **decls, int count) {
+    // Types follow the schema; a column holding values its type cannot
+    // represent turns into text once a window meets one (apply_window)
     clear_table_columns(view);
     for (int i = 0; i < count; ++i) {
-        add_column(view, names[i], TYPE_STR);
+        add_column(view, names[i], decls ? type_from_decl(decls[i]) : TYPE_STR);
     }
     return 0;
 }
 
-typedef struct { Table *t; int reverse; long long first; long long last; } FillCtx;
+// Reads column j of row as type into a (NULL for SQL NULL in a typed
+// column). Returns 1 when the value does not fit the type, -1 when out of
+// memory.
+static int read_cell(CellArena *a, DataType type, sqlite3_stmt *row, int j, void **out) {
+    int kind = sqlite3_column_type(row, j);
 
-static bool stream_row(void *user, sqlite3_stmt *row) {
-    FillCtx *fc = (FillCtx*)user;
-    int cols = sqlite3_column_count(row);
-    char **vals = (char**)malloc(sizeof(char*) * cols);
-    for (int j = 0; j < cols; ++j) {
-        const unsigned char *txt = sqlite3_column_text(row, j);
-        if (txt) vals[j] = strdup((const char*)txt);
-        else vals[j] = strdup("");
+    *out = NULL;
+    if (kind == SQLITE_NULL && type != TYPE_STR) return 0;
+    switch (type) {
+        case TYPE_INT:
+        case TYPE_BOOL: {
+            sqlite3_int64 v;
+            int *p;
+            if (kind != SQLITE_INTEGER) return 1;
+            v = sqlite3_column_int64(row, j);
+            if (v < INT_MIN || v > INT_MAX || (type == TYPE_BOOL && v != 0 && v != 1)) return 1;
+            if (!(p = cell_arena_alloc(a, sizeof(int)))) return -1;
+            *p = (int)v;
+            *out = p;
+            return 0;
+        }
+        case TYPE_FLOAT: {
+            float *p;
+            if (kind != SQLITE_INTEGER && kind != SQLITE_FLOAT) return 1;
+            if (!(p = cell_arena_alloc(a, sizeof(float)))) return -1;
+            *p = (float)sqlite3_column_double(row, j);
+            *out = p;
+            return 0;
+        }
+        default: {
+            const unsigned char *txt = sqlite3_column_text(row, j);
+            size_t len = txt ? (size_t)sqlite3_column_bytes(row, j) : 0;
+            *out = cell_arena_strndup(a, txt ? (const char*)txt : "", len);
+            return *out ? 0 : -1;
+        }
     }
-    add_row(fc->t, (const char**)vals);
-    // track ids
-    int key_idx = G.key_col;
-    if (key_idx >= 0) {
-        sqlite3_int64 id = sqlite3_column_int64(row, key_idx);
-        if (fc->t->row_count == 1) fc->first = id; // first row delivered
-        fc->last = id;
+}
+
+// Text of a typed cell, as a string column would hold it
+static void cell_text(DataType type, const void *v, char *buf, size_t sz) {
+    if (!v) { buf[0] = '\0'; return; }
+    switch (type) {
+        case TYPE_INT: snprintf(buf, sz, "%d", *(const int*)v); break;
+        case TYPE_FLOAT: snprintf(buf, sz, "%g", *(const float*)v); break;
+        case TYPE_BOOL: snprintf(buf, sz, "%s", *(const int*)v ? "true" : "false"); break;
+        default: snprintf(buf, sz, "%s", (const char*)v); break;
     }
-    for (int j = 0; j < cols; ++j) { free(vals[j]); }
-    free(vals);
-    return true;
 }
 
-// For seek_before, accumulate then reverse to ascending order for display
-typedef struct { int cols; int cap; int n; char ***rows; long long *ids; } Buf;
+// Parses text as type into a; same results as read_cell ("" is NULL)
+static int parse_cell(CellArena *a, DataType type, const char *text, void **out) {
+    char *end;
+    long long v;
+    int *p;
 
-static void buf_init(Buf *b, int cols) { b->cols = cols; b->cap = 0; b->n = 0; b->rows = NULL; b->ids = NULL; }
-static void buf_push(Buf *b, sqlite3_stmt *row, int key_idx) {
-    if (b->n == b->cap) {
-        b->cap = b->cap ? b->cap * 2 : 16;
-        b->rows = (char***)realloc(b->rows, sizeof(char**) * b->cap);
-        b->ids = (long long*)realloc(b->ids, sizeof(long long) * b->cap);
+    *out = NULL;
+    if (type == TYPE_STR) {
+        *out = cell_arena_strndup(a, text, strlen(text));
+        return *out ? 0 : -1;
     }
-    char **vals = (char**)malloc(sizeof(char*) * b->cols);
-    for (int j = 0; j < b->cols; ++j) {
-        const unsigned char *txt = sqlite3_column_text(row, j);
-        vals[j] = strdup(txt ? (const char*)txt : "");
+    if (!*text) return 0;
+    if (type == TYPE_FLOAT) {
+        double d = strtod(text, &end);
+        float *f;
+        if (*end) return 1;
+        if (!(f = cell_arena_alloc(a, sizeof(float)))) return -1;
+        *f = (float)d;
+        *out = f;
+        return 0;
+    }
+    if (type == TYPE_BOOL) {
+        if (strcmp(text, "true") == 0) v = 1;
+        else if (strcmp(text, "false") == 0) v = 0;
+        else return 1;
+    } else {
+        errno = 0;
+        v = strtoll(text, &end, 10);
+        if (*end || errno || v < INT_MIN || v > INT_MAX) return 1;
+    }
+    if (!(p = cell_arena_alloc(a, sizeof(int)))) return -1;
+    *p = (int)v;
+    *out = p;
+    return 0;
+}
+
+// A fetched window in display order. Cells are in arena, except ones put
+// there by edits while the window was in view (hence cell_free). Only
+// columns [lo, hi) and the key were fetched; the other cells are NULL.
+typedef struct {
+    int cols; int key_col; int cap; int n;
+    int lo, hi;
+    void ***rows; long long *ids;
+    DataType *types;   // of each column's cells
+    CellArena *arena;
+    int failed;        // out of memory while collecting
+} Buf;
+
+static void buf_init(Buf *b, int cols, int key_col, const DataType *types) {
+    memset(b, 0, sizeof(*b));
+    b->cols = cols; b->key_col = key_col;
+    b->lo = 0; b->hi = cols;
+    if (cols <= 0) return;
+    b->types = malloc(sizeof(DataType) * (size_t)cols);
+    if (!b->types) { b->failed = 1; return; }
+    for (int j = 0; j < cols; ++j) b->types[j] = types ? types[j] : TYPE_STR;
+}
+
+// Typed like the view's columns (all text when the shapes differ)
+static void buf_init_like(Buf *b, const Table *view, int cols) {
+    buf_init(b, cols, G.key_col, NULL);
+    if (b->types && view->column_count == cols) {
+        for (int j = 0; j < cols; ++j) b->types[j] = view->columns[j].type;
+    }
+}
+
+// Result column of a window read holding column j, -1 when not fetched
+static int buf_source_col(const Buf *b, int j) {
+    if (j >= b->lo && j < b->hi) return j - b->lo;
+    if (j == b->key_col) return b->hi - b->lo; // selected after the range
+    return -1;
+}
+
+static int buf_covers(const Buf *b, int lo, int hi) {
+    return b->lo <= lo && b->hi >= hi;
+}
+
+// Rows moved into a Table (apply_window) are NULL here
+static void buf_free(Buf *b) {
+    for (int i = 0; i < b->n; ++i) {
+        if (!b->rows[i]) continue;
+        for (int j = 0; j < b->cols; ++j) cell_free(b->arena, b->rows[i][j]);
+        free(b->rows[i]);
+    }
+    arena_put(b->arena);
+    free(b->rows); free(b->ids); free(b->types);
+    memset(b, 0, sizeof(*b));
+}
+
+// Re-types column j of every row. Refuses (1) unless every cell converts
+// without loss; -1 when out of memory.
+static int buf_retype_column(Buf *b, int j, DataType type) {
+    DataType from = b->types[j];
+    void **cells = NULL;
+    char text[64];
+
+    if (from == type) return 0;
+    if (b->n > 0) {
+        if (!b->arena && !(b->arena = arena_get())) return -1;
+        if (!(cells = malloc(sizeof(void*) * (size_t)b->n))) return -1;
     }
+    for (int i = 0; i < b->n; ++i) {
+        const void *v = b->rows[i][j];
+        const char *src = text;
+        int rc;
+        if (from == TYPE_STR) src = v ? (const char*)v : "";
+        else cell_text(from, v, text, sizeof(text));
+        rc = parse_cell(b->arena, type, src, &cells[i]);
+        if (rc != 0) { free(cells); return rc; }
+    }
+    for (int i = 0; i < b->n; ++i) {
+        cell_free(b->arena, b->rows[i][j]);
+        b->rows[i][j] = cells[i];
+    }
+    free(cells);
+    b->types[j] = type;
+    return 0;
+}
+
+static int buf_push(Buf *b, sqlite3_stmt *row) {
+    void **vals;
+
+    if (b->n == b->cap) {
+        int cap = b->cap ? b->cap * 2 : 16;
+        void ***rows = realloc(b->rows, sizeof(void**) * (size_t)cap);
+        long long *ids;
+        if (!rows) return -1;
+        b->rows = rows;
+        if (!(ids = realloc(b->ids, sizeof(long long) * (size_t)cap))) return -1;
+        b->ids = ids;
+        b->cap = cap;
+    }
+    if (!b->arena && !(b->arena = arena_get())) return -1;
+    if (!(vals = calloc((size_t)b->cols, sizeof(void*)))) return -1;
     b->rows[b->n] = vals;
-    b->ids[b->n] = (key_idx >= 0) ? sqlite3_column_int64(row, key_idx) : 0;
+    b->ids[b->n] = (b->key_col >= 0) ? sqlite3_column_int64(row, buf_source_col(b, b->key_col)) : 0;
     b->n++;
+    for (int j = 0; j < b->cols; ++j) {
+        int k = buf_source_col(b, j);
+        int rc;
+        if (k < 0) continue;
+        rc = read_cell(b->arena, b->types[j], row, k, &vals[j]);
+        // A value the column's type cannot hold turns the column into text
+        if (rc > 0 && (rc = buf_retype_column(b, j, TYPE_STR)) == 0) {
+            rc = read_cell(b->arena, TYPE_STR, row, k, &vals[j]);
+        }
+        if (rc != 0) return -1;
+    }
+    return 0;
 }
-static void buf_free(Buf *b) {
-    for (int i = 0; i < b->n; ++i) { for (int j = 0; j < b->cols; ++j) free(b->rows[i][j]); free(b->rows[i]); }
-    free(b->rows); free(b->ids);
+
+// seek_before delivers nearest first; flip into display order
+static void buf_reverse(Buf *b) {
+    for (int i = 0, j = b->n - 1; i < j; ++i, --j) {
+        void **r = b->rows[i]; b->rows[i] = b->rows[j]; b->rows[j] = r;
+        long long id = b->ids[i]; b->ids[i] = b->ids[j]; b->ids[j] = id;
+    }
 }
 
 static bool collect_row(void *user, sqlite3_stmt *row) {
-    Buf *b = (Buf*)user; buf_push(b, row, G.key_col); return true;
+    Buf *b = (Buf*)user;
+    if (b->failed || buf_push(b, row) != 0) { b->failed = 1; return false; }
+    return true;
+}
+
+// Points s's window reads at b's columns (see buf_source_col)
+static int project_for(seekdb *s, const Buf *b, char *err, size_t err_sz) {
+    int *cols, n = 0, rc;
+
+    if (b->lo == 0 && b->hi >= b->cols) return seekdb_set_projection(s, NULL, 0, err, err_sz);
+    if (!(cols = malloc(sizeof(int) * (size_t)(b->hi - b->lo + 1)))) { snprintf(err, err_sz, "Out of memory"); return -1; }
+    for (int j = b->lo; j < b->hi; ++j) cols[n++] = j;
+    if (b->key_col >= 0 && buf_source_col(b, b->key_col) == n) cols[n++] = b->key_col;
+    rc = seekdb_set_projection(s, cols, n, err, err_sz);
+    free(cols);
+    return rc;
+}
+
+// Recently shown windows, kept so paging back over them costs nothing.
+// Entries are keyed by their WindowLinks and evicted least recently used
+// first once the byte budget is exceeded. Rows move between the view and the
+// cache, so neither a hit nor a retire copies cells. Cleared on every view
+// change.
+typedef struct CacheEntry {
+    Buf buf;              // display order
+    WindowLinks links;
+    size_t bytes;
+    struct CacheEntry *newer, *older;
+} CacheEntry;
+
+typedef struct {
+    CacheEntry *newest, *oldest;
+    size_t bytes;
+    size_t budget;
+    long long hits, misses;
+} WindowCache;
+
+static WindowCache C = { .budget = (size_t)SEEK_CACHE_DEFAULT_MB << 20 };
+
+// Cells left on the heap by edits are not counted
+static size_t window_bytes(const Buf *b) {
+    return sizeof(CacheEntry) + cell_arena_bytes(b->arena) + (size_t)b->cols * sizeof(DataType) +
+           (size_t)b->n * (sizeof(void**) + sizeof(long long) + (size_t)b->cols * sizeof(void*));
+}
+
+static void cache_unlink(CacheEntry *e) {
+    if (e->newer) e->newer->older = e->older; else C.newest = e->older;
+    if (e->older) e->older->newer = e->newer; else C.oldest = e->newer;
+    e->newer = e->older = NULL;
+    C.bytes -= e->bytes;
+}
+
+static void cache_drop(CacheEntry *e) {
+    cache_unlink(e);
+    buf_free(&e->buf);
+    free(e);
+}
+
+static void cache_trim(void) {
+    while (C.oldest && C.bytes > C.budget) cache_drop(C.oldest);
+}
+
+static void cache_clear(void) {
+    while (C.newest) cache_drop(C.newest);
+}
+
+static CacheEntry *cache_find(int dir, long long anchor, int page_size) {
+    for (CacheEntry *e = C.newest; e; e = e->older) {
+        const WindowLinks *l = &e->links;
+        if (l->page_size != page_size || !buf_covers(&e->buf, G.want_lo, G.want_hi)) continue;
+        if (dir > 0 ? (l->has_after && l->after_anchor == anchor)
+                    : (l->has_before && l->before_anchor == anchor)) return e;
+    }
+    return NULL;
+}
+
+// Moves the window reached from anchor in direction dir out of the cache
+static int cache_take(int dir, long long anchor, int page_size, int cols, Buf *out, WindowLinks *links) {
+    CacheEntry *e = cache_find(dir, anchor, page_size);
+    if (e && e->buf.cols != cols) { cache_drop(e); e = NULL; }
+    if (!e) { C.misses++; return 0; }
+    C.hits++;
+    cache_unlink(e);
+    *out = e->buf;
+    *links = e->links;
+    free(e);
+    return 1;
+}
+
+// Keeps the rows of a window leaving the view under the anchors it is known
+// to answer.
+static void cache_put(Buf *b, const WindowLinks *links) {
+    CacheEntry *e;
+    size_t bytes;
+
+    if (C.budget == 0 || b->n == 0 || (!links->has_after && !links->has_before)) { buf_free(b); return; }
+    bytes = window_bytes(b);
+    if (bytes > C.budget || !(e = malloc(sizeof(*e)))) { buf_free(b); return; }
+    // A refetched window replaces its older copy
+    for (CacheEntry *o = C.newest, *next; o; o = next) {
+        const WindowLinks *l = &o->links;
+        next = o->older;
+        if (l->page_size == links->page_size &&
+            ((links->has_after && l->has_after && l->after_anchor == links->after_anchor) ||
+             (links->has_before && l->has_before && l->before_anchor == links->before_anchor))) cache_drop(o);
+    }
+    e->links = *links;
+    e->buf = *b;
+    e->bytes = bytes;
+    e->older = C.newest;
+    e->newer = NULL;
+    if (C.newest) C.newest->newer = e; else C.oldest = e;
+    C.newest = e;
+    C.bytes += bytes;
+    cache_trim();
+}
+
+// Key of a view row, read back from its key column
+static long long row_key(const Table *view, int row) {
+    const void *v = view->rows[row].values[G.key_col];
+    DataType type = view->columns[G.key_col].type;
+    char text[64];
+
+    if (!v) return 0;
+    if (type == TYPE_INT) return *(const int*)v;
+    if (type == TYPE_STR) return strtoll((const char*)v, NULL, 10);
+    cell_text(type, v, text, sizeof(text));
+    return strtoll(text, NULL, 10);
+}
+
+// Moves the view's rows and their arena out into b (ids read back from the
+// key column). A window that no longer matches what was fetched (rows added
+// or deleted) is just freed.
+static int take_window(Table *view, Buf *b) {
+    int n = view->row_count;
+
+    buf_init_like(b, view, view->column_count);
+    if (b->failed || G.key_col < 0 || n == 0 || G.patched || n != G.last_count) { buf_free(b); clear_table_rows(view); return 0; }
+    b->rows = malloc(sizeof(void**) * (size_t)n);
+    b->ids = malloc(sizeof(long long) * (size_t)n);
+    if (!b->rows || !b->ids) { buf_free(b); clear_table_rows(view); return 0; }
+    for (int i = 0; i < n; ++i) {
+        b->rows[i] = view->rows[i].values;
+        b->ids[i] = row_key(view, i);
+    }
+    b->n = b->cap = n;
+    b->lo = G.have_lo; b->hi = G.have_hi;
+    b->arena = view->arena;
+    view->arena = NULL;
+    table_invalidate_fold_keys(view, -1);
+    free(view->rows);
+    view->rows = NULL; view->row_count = 0; view->capacity_rows = 0;
+    return 1;
+}
+
+// The current window leaves the view: keep it under links
+static void retire_window(Table *view, const WindowLinks *links) {
+    Buf b;
+    if (take_window(view, &b)) cache_put(&b, links);
+}
+
+// Background reads run on a small pool of read-only connections
+// (seekdb_pool) over the view, so they never wait behind window fetches.
+// Without a pool the UI fetches synchronously and has no position index.
+#define SEEK_POOL_READERS 3
+
+// The view changed: point the pool's readers at it (opened on first use)
+static void pool_reset(void) {
+    if (G.pool && seekdb_pool_reset(G.pool, G.s, NULL, 0) == 0) return;
+    seekdb_pool_close(G.pool);
+    G.pool = seekdb_pool_open(G.s, SEEK_POOL_READERS, NULL, 0);
+}
+
+// Background prefetch: a pool job loads the windows just past both ends of
+// the current one into ready slots, so a page turn only swaps rows in. One
+// job serves requests until none is pending, so they never pile up.
+typedef struct {
+    Buf buf;
+    long long anchor;   // boundary id the window was fetched from
+    int page_size;
+    unsigned gen;
+    int ready;
+} ReadySlot;
+
+typedef struct {
+    pthread_mutex_t lock;
+    unsigned gen;          // bumped on every view change; older results are dropped
+    int queued;            // a prefetch job waits in the pool
+    int busy;              // one runs for view generation busy_gen
+    unsigned busy_gen;
+    int job_pending;
+    long long job_first;
+    long long job_last;
+    int job_page;
+    DataType *job_types;   // view column types to read windows as
+    int job_cols;
+    int job_lo, job_hi;    // columns to fetch (G.want_lo/hi)
+    int key_col;
+    ReadySlot next;
+    ReadySlot prev;
+} Prefetcher;
+
+static Prefetcher P = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// Both helpers run with P.lock held
+static void slot_clear(ReadySlot *slot) {
+    if (slot->ready) buf_free(&slot->buf);
+    slot->ready = 0;
+}
+
+static void slot_store(ReadySlot *slot, Buf *b, long long anchor, int page_size, unsigned gen) {
+    slot_clear(slot);
+    slot->buf = *b;
+    slot->anchor = anchor;
+    slot->page_size = page_size;
+    slot->gen = gen;
+    slot->ready = 1;
+}
+
+static void prefetch_job(seekdb *reader, void *arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&P.lock);
+    P.queued = 0;
+    unsigned gen = P.gen;
+    P.busy = 1;
+    P.busy_gen = gen;
+    // A view change leaves the rest to a job on a reader over the new view
+    while (reader && P.job_pending && P.gen == gen) {
+        long long first = P.job_first, last = P.job_last;
+        int page = P.job_page, key_col = P.key_col;
+        int type_cols = P.job_cols;
+        int lo = P.job_lo, hi = P.job_hi;
+        DataType *types = type_cols > 0 ? malloc(sizeof(DataType) * (size_t)type_cols) : NULL;
+        if (types) memcpy(types, P.job_types, sizeof(DataType) * (size_t)type_cols);
+        P.job_pending = 0;
+        pthread_mutex_unlock(&P.lock);
+
+        Buf nb, pb;
+        int got_next = -1, got_prev = -1;
+        int cols = seekdb_view_column_count(reader, NULL, 0);
+        buf_init(&nb, cols, key_col, cols == type_cols ? types : NULL);
+        buf_init(&pb, cols, key_col, cols == type_cols ? types : NULL);
+        free(types);
+        if (hi > cols) hi = cols;
+        nb.lo = pb.lo = lo < hi ? lo : 0;
+        nb.hi = pb.hi = lo < hi ? hi : cols;
+        if (cols > 0 && project_for(reader, &nb, NULL, 0) != 0) cols = -1;
+        if (cols > 0) {
+            got_next = seekdb_seek_after(reader, last, page, collect_row, &nb, NULL, 0);
+            got_prev = seekdb_seek_before(reader, first, page, collect_row, &pb, NULL, 0);
+            if (nb.failed) got_next = -1;
+            if (pb.failed) got_prev = -1;
+        }
+
+        pthread_mutex_lock(&P.lock);
+        if (got_next >= 0 && gen == P.gen) slot_store(&P.next, &nb, last, page, gen);
+        else buf_free(&nb);
+        if (got_prev >= 0 && gen == P.gen) slot_store(&P.prev, &pb, first, page, gen);
+        else buf_free(&pb);
+    }
+    if (P.busy_gen == gen) P.busy = 0;
+    pthread_mutex_unlock(&P.lock);
+}
+
+// Rows changed under the ready windows (a write): drop them and whatever
+// the job is reading now; its reader sees the commit on the next read.
+static void prefetch_drop(void) {
+    pthread_mutex_lock(&P.lock);
+    P.gen++;
+    slot_clear(&P.next);
+    slot_clear(&P.prev);
+    P.job_pending = 0;
+    pthread_mutex_unlock(&P.lock);
+}
+
+// The view changed (after pool_reset)
+static void prefetch_reset(void) {
+    prefetch_drop();
+    pthread_mutex_lock(&P.lock);
+    P.key_col = G.key_col;
+    pthread_mutex_unlock(&P.lock);
+}
+
+// Once the pool is closed
+static void prefetch_stop(void) {
+    prefetch_drop();
+    pthread_mutex_lock(&P.lock);
+    free(P.job_types);
+    P.job_types = NULL;
+    P.job_cols = 0;
+    P.queued = 0;
+    P.busy = 0;
+    pthread_mutex_unlock(&P.lock);
+}
+
+// Ask for the windows around the current one
+static void prefetch_schedule(const Table *view, int page_size) {
+    int submit;
+
+    if (!G.pool) return;
+    if (cache_find(+1, G.last_id, page_size) && cache_find(-1, G.first_id, page_size)) return;
+    pthread_mutex_lock(&P.lock);
+    if (P.job_cols != view->column_count) {
+        DataType *types = realloc(P.job_types, sizeof(DataType) * (size_t)(view->column_count > 0 ? view->column_count : 1));
+        if (types) { P.job_types = types; P.job_cols = view->column_count; }
+    }
+    for (int j = 0; j < P.job_cols && j < view->column_count; ++j) P.job_types[j] = view->columns[j].type;
+    P.job_lo = G.want_lo;
+    P.job_hi = G.want_hi;
+    P.job_first = G.first_id;
+    P.job_last = G.last_id;
+    P.job_page = page_size;
+    P.job_pending = 1;
+    // A queued job, or one running on this view, picks the request up
+    submit = !P.queued && !(P.busy && P.busy_gen == P.gen);
+    if (submit) P.queued = 1;
+    pthread_mutex_unlock(&P.lock);
+    if (submit && seekdb_pool_submit(G.pool, prefetch_job, NULL) < 0) {
+        pthread_mutex_lock(&P.lock);
+        P.queued = 0;
+        pthread_mutex_unlock(&P.lock);
+    }
+}
+
+// Takes the ready window past anchor in direction dir, if there is one
+static int prefetch_take(int dir, long long anchor, int page_size, Buf *out) {
+    int hit;
+    if (!G.pool) return 0;
+    pthread_mutex_lock(&P.lock);
+    ReadySlot *slot = (dir > 0) ? &P.next : &P.prev;
+    hit = slot->ready && slot->gen == P.gen && slot->anchor == anchor && slot->page_size == page_size &&
+          buf_covers(&slot->buf, G.want_lo, G.want_hi);
+    if (hit) {
+        *out = slot->buf;
+        slot->ready = 0;
+    }
+    pthread_mutex_unlock(&P.lock);
+    return hit;
+}
+
+// Sparse row-position index (seekdb_checkpoints) for go-to-row and exact
+// gutter numbers after jumps. Built by a pool job and adopted by the UI
+// thread once done (checkpoints_poll).
+#define SEEK_CHECKPOINT_STRIDE 1024
+
+typedef struct {
+    pthread_mutex_t lock;
+    long long job;         // pool job id of the build, 0 when none is out
+    unsigned gen;          // bumped when a build is abandoned
+    int done;
+    seekdb_checkpoints *built;
+} CheckpointBuild;
+
+static CheckpointBuild K = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static void checkpoint_job(seekdb *reader, void *arg) {
+    unsigned gen = (unsigned)(uintptr_t)arg;
+    seekdb_checkpoints *cp = reader ? seekdb_checkpoints_build(reader, SEEK_CHECKPOINT_STRIDE, NULL, 0) : NULL;
+
+    pthread_mutex_lock(&K.lock);
+    if (gen == K.gen) {
+        K.built = cp;
+        K.done = 1;
+        cp = NULL;
+    }
+    pthread_mutex_unlock(&K.lock);
+    seekdb_checkpoints_free(cp);
+}
+
+// Cancels a pending build and drops the index
+static void checkpoints_stop(void) {
+    if (K.job) {
+        seekdb_pool_cancel(G.pool, K.job);
+        K.job = 0;
+    }
+    pthread_mutex_lock(&K.lock);
+    K.gen++;
+    seekdb_checkpoints_free(K.built);
+    K.built = NULL;
+    K.done = 0;
+    pthread_mutex_unlock(&K.lock);
+    seekdb_checkpoints_free(G.checkpoints);
+    G.checkpoints = NULL;
+}
+
+// Rows moved: index the view afresh (without a pool there is no index and
+// jumps report that)
+static void checkpoints_reset(void) {
+    checkpoints_stop();
+    if (!G.pool) return;
+    K.job = seekdb_pool_submit(G.pool, checkpoint_job, (void*)(uintptr_t)K.gen);
+    if (K.job < 0) K.job = 0;
+}
+
+// Adopts a finished build
+static void checkpoints_poll(void) {
+    int done;
+    if (!K.job) return;
+    pthread_mutex_lock(&K.lock);
+    done = K.done;
+    if (done) {
+        G.checkpoints = K.built;
+        K.built = NULL;
+        K.done = 0;
+    }
+    pthread_mutex_unlock(&K.lock);
+    if (!done) return;
+    K.job = 0;
+    // The build walked the whole view, so its total doubles as the exact count
+    if (G.checkpoints) seekdb_count_store(G.s, seekdb_checkpoints_rows(G.checkpoints));
+}
+
+// The view changed: background work on the old one is dropped
+static void background_reset(void) {
+    checkpoints_stop();
+    pool_reset();
+    prefetch_reset();
+    checkpoints_reset();
 }
 
 int seek_mode_active(void) { return G.active; }
 
 void seek_mode_close(void) {
+    checkpoints_stop();
+    seekdb_pool_close(G.pool);
+    G.pool = NULL;
+    prefetch_stop();
+    cache_clear();
+    arena_drain();
+    memset(&G.links, 0, sizeof(G.links));
     if (G.s) { seekdb_close(G.s); G.s = NULL; }
-    G.active = 0; G.key_col = -1; G.first_id = 0; G.last_id = 0;
+    G.active = 0; G.view = NULL; G.key_col = -1; G.first_id = 0; G.last_id = 0;
+    G.patched = 0; G.order_col = -1; G.filter_col = -1;
 }
 
-int seek_mode_open_for_table(const char *db_path, const char *table_name, Table *view, int page_size, char *err, size_t err_sz) {
-    seek_mode_close();
-    G.s = seekdb_open(db_path, SEEKDB_MODE_LOW_RAM, err, err_sz);
-    if (!G.s) return -1;
+// Opens the seek view over table_name in the already open G.s
+static int open_view(const char *table_name, Table *view, int page_size, char *err, size_t err_sz) {
     snprintf(G.table, sizeof(G.table), "%s", table_name);
     snprintf(G.key, sizeof(G.key), "%s", "_ttb_id");
+    G.view = view;
     if (seekdb_ensure_stable_key(G.s, G.table, G.key, err, err_sz) != 0) return -1;
     if (seekdb_set_view(G.s, G.table, "1=1", G.key, G.key, err, err_sz) != 0) return -1;
     char **names = NULL; int n = seekdb_get_view_columns(G.s, &names, err, err_sz);
     if (n <= 0) return -1;
+    char **decls = NULL;
+    if (seekdb_get_view_column_types(G.s, &decls, NULL, 0) != n) decls = NULL;
     ensure_key_col((const char* const*)names, n);
+    // Wide tables start with their leading columns (seek_mode_show_columns)
+    G.want_lo = 0;
+    G.want_hi = n < SEEK_OPEN_COLUMNS ? n : SEEK_OPEN_COLUMNS;
     // Reset and fill columns
     if (view->name) { free(view->name); view->name = NULL; }
     view->name = strdup(table_name);
-    fill_columns(view, names, n);
-    for (int i = 0; i < n; ++i) { free(names[i]); }
+    clear_table_rows(view);
+    fill_columns(view, names, decls, n);
+    for (int i = 0; i < n; ++i) { free(names[i]); if (decls) free(decls[i]); }
     free(names);
+    free(decls);
+    background_reset();
     // Fetch first page
-    return seek_mode_fetch_first(view, page_size, err, err_sz);
+    return seek_mode_fetch_first(view, page_size, err, err_sz) < 0 ? -1 : 0;
 }
 
-int seek_mode_fetch_first(Table *view, int page_size, char *err, size_t err_sz) {
+int seek_mode_open_for_table(const char *db_path, const char *table_name, Table *view, int page_size, char *err, size_t err_sz) {
+    seek_mode_close();
+    G.s = seekdb_open(db_path, SEEKDB_MODE_AUTO, err, err_sz);
+    if (!G.s) return -1;
+    return open_view(table_name, view, page_size, err, err_sz);
+}
+
+typedef long long (*SpillLoader)(const char *path, bool infer_types, seekdb *s, const char *table,
+                                 const char *key, char *err, size_t err_sz, const ProgressReporter *progress);
+
+// Loads a file into a new spill database and opens the seek view over it;
+// the table is named after the file without ext
+static int open_spill(const char *path, const char *ext, SpillLoader load, bool infer_types, Table *view,
+                      int page_size, const ProgressReporter *progress, char *err, size_t err_sz) {
+    char name[128];
+    const char *slash = strrchr(path, '/');
+    const char *base = slash ? slash + 1 : path;
+    size_t len = strlen(base);
+    size_t ext_len = strlen(ext);
+
+    if (len > ext_len && strcasecmp(base + len - ext_len, ext) == 0) len -= ext_len;
+    if (len == 0) { base = "data"; len = 4; }
+    if (len >= sizeof(name)) len = sizeof(name) - 1;
+    memcpy(name, base, len);
+    name[len] = '\0';
+
+    seek_mode_close();
+    // Spill database: rows stay on disk and go away with the session
+    G.s = seekdb_open(NULL, SEEKDB_MODE_AUTO, err, err_sz);
+    if (!G.s) return -1;
+    if (load(path, infer_types, G.s, name, "_ttb_id", err, err_sz, progress) < 0) {
+        seek_mode_close();
+        return -1;
+    }
+    return open_view(name, view, page_size, err, err_sz);
+}
+
+int seek_mode_open_csv(const char *path, bool infer_types, Table *view, int page_size,
+                       const ProgressReporter *progress, char *err, size_t err_sz) {
+    return open_spill(path, ".csv", csv_stream_to_seekdb, infer_types, view, page_size, progress, err, err_sz);
+}
+
+int seek_mode_open_xlsx(const char *path, bool infer_types, Table *view, int page_size,
+                        const ProgressReporter *progress, char *err, size_t err_sz) {
+    return open_spill(path, ".xlsx", xl_stream_to_seekdb, infer_types, view, page_size, progress, err, err_sz);
+}
+
+// Swap a collected window (display order) into the view. The row arrays
+// and the arena move into the table as they are (no copies). A column the
+// window holds with another type (a user retype, or values the declared
+// type cannot hold) is converted first; when that would lose values it
+// becomes text in the view. b keeps its rows on failure.
+static int apply_window(Table *view, Buf *b, char *err, size_t err_sz) {
+    int cols = b->cols < view->column_count ? b->cols : view->column_count;
+    int failed = 0;
+    Row *rows = NULL;
+
     clear_table_rows(view);
-    FillCtx ctx = { .t = view, .reverse = 0, .first = 0, .last = 0 };
-    int got = seekdb_seek_first(G.s, page_size, stream_row, &ctx, err, err_sz);
-    if (got < 0) return -1;
-    G.first_id = ctx.first; G.last_id = ctx.last; G.active = 1;
+    for (int j = 0; j < cols && !failed; ++j) {
+        int rc;
+        if (buf_source_col(b, j) < 0) { b->types[j] = view->columns[j].type; continue; } // all NULL
+        rc = buf_retype_column(b, j, view->columns[j].type);
+        if (rc > 0) {
+            view->columns[j].type = TYPE_STR;
+            rc = buf_retype_column(b, j, TYPE_STR);
+        }
+        failed = (rc != 0);
+    }
+    if (failed || (b->n > 0 && !(rows = malloc(sizeof(Row) * (size_t)b->n)))) {
+        snprintf(err, err_sz, "Out of memory");
+        return -1;
+    }
+    for (int i = 0; i < b->n; ++i) {
+        rows[i].values = b->rows[i];
+        b->rows[i] = NULL;
+    }
+    view->rows = rows;
+    view->row_count = b->n;
+    view->capacity_rows = b->n;
+    view->arena = b->arena;
+    b->arena = NULL;
+    G.patched = 0;
+    G.have_lo = b->lo;
+    G.have_hi = b->hi;
+    return 0;
+}
+
+enum { READ_FIRST, READ_AFTER, READ_BEFORE, READ_AT };
+
+// Reads a window from SQLite into b (seek order), typed like the view
+static int read_window(const Table *view, int how, long long anchor, int page_size, Buf *b, char *err, size_t err_sz) {
+    int cols = seekdb_view_column_count(G.s, err, err_sz);
+    int got;
+
+    if (cols < 0) return -1;
+    buf_init_like(b, view, cols);
+    b->lo = G.want_lo < cols ? G.want_lo : 0;
+    b->hi = G.want_hi < cols ? G.want_hi : cols;
+    if (project_for(G.s, b, err, err_sz) != 0) { buf_free(b); return -1; }
+    switch (how) {
+        case READ_FIRST: got = seekdb_seek_first(G.s, page_size, collect_row, b, err, err_sz); break;
+        case READ_AFTER: got = seekdb_seek_after(G.s, anchor, page_size, collect_row, b, err, err_sz); break;
+        case READ_BEFORE: got = seekdb_seek_before(G.s, anchor, page_size, collect_row, b, err, err_sz); break;
+        default: got = seekdb_seek_by_id(G.s, anchor, page_size, collect_row, b, err, err_sz); break;
+    }
+    if (got >= 0 && b->failed) { snprintf(err, err_sz, "Out of memory"); got = -1; }
+    if (got < 0) { buf_free(b); return -1; }
+    return b->n;
+}
+
+int seek_mode_fetch_first(Table *view, int page_size, char *err, size_t err_sz) {
+    Buf b;
+    WindowLinks links = { .page_size = page_size, .has_after = 1, .after_anchor = LLONG_MIN };
+    int got;
+
+    retire_window(view, &G.links);
+    if (!cache_take(+1, LLONG_MIN, page_size, view->column_count, &b, &links) &&
+        read_window(view, READ_FIRST, 0, page_size, &b, err, err_sz) < 0) return -1;
+    if (apply_window(view, &b, err, err_sz) != 0) { buf_free(&b); return -1; }
+    got = b.n;
+    G.first_id = got ? b.ids[0] : 0; G.last_id = got ? b.ids[got-1] : 0;
+    buf_free(&b);
+    G.active = 1;
+    G.links = links;
     G.row_base = 1; G.last_count = got;
+    prefetch_schedule(view, page_size);
     return got;
 }
 
+// Gets the window past anchor in direction dir (display order): from the
+// cache, the prefetcher or SQLite. *links is filled in for cache hits.
+static int fetch_window(Table *view, int dir, long long anchor, int page_size, Buf *b, WindowLinks *links, char *err, size_t err_sz) {
+    int got;
+
+    if (cache_take(dir, anchor, page_size, view->column_count, b, links)) return b->n;
+    if (!prefetch_take(dir, anchor, page_size, b)) {
+        got = read_window(view, dir > 0 ? READ_AFTER : READ_BEFORE, anchor, page_size, b, err, err_sz);
+        if (got < 0) return -1;
+    }
+    if (dir < 0) buf_reverse(b);
+    return b->n;
+}
+
+// Links of the window leaving the view for next: a full window sits right
+// before (dir > 0) or after (dir < 0) the one replacing it.
+static WindowLinks leaving_links(const Table *view, int dir, const Buf *next, int page_size) {
+    WindowLinks links = G.links;
+    if (links.page_size != page_size) {
+        memset(&links, 0, sizeof(links));
+        links.page_size = page_size;
+    }
+    if (view->row_count == page_size) {
+        if (dir > 0) { links.has_before = 1; links.before_anchor = next->ids[0]; }
+        else { links.has_after = 1; links.after_anchor = next->ids[next->n-1]; }
+    }
+    return links;
+}
+
 int seek_mode_fetch_next(Table *view, int page_size, char *err, size_t err_sz) {
-    clear_table_rows(view);
-    FillCtx ctx = { .t = view, .reverse = 0, .first = 0, .last = 0 };
-    int got = seekdb_seek_after(G.s, G.last_id, page_size, stream_row, &ctx, err, err_sz);
+    Buf b;
+    WindowLinks links = {0};
+    int got = fetch_window(view, +1, G.last_id, page_size, &b, &links, err, err_sz);
     if (got < 0) return -1;
-    if (got == 0) return 0;
+    if (b.n == 0) { buf_free(&b); return 0; }
+
+    WindowLinks old = leaving_links(view, +1, &b, page_size);
+    retire_window(view, &old);
+    if (apply_window(view, &b, err, err_sz) != 0) { buf_free(&b); return -1; }
+    links.page_size = page_size;
+    links.has_after = 1; links.after_anchor = G.last_id;
+    G.links = links;
     G.row_base += (G.last_count > 0 ? G.last_count : 0);
-    G.last_count = got;
+    G.last_count = b.n;
     if (G.row_base < 1) G.row_base = 1;
-    G.first_id = ctx.first; G.last_id = ctx.last;
+    G.first_id = b.ids[0]; G.last_id = b.ids[b.n-1];
+    buf_free(&b);
+    prefetch_schedule(view, page_size);
     return got;
 }
 
 int seek_mode_fetch_prev(Table *view, int page_size, char *err, size_t err_sz) {
-    // Collect in buffer (descending), then reverse into table
-    clear_table_rows(view);
-    char err2[256] = {0};
-    // Peek column count via current view
-    char **names = NULL; int cols = seekdb_get_view_columns(G.s, &names, err2, sizeof err2);
-    for (int i = 0; i < cols; ++i) { free(names[i]); }
-    free(names);
-    Buf b; buf_init(&b, cols > 0 ? cols : view->column_count);
-    int got = seekdb_seek_before(G.s, G.first_id, page_size, collect_row, &b, err, err_sz);
-    if (got < 0) { buf_free(&b); return -1; }
+    Buf b;
+    WindowLinks links = {0};
+    int got = fetch_window(view, -1, G.first_id, page_size, &b, &links, err, err_sz);
+    if (got < 0) return -1;
     if (b.n == 0) { buf_free(&b); return 0; }
-    // Reverse append
-    G.first_id = b.ids[b.n-1];
-    G.last_id = b.ids[0];
-    for (int i = b.n - 1; i >= 0; --i) {
-        add_row(view, (const char**)b.rows[i]);
-    }
+
+    WindowLinks old = leaving_links(view, -1, &b, page_size);
+    retire_window(view, &old);
+    if (apply_window(view, &b, err, err_sz) != 0) { buf_free(&b); return -1; }
+    links.page_size = page_size;
+    links.has_before = 1; links.before_anchor = G.first_id;
+    G.links = links;
+    G.first_id = b.ids[0];
+    G.last_id = b.ids[b.n-1];
     // Update row base
     G.row_base -= b.n;
     if (G.row_base < 1) G.row_base = 1;
     G.last_count = b.n;
     buf_free(&b);
+    prefetch_schedule(view, page_size);
     return got;
 }
 
+static seekdb_filter_op seek_filter_op(FilterOp op) {
+    switch (op) {
+        case FILTER_EQUALS: return SEEKDB_FILTER_EQUALS;
+        case FILTER_GT: return SEEKDB_FILTER_GT;
+        case FILTER_LT: return SEEKDB_FILTER_LT;
+        case FILTER_GTE: return SEEKDB_FILTER_GTE;
+        case FILTER_LTE: return SEEKDB_FILTER_LTE;
+        case FILTER_REGEX: return SEEKDB_FILTER_REGEX;
+        default: return SEEKDB_FILTER_CONTAINS;
+    }
+}
+
+int seek_mode_apply_view(Table *view, const TableView *spec, int page_size, char *err, size_t err_sz) {
+    seekdb_filter filter;
+    seekdb_sort sort;
+    const seekdb_filter *fp = NULL;
+    const seekdb_sort *sp = NULL;
+
+    if (!G.active) { snprintf(err, err_sz, "No seek view open."); return -1; }
+    // Spec columns index the view, whose names are the table's columns
+    if (spec && spec->filter_active) {
+        int col = spec->filter_rule.col;
+        if (col < 0 || col >= view->column_count) { snprintf(err, err_sz, "Invalid filter"); return -1; }
+        filter.column = view->columns[col].name;
+        filter.op = seek_filter_op(spec->filter_rule.op);
+        filter.value = spec->filter_rule.value;
+        fp = &filter;
+    }
+    if (spec && spec->sort_active) {
+        if (spec->sort_col < 0 || spec->sort_col >= view->column_count) { snprintf(err, err_sz, "Invalid sort column"); return -1; }
+        sort.column = view->columns[spec->sort_col].name;
+        sort.desc = spec->sort_desc;
+        sp = &sort;
+    }
+    if (seekdb_set_view_spec(G.s, G.table, fp, sp, G.key, err, err_sz) != 0) return -1;
+    G.filter_col = fp ? spec->filter_rule.col : -1;
+    G.order_col = sp ? spec->sort_col : -1;
+    // Cached windows belong to the old filter/order
+    cache_clear();
+    clear_table_rows(view);
+    background_reset();
+    return seek_mode_fetch_first(view, page_size, err, err_sz);
+}
+
 long long seek_mode_row_base(void) { return G.active ? (G.row_base > 0 ? G.row_base : 1) : 1; }
 int seek_mode_last_count(void) { return G.active ? (G.last_count > 0 ? G.last_count : 0) : 0; }
+
+// Load the window whose first row is target_id. The gutter base is pos (its
+// 0-based position) when known, else looked up through the checkpoints.
+static int load_window_at(Table *view, long long target_id, long long pos, int page_size, char *err, size_t err_sz) {
+    retire_window(view, &G.links);
+    memset(&G.links, 0, sizeof(G.links));
+    G.links.page_size = page_size;
+    Buf b;
+    int got = read_window(view, READ_AT, target_id, page_size, &b, err, err_sz);
+    if (got <= 0) { if (got == 0) buf_free(&b); return got; }
+    if (apply_window(view, &b, err, err_sz) != 0) { buf_free(&b); return -1; }
+    G.first_id = b.ids[0]; G.last_id = b.ids[got-1];
+    G.last_count = got;
+    buf_free(&b);
+    if (pos < 0) {
+        checkpoints_poll();
+        pos = seekdb_position_of_id(G.s, G.checkpoints, G.first_id, NULL, 0);
+    }
+    G.row_base = (pos >= 0) ? pos + 1 : 1;
+    prefetch_schedule(view, page_size);
+    return got;
+}
+
+int seek_mode_search_prepare(char *err, size_t err_sz) {
+    if (!G.active) { snprintf(err, err_sz, "No seek view open."); return -1; }
+    return seekdb_fts_ensure(G.s, err, err_sz);
+}
+
+long long seek_mode_search_count(const char *query, char *err, size_t err_sz) {
+    if (!G.active) return -1;
+    return seekdb_fts_count(G.s, query, err, err_sz);
+}
+
+int seek_mode_search_jump(Table *view, const char *query, int dir, int page_size, int *wrapped, char *err, size_t err_sz) {
+    long long id = 0;
+    int n;
+
+    if (wrapped) *wrapped = 0;
+    if (!G.active) return 0;
+    if (dir > 0) n = seekdb_fts_search(G.s, query, G.last_id, 1, &id, err, err_sz);
+    else n = seekdb_fts_search_before(G.s, query, G.first_id, 1, &id, err, err_sz);
+    if (n == 0) {
+        if (wrapped) *wrapped = 1;
+        if (dir > 0) n = seekdb_fts_search(G.s, query, LLONG_MIN, 1, &id, err, err_sz);
+        else n = seekdb_fts_search_before(G.s, query, LLONG_MAX, 1, &id, err, err_sz);
+    }
+    if (n <= 0) return n;
+    return load_window_at(view, id, -1, page_size, err, err_sz);
+}
+
+void seek_mode_set_cache_budget(size_t bytes) {
+    C.budget = bytes;
+    cache_trim();
+}
+
+void seek_mode_cache_stats(long long *hits, long long *misses, size_t *bytes) {
+    if (hits) *hits = C.hits;
+    if (misses) *misses = C.misses;
+    if (bytes) *bytes = C.bytes;
+}
+
+long long seek_mode_row_count(int *exact) {
+    if (exact) *exact = 0;
+    if (!G.active) return -1;
+    checkpoints_poll();
+    return seekdb_count_estimate(G.s, exact);
+}
+
+long long seek_mode_row_total(void) {
+    if (!G.active) return -1;
+    checkpoints_poll();
+    return seekdb_checkpoints_rows(G.checkpoints);
+}
+
+int seek_mode_goto_row(Table *view, long long row, int page_size, char *err, size_t err_sz) {
+    long long total, id = 0;
+    int found;
+
+    if (!G.active) { snprintf(err, err_sz, "No seek view open."); return -1; }
+    total = seek_mode_row_total();
+    if (total < 0) { snprintf(err, err_sz, "Row index is still being built; try again shortly."); return -1; }
+    if (total == 0) return 0;
+    if (row < 1) row = 1;
+    if (row > total) row = total;
+    found = seekdb_id_at_position(G.s, G.checkpoints, row - 1, &id, err, err_sz);
+    if (found <= 0) {
+        if (found == 0) snprintf(err, err_sz, "Row %lld not found; the view changed.", row);
+        return -1;
+    }
+    return load_window_at(view, id, row - 1, page_size, err, err_sz);
+}
+
+// Refetches the current window when it lacks visible columns, with a screen
+// of columns on either side so the next column page is usually there
+// already. Columns outside the range stay NULL in the view.
+int seek_mode_show_columns(Table *view, int first, int count, int page_size, char *err, size_t err_sz) {
+    int cols = view->column_count;
+    Buf b;
+    int got;
+
+    if (!G.active || count <= 0 || G.last_count <= 0) return 0;
+    if (first < 0) first = 0;
+    if (first + count > cols) count = cols - first;
+    if (count <= 0 || (first >= G.have_lo && first + count <= G.have_hi)) return 0;
+    G.want_lo = first - count > 0 ? first - count : 0;
+    G.want_hi = first + 2 * count < cols ? first + 2 * count : cols;
+    // Same rows, more columns: the old copy is of no further use
+    clear_table_rows(view);
+    got = read_window(view, READ_AT, G.first_id, page_size, &b, err, err_sz);
+    if (got < 0) return -1;
+    if (got == 0) { buf_free(&b); return seek_mode_fetch_first(view, page_size, err, err_sz) < 0 ? -1 : 1; }
+    if (apply_window(view, &b, err, err_sz) != 0) { buf_free(&b); return -1; }
+    G.first_id = b.ids[0]; G.last_id = b.ids[got-1];
+    G.last_count = got;
+    buf_free(&b);
+    prefetch_schedule(view, page_size);
+    return 1;
+}
+
+int seek_mode_column_loaded(int col) {
+    return G.active && ((col >= G.have_lo && col < G.have_hi) || col == G.key_col);
+}
+
+int seek_mode_key_column(void) {
+    return G.active ? G.key_col : -1;
+}
+
+// Edits write through to SQLite by key and patch the window in place. Other
+// copies of the rows go: cached and prefetched windows, and the position
+// index when rows come or go or move in the view order. Every edit the UI
+// makes is one row, so each is its own transaction (the seekdb write opens
+// a batch when none is open); an edit that touches several rows must wrap
+// them in seekdb_write_begin/commit so they commit, and sync, once.
+static void after_write(const Table *view, int rows_changed, int col) {
+    cache_clear();
+    prefetch_drop();
+    if (rows_changed || (col >= 0 && (col == G.order_col || col == G.filter_col))) checkpoints_reset();
+    if (G.links.page_size > 0) prefetch_schedule(view, G.links.page_size);
+}
+
+// Text stored for a validated input: bools as 0/1, numbers as typed (the
+// column affinity converts them)
+static const char *sql_value(DataType type, const char *text) {
+    if (type != TYPE_BOOL) return text;
+    return (strcasecmp(text, "true") == 0 || strcmp(text, "1") == 0) ? "1" : "0";
+}
+
+// Writes go by the key read from the window, so view must still be the
+// table the seek view fills (a table switch leaves other columns there)
+static int check_write_view(const Table *view, char *err, size_t err_sz) {
+    if (!G.active || view != G.view || G.key_col < 0 || G.key_col >= view->column_count ||
+        !view->columns[G.key_col].name || strcmp(view->columns[G.key_col].name, G.key) != 0) {
+        snprintf(err, err_sz, "No seek view open.");
+        return -1;
+    }
+    return 0;
+}
+
+int seek_mode_set_cell(Table *view, int row, int col, const char *value, char *err, size_t err_sz) {
+    if (check_write_view(view, err, err_sz) != 0) return -1;
+    if (row < 0 || row >= view->row_count || col < 0 || col >= view->column_count) { snprintf(err, err_sz, "Invalid cell"); return -1; }
+    if (col == G.key_col) { snprintf(err, err_sz, "The row key cannot be edited."); return -1; }
+    if (seekdb_update_cell(G.s, row_key(view, row), col, value ? sql_value(view->columns[col].type, value) : NULL,
+                           err, err_sz) != 0) return -1;
+    if (value ? tableop_set_cell(view, row, col, value, err, err_sz) : tableop_clear_cell(view, row, col, err, err_sz)) {
+        // Stored, but the window kept the old value: never cache it
+        G.patched = 1;
+    }
+    after_write(view, 0, col);
+    return 0;
+}
+
+// values has one entry per view column; the key's is ignored (the row gets
+// the next key). The row is shown at index row of the window, wherever it
+// sorts; the view order places it on the next fetch.
+int seek_mode_insert_row(Table *view, int row, const char **values, char *err, size_t err_sz) {
+    int n = view->column_count;
+    const char **sql = NULL, **shown = NULL;
+    char id_text[32];
+    long long id = 0;
+    int rc = -1;
+
+    if (check_write_view(view, err, err_sz) != 0) return -1;
+    sql = calloc((size_t)n, sizeof(char*));
+    shown = calloc((size_t)n, sizeof(char*));
+    if (!sql || !shown) { snprintf(err, err_sz, "Out of memory"); goto done; }
+    for (int j = 0; j < n; ++j) {
+        shown[j] = values[j] ? values[j] : "";
+        sql[j] = sql_value(view->columns[j].type, shown[j]);
+    }
+    // One batch for the row and the window: a row the window could not take
+    // is rolled back rather than left stored but unseen
+    if (seekdb_write_begin(G.s, err, err_sz) != 0) goto done;
+    if (seekdb_insert_row(G.s, sql, n, &id, err, err_sz) != 0) { seekdb_write_rollback(G.s); goto done; }
+    snprintf(id_text, sizeof(id_text), "%lld", id);
+    shown[G.key_col] = id_text;
+    if (tableop_insert_row_at(view, row, shown, err, err_sz) != 0) { seekdb_write_rollback(G.s); goto done; }
+    if (seekdb_write_commit(G.s, err, err_sz) != 0) {
+        tableop_delete_row(view, row, NULL, 0);
+        goto done;
+    }
+    // last_count stays: it advances the gutter past the rows the view
+    // order put here, and the new row sorts wherever it sorts
+    G.patched = 1;
+    after_write(view, 1, -1);
+    rc = 0;
+done:
+    free(sql);
+    free(shown);
+    return rc;
+}
+
+int seek_mode_delete_row(Table *view, int row, char *err, size_t err_sz) {
+    if (check_write_view(view, err, err_sz) != 0) return -1;
+    if (row < 0 || row >= view->row_count) { snprintf(err, err_sz, "Invalid row"); return -1; }
+    if (seekdb_delete_row(G.s, row_key(view, row), err, err_sz) != 0) return -1;
+    if (tableop_delete_row(view, row, err, err_sz) != 0) return -1;
+    G.patched = 1;
+    if (G.last_count > 0) G.last_count--;
+    // Page turns seek from the window's ends, which must still exist
+    if (view->row_count > 0) {
+        G.first_id = row_key(view, 0);
+        G.last_id = row_key(view, view->row_count - 1);
+    }
+    after_write(view, 1, -1);
+    if (view->row_count == 0 && G.links.page_size > 0 &&
+        seek_mode_fetch_first(view, G.links.page_size, err, err_sz) < 0) return -1;
+    return 0;
+}
+
+// Exports run as a pool job on a reader, so they read one snapshot of the
+// view without holding up the writer; the UI thread waits and forwards the
+// job's progress (as book_search does for its workers). Without a pool they
+// run here on the writer.
+typedef long long (*SeekExporter)(seekdb *s, const char *name, const char *path, char *err, size_t err_sz,
+                                  const ProgressReporter *progress);
+
+typedef struct {
+    SeekExporter run;
+    const char *name;
+    const char *path;
+    long long count;       // exact view count handed to the reader, <0 unknown
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    double fraction;
+    char message[96];
+    unsigned updates;      // bumped by every progress report
+    int done;
+    long long rows;
+    char err[256];
+} ExportJob;
+
+static void export_progress(void *ctx, double fraction, const char *message) {
+    ExportJob *job = (ExportJob*)ctx;
+    pthread_mutex_lock(&job->lock);
+    job->fraction = fraction;
+    snprintf(job->message, sizeof(job->message), "%s", message ? message : "");
+    job->updates++;
+    pthread_cond_signal(&job->changed);
+    pthread_mutex_unlock(&job->lock);
+}
+
+static void export_job(seekdb *reader, void *arg) {
+    ExportJob *job = (ExportJob*)arg;
+    ProgressReporter progress = { export_progress, job };
+    long long rows = -1;
+
+    if (reader) {
+        // Lets the exporter report a fraction for filtered views too
+        if (job->count >= 0) seekdb_count_store(reader, job->count);
+        rows = job->run(reader, job->name, job->path, job->err, sizeof(job->err), &progress);
+    } else {
+        snprintf(job->err, sizeof(job->err), "Export cancelled.");
+    }
+    pthread_mutex_lock(&job->lock);
+    job->rows = rows;
+    job->done = 1;
+    pthread_cond_signal(&job->changed);
+    pthread_mutex_unlock(&job->lock);
+}
+
+static long long export_view(SeekExporter run, const char *name, const char *path, const ProgressReporter *progress,
+                             char *err, size_t err_sz) {
+    ExportJob job;
+    unsigned seen = 0;
+    int exact = 0;
+
+    if (!G.active) { snprintf(err, err_sz, "No seek view open."); return -1; }
+    if (!G.pool) return run(G.s, name, path, err, err_sz, progress);
+    memset(&job, 0, sizeof(job));
+    job.run = run;
+    job.name = name;
+    job.path = path;
+    checkpoints_poll();
+    job.count = seekdb_count_estimate(G.s, &exact);
+    if (!exact) job.count = -1;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.changed, NULL);
+    if (seekdb_pool_submit(G.pool, export_job, &job) < 0) {
+        pthread_cond_destroy(&job.changed);
+        pthread_mutex_destroy(&job.lock);
+        return run(G.s, name, path, err, err_sz, progress);
+    }
+
+    pthread_mutex_lock(&job.lock);
+    while (!job.done) {
+        if (job.updates != seen && progress && progress->update) {
+            double fraction = job.fraction;
+            char message[sizeof(job.message)];
+            memcpy(message, job.message, sizeof(message));
+            seen = job.updates;
+            pthread_mutex_unlock(&job.lock);
+            progress->update(progress->ctx, fraction, message);
+            pthread_mutex_lock(&job.lock);
+            continue;
+        }
+        pthread_cond_wait(&job.changed, &job.lock);
+    }
+    pthread_mutex_unlock(&job.lock);
+    pthread_cond_destroy(&job.changed);
+    pthread_mutex_destroy(&job.lock);
+    if (job.rows < 0) snprintf(err, err_sz, "%s", job.err[0] ? job.err : "Export failed");
+    return job.rows;
+}
+
+static long long export_csv(seekdb *s, const char *name, const char *path, char *err, size_t err_sz,
+                            const ProgressReporter *progress) {
+    (void)name;
+    return csv_export_seekdb(s, path, err, err_sz, progress);
+}
+
+long long seek_mode_export_csv(const char *path, const ProgressReporter *progress, char *err, size_t err_sz) {
+    return export_view(export_csv, NULL, path, progress, err, err_sz);
+}
+
+long long seek_mode_export_xlsx(const char *name, const char *path, const ProgressReporter *progress,
+                                char *err, size_t err_sz) {
+    return export_view(xl_export_seekdb, name, path, progress, err, err_sz);
+}
+
+long long seek_mode_export_db(const char *name, const char *path, const ProgressReporter *progress,
+                              char *err, size_t err_sz) {
+    return export_view(db_export_seekdb, name, path, progress, err, err_sz);
+}
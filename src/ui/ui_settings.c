@@ -5,7 +5,10 @@
 #include "workspace.h"
 #include "errors.h"
 #include "settings.h"
+#include "text_fold.h"
 #include "ui.h"
+#include "mem_budget.h"
+#include "seekdb.h"
 
 static AppSettings g_settings;
 static int g_loaded = 0;
@@ -17,14 +20,99 @@ static void ensure_loaded(void) {
     settings_load(settings_default_path(), &g_settings);
     workspace_set_autosave_enabled(g_settings.autosave_enabled);
     low_ram_mode = g_settings.low_ram_enabled ? 1 : 0;
+    low_ram_auto = (!low_ram_mode && g_settings.low_ram_auto) ? 1 : 0;
+    mem_budget_set_mb(g_settings.memory_budget_mb);
+    seekdb_tuning tuning = { g_settings.seekdb_cache_mb, g_settings.seekdb_mmap_mb, g_settings.seekdb_page_size,
+                             g_settings.seekdb_spill_mem_mb };
+    seekdb_set_tuning(&tuning);
+    seek_mode_set_cache_budget((size_t)g_settings.seek_cache_mb << 20);
     row_gutter_enabled = g_settings.show_row_gutter ? 1 : 0;
+    text_fold_set_default_flags(g_settings.fold_accents ? TEXT_FOLD_STRIP_ACCENTS : 0);
     apply_ui_color_settings(&g_settings);
     g_loaded = 1;
 }
 
+enum {
+    ROW_CORE = 0,
+    ROW_AUTOSAVE,
+    ROW_TYPE_INFER,
+    ROW_LOW_RAM,
+    ROW_MEM_BUDGET,
+    ROW_SEEK_CACHE,
+    ROW_FOLD_ACCENTS,
+    ROW_COSMETIC,
+    ROW_ROW_GUTTER,
+    ROW_THEME,
+    ROW_SAVE,
+    ROW_BACK,
+    ROW_COUNT
+};
+
+// Budgets offered for the seek window cache, in MB
+static const int SEEK_CACHE_STEPS[] = {0, 4, 16, 64, 256};
+
+static int next_seek_cache_mb(int mb)
+{
+    int n = (int)(sizeof(SEEK_CACHE_STEPS) / sizeof(SEEK_CACHE_STEPS[0]));
+    for (int i = 0; i < n; ++i) {
+        if (SEEK_CACHE_STEPS[i] > mb) return SEEK_CACHE_STEPS[i];
+    }
+    return SEEK_CACHE_STEPS[0];
+}
+
+// Memory budgets offered, in MB (0 = automatic)
+static const int MEM_BUDGET_STEPS[] = {0, 256, 512, 1024, 2048, 4096, 8192};
+
+static int next_mem_budget_mb(int mb)
+{
+    int n = (int)(sizeof(MEM_BUDGET_STEPS) / sizeof(MEM_BUDGET_STEPS[0]));
+    for (int i = 0; i < n; ++i) {
+        if (MEM_BUDGET_STEPS[i] > mb) return MEM_BUDGET_STEPS[i];
+    }
+    return MEM_BUDGET_STEPS[0];
+}
+
+// Off -> On -> Auto (seek view only past the memory budget) -> Off
+static void cycle_low_ram(void)
+{
+    if (g_settings.low_ram_enabled) {
+        g_settings.low_ram_enabled = false;
+        g_settings.low_ram_auto = true;
+    } else if (g_settings.low_ram_auto) {
+        g_settings.low_ram_auto = false;
+    } else {
+        g_settings.low_ram_enabled = true;
+    }
+    low_ram_mode = g_settings.low_ram_enabled ? 1 : 0;
+    low_ram_auto = g_settings.low_ram_auto ? 1 : 0;
+}
+
+static void format_mem_budget_row(char *buf, size_t buf_sz)
+{
+    if (g_settings.memory_budget_mb > 0) {
+        snprintf(buf, buf_sz, "Memory budget: %d MB", g_settings.memory_budget_mb);
+        return;
+    }
+    snprintf(buf, buf_sz, "Memory budget: Auto (%llu MB, half of available)", mem_budget_bytes() >> 20);
+}
+
+static void format_seek_cache_row(char *buf, size_t buf_sz)
+{
+    long long hits = 0, misses = 0;
+    size_t used = 0;
+
+    if (g_settings.seek_cache_mb <= 0) {
+        snprintf(buf, buf_sz, "Seek window cache: Off");
+        return;
+    }
+    seek_mode_cache_stats(&hits, &misses, &used);
+    snprintf(buf, buf_sz, "Seek window cache: %d MB (%.1f MB used, %lld hits / %lld misses)",
+             g_settings.seek_cache_mb, (double)used / (1024.0 * 1024.0), hits, misses);
+}
+
 static int is_selectable_row(int row)
 {
-    return row != 0 && row != 4;
+    return row != ROW_CORE && row != ROW_COSMETIC;
 }
 
 static int next_selectable_row(int row, int dir, int count)
@@ -39,18 +127,6 @@ static int next_selectable_row(int row, int dir, int count)
 UiMenuResult show_settings_menu(void) {
     ensure_loaded();
     noecho(); curs_set(0);
-    enum {
-        ROW_CORE = 0,
-        ROW_AUTOSAVE,
-        ROW_TYPE_INFER,
-        ROW_LOW_RAM,
-        ROW_COSMETIC,
-        ROW_ROW_GUTTER,
-        ROW_THEME,
-        ROW_SAVE,
-        ROW_BACK,
-        ROW_COUNT
-    };
     int count = ROW_COUNT;
     int sel = ROW_AUTOSAVE; int ch;
     UiMenuResult result = UI_MENU_BACK;
@@ -79,7 +155,11 @@ UiMenuResult show_settings_menu(void) {
             if (i == ROW_CORE) snprintf(linebuf, sizeof(linebuf), "General");
             else if (i == ROW_AUTOSAVE) snprintf(linebuf, sizeof(linebuf), "Autosave workspace: %s", g_settings.autosave_enabled ? "On" : "Off");
             else if (i == ROW_TYPE_INFER) snprintf(linebuf, sizeof(linebuf), "Type inference: %s", g_settings.type_infer_enabled ? "On" : "Off");
-            else if (i == ROW_LOW_RAM) snprintf(linebuf, sizeof(linebuf), "Low-RAM seek paging: %s", g_settings.low_ram_enabled ? "On" : "Off");
+            else if (i == ROW_LOW_RAM) snprintf(linebuf, sizeof(linebuf), "Low-RAM seek paging: %s",
+                                               g_settings.low_ram_enabled ? "On" : (g_settings.low_ram_auto ? "Auto" : "Off"));
+            else if (i == ROW_MEM_BUDGET) format_mem_budget_row(linebuf, sizeof(linebuf));
+            else if (i == ROW_SEEK_CACHE) format_seek_cache_row(linebuf, sizeof(linebuf));
+            else if (i == ROW_FOLD_ACCENTS) snprintf(linebuf, sizeof(linebuf), "Ignore accents in search/sort: %s", g_settings.fold_accents ? "On" : "Off");
             else if (i == ROW_COSMETIC) snprintf(linebuf, sizeof(linebuf), "Appearance");
             else if (i == ROW_ROW_GUTTER) snprintf(linebuf, sizeof(linebuf), "Row gutter: %s", g_settings.show_row_gutter ? "On" : "Off");
             else if (i == ROW_THEME) snprintf(linebuf, sizeof(linebuf), "Theme: %s", settings_theme_name(g_settings.theme_id));
@@ -106,7 +186,10 @@ UiMenuResult show_settings_menu(void) {
         else if (ch == '\n') {
             if (sel == ROW_AUTOSAVE) { g_settings.autosave_enabled = !g_settings.autosave_enabled; workspace_set_autosave_enabled(g_settings.autosave_enabled); }
             else if (sel == ROW_TYPE_INFER) { g_settings.type_infer_enabled = !g_settings.type_infer_enabled; }
-            else if (sel == ROW_LOW_RAM) { g_settings.low_ram_enabled = !g_settings.low_ram_enabled; low_ram_mode = g_settings.low_ram_enabled ? 1 : 0; }
+            else if (sel == ROW_LOW_RAM) cycle_low_ram();
+            else if (sel == ROW_MEM_BUDGET) { g_settings.memory_budget_mb = next_mem_budget_mb(g_settings.memory_budget_mb); mem_budget_set_mb(g_settings.memory_budget_mb); }
+            else if (sel == ROW_SEEK_CACHE) { g_settings.seek_cache_mb = next_seek_cache_mb(g_settings.seek_cache_mb); seek_mode_set_cache_budget((size_t)g_settings.seek_cache_mb << 20); }
+            else if (sel == ROW_FOLD_ACCENTS) { g_settings.fold_accents = !g_settings.fold_accents; text_fold_set_default_flags(g_settings.fold_accents ? TEXT_FOLD_STRIP_ACCENTS : 0); }
             else if (sel == ROW_ROW_GUTTER) { g_settings.show_row_gutter = !g_settings.show_row_gutter; row_gutter_enabled = g_settings.show_row_gutter ? 1 : 0; }
             else if (sel == ROW_THEME) { g_settings.theme_id = (g_settings.theme_id + 1) % settings_theme_count(); apply_ui_color_settings(&g_settings); }
             else if (sel == ROW_SAVE) { settings_save(settings_default_path(), &g_settings); result = UI_MENU_DONE; break; }
@@ -0,0 +1,128 @@
+// Streams files with inferred BOOLEAN columns into a spill database and
+// checks what got stored, including values past the type-inference sample.
+// Run with `make check`.
+#include "csv.h"
+#include "xl.h"
+#include "seekdb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); fprintf(stderr, __VA_ARGS__); \
+                   fputc('\n', stderr); failures++; } \
+} while (0)
+
+// Stored text of column col, one entry per row ("NULL" for SQL NULL)
+typedef struct {
+    const char *col;
+    char **values;
+    int n, cap;
+} Stored;
+
+static bool collect(void *user, sqlite3_stmt *row) {
+    Stored *c = user;
+    for (int j = 0; j < sqlite3_column_count(row); ++j) {
+        if (strcmp(sqlite3_column_name(row, j), c->col) != 0) continue;
+        if (c->n == c->cap) {
+            c->cap = c->cap ? c->cap * 2 : 1024;
+            c->values = realloc(c->values, sizeof(char*) * (size_t)c->cap);
+        }
+        const unsigned char *t = sqlite3_column_text(row, j);
+        c->values[c->n++] = strdup(t ? (const char*)t : "NULL");
+    }
+    return true;
+}
+
+static void stored_free(Stored *c) {
+    for (int i = 0; i < c->n; ++i) free(c->values[i]);
+    free(c->values);
+}
+
+// Values of the flag column after the sample: off-sample text stays as it
+// is, true/false in any case become 1/0 and empty cells NULL
+static const char *const tail_in[] = { "maybe", "TRUE", "False", "" };
+static const char *const tail_out[] = { "maybe", "1", "0", "NULL" };
+#define SAMPLE_PAST 1200
+#define TAIL_ROWS 4
+
+typedef long long (*Loader)(const char *path, bool infer_types, seekdb *s, const char *table,
+                            const char *key, char *err, size_t err_sz, const ProgressReporter *progress);
+
+static void check_loaded(const char *what, const char *path, Loader load) {
+    char err[256] = "";
+    Stored col = { "flag", NULL, 0, 0 };
+    int total = SAMPLE_PAST + TAIL_ROWS;
+    seekdb *s = seekdb_open(NULL, SEEKDB_MODE_LOW_RAM, err, sizeof(err));
+
+    CHECK(s != NULL, "%s: seekdb_open: %s", what, err);
+    if (!s) return;
+    long long rows = load(path, true, s, "t", "_ttb_id", err, sizeof(err), NULL);
+    CHECK(rows == total, "%s: loaded %lld rows: %s", what, rows, err);
+    CHECK(seekdb_set_view(s, "t", NULL, NULL, "_ttb_id", err, sizeof(err)) == 0, "%s: set_view: %s", what, err);
+    CHECK(seekdb_scan(s, collect, &col, err, sizeof(err)) == total, "%s: scan: %s", what, err);
+    if (col.n == total) {
+        CHECK(strcmp(col.values[0], "1") == 0, "%s: row 1: %s", what, col.values[0]);
+        CHECK(strcmp(col.values[SAMPLE_PAST - 1], "0") == 0, "%s: row %d: %s", what, SAMPLE_PAST,
+              col.values[SAMPLE_PAST - 1]);
+        for (int i = 0; i < TAIL_ROWS; ++i) {
+            const char *got = col.values[SAMPLE_PAST + i];
+            CHECK(strcmp(got, tail_out[i]) == 0, "%s: row %d: \"%s\", want \"%s\"", what,
+                  SAMPLE_PAST + i + 1, got, tail_out[i]);
+        }
+    }
+    stored_free(&col);
+    seekdb_close(s);
+}
+
+static void test_csv_bool_past_sample(void) {
+    char path[] = "/tmp/ttb_test_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *f = fd >= 0 ? fdopen(fd, "w") : NULL;
+
+    if (!f) { CHECK(0, "cannot create %s", path); return; }
+    fprintf(f, "id,flag\n");
+    for (int i = 1; i <= SAMPLE_PAST; ++i) fprintf(f, "%d,%s\n", i, (i % 2) ? "true" : "false");
+    for (int i = 0; i < TAIL_ROWS; ++i) fprintf(f, "%d,%s\n", SAMPLE_PAST + i + 1, tail_in[i]);
+    fclose(f);
+    check_loaded("csv", path, csv_stream_to_seekdb);
+    unlink(path);
+}
+
+static void test_xlsx_bool_past_sample(void) {
+    char path[] = "/tmp/ttb_test_XXXXXX.xlsx";
+    char err[256] = "";
+    char id[16];
+    const char *row[2] = { id, NULL };
+    int fd = mkstemps(path, 5);
+    Table *t = create_table("t");
+
+    if (fd < 0 || !t) { CHECK(0, "cannot create %s", path); free_table(t); return; }
+    close(fd);
+    // Text cells, so the loader infers the types as it does for CSV
+    add_column(t, "id", TYPE_STR);
+    add_column(t, "flag", TYPE_STR);
+    for (int i = 1; i <= SAMPLE_PAST + TAIL_ROWS; ++i) {
+        snprintf(id, sizeof(id), "%d", i);
+        row[1] = i <= SAMPLE_PAST ? ((i % 2) ? "true" : "false") : tail_in[i - SAMPLE_PAST - 1];
+        add_row(t, row);
+    }
+    CHECK(xl_save(t, path, err, sizeof(err)) == 0, "xl_save: %s", err);
+    free_table(t);
+    check_loaded("xlsx", path, xl_stream_to_seekdb);
+    unlink(path);
+}
+
+int main(void) {
+    test_csv_bool_past_sample();
+    test_xlsx_bool_past_sample();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("test_bool_ingest: ok\n");
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Runs patterns through the regex engine and checks the leftmost-longest
+// match each one reports, plus the messages of patterns that must not
+// compile. Run with `make check`.
+#include "text_regex.h"
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); fprintf(stderr, __VA_ARGS__); \
+                   fputc('\n', stderr); failures++; } \
+} while (0)
+
+// start is -1 when the pattern must not match
+typedef struct {
+    const char *pattern;
+    int icase;
+    const char *text;
+    int start, len;
+} MatchCase;
+
+static const MatchCase matches[] = {
+    // Leftmost-longest, whatever order the alternatives come in
+    { "a|ab", 0, "xab", 1, 2 },
+    { "ab|a", 0, "xab", 1, 2 },
+    { "(a|ab)(c|bcd)", 0, "abcd", 0, 4 },
+    { "b|abc", 0, "abc", 0, 3 },
+    { "a*", 0, "baa", 0, 0 },
+    // Bounded repeats
+    { "a{2,3}", 0, "aaaa", 0, 3 },
+    { "a{2}", 0, "a", -1, 0 },
+    { "a{2,}", 0, "baaaaa", 1, 5 },
+    { "a{0}b", 0, "ab", 1, 1 },
+    { "x{1,2}y", 0, "xxxy", 1, 3 },
+    { "a{,2}", 0, "a{,2}", 0, 5 },
+    // Anchors
+    { "^ab", 0, "cab", -1, 0 },
+    { "^ab", 0, "abc", 0, 2 },
+    { "b$", 0, "abc", -1, 0 },
+    { "c$", 0, "abc", 2, 1 },
+    { "^$", 0, "", 0, 0 },
+    // '.' and [^...] take whole UTF-8 chars
+    { "a.c", 0, "a\xc3\xa9" "c", 0, 4 },
+    { "^.$", 0, "\xe2\x82\xac", 0, 3 },
+    { "^.{3}$", 0, "a\xc3\xa9\xe2\x82\xac", 0, 6 },
+    { "[^a]", 0, "a\xc3\xa9", 1, 2 },
+    { "^[^x]+$", 0, "\xe6\x97\xa5\xe6\x9c\xac", 0, 6 },
+    { "\\D", 0, "1\xc3\xa9", 1, 2 },
+    { "\xc3\xa9+", 0, "x\xc3\xa9\xc3\xa9", 1, 4 },
+    // Classes and escapes
+    { "\\d+", 0, "ab123c", 2, 3 },
+    { "[a-c]+", 0, "xxbcay", 2, 3 },
+    { "\\w+\\s\\w+", 0, "  hi there", 2, 8 },
+    // Literal prefix skip
+    { "needle", 0, "haystack with needle", 14, 6 },
+    { "nee.le", 0, "ne nee needle", 7, 6 },
+    // Case folding, ASCII and beyond
+    { "ABC", 0, "xabc", -1, 0 },
+    { "ABC", 1, "xabc", 1, 3 },
+    { "\xc3\x89", 0, "caf\xc3\xa9", -1, 0 },
+    { "\xc3\x89", 1, "caf\xc3\xa9", 3, 2 },
+    { "CAF\xc3\x89$", 1, "un caf\xc3\xa9", 3, 5 },
+    { "\xce\xa3\xce\x9f\xce\xa6", 1, "\xcf\x83\xce\xbf\xcf\x86\xce\xaf\xce\xb1", 0, 6 },
+    { "ss", 1, "Stra\xc3\x9f" "e", 4, 2 },
+};
+
+// pattern NULL stands for a missing pattern
+typedef struct {
+    const char *pattern;
+    const char *err;
+} ErrorCase;
+
+static const ErrorCase errors[] = {
+    { NULL, "Missing pattern" },
+    { "(ab", "Missing )" },
+    { "ab)", "Unmatched )" },
+    { "[ab", "Missing ]" },
+    { "*a", "Nothing to repeat" },
+    { "a|+", "Nothing to repeat" },
+    { "a\\", "Trailing backslash" },
+    { "[z-a]", "Invalid class range" },
+    { "a{3,2}", "Invalid repeat range" },
+    { "a{101}", "Repeat count too large" },
+    { "((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((((a))))))))))))))))))))))))))))))))))))))))))))))))))))))))))))))))))",
+      "Pattern nested too deeply" },
+};
+
+static void test_matches(void) {
+    for (size_t i = 0; i < sizeof(matches) / sizeof(matches[0]); ++i) {
+        const MatchCase *m = &matches[i];
+        char err[128] = "";
+        int start = -1, len = -1;
+        TextRegex *re = text_regex_compile(m->pattern, m->icase, err, sizeof(err));
+
+        CHECK(re != NULL, "/%s/: %s", m->pattern, err);
+        if (!re) continue;
+        int found = text_regex_search(re, m->text, &start, &len);
+        if (m->start < 0) {
+            CHECK(!found, "/%s/ on \"%s\": matched at %d+%d", m->pattern, m->text, start, len);
+        } else {
+            CHECK(found && start == m->start && len == m->len, "/%s/ on \"%s\": got %d+%d, want %d+%d",
+                  m->pattern, m->text, found ? start : -1, found ? len : 0, m->start, m->len);
+        }
+        text_regex_free(re);
+    }
+}
+
+static void test_errors(void) {
+    for (size_t i = 0; i < sizeof(errors) / sizeof(errors[0]); ++i) {
+        const ErrorCase *e = &errors[i];
+        char err[128] = "";
+        TextRegex *re = text_regex_compile(e->pattern, 0, err, sizeof(err));
+
+        CHECK(re == NULL, "/%s/: compiled", e->pattern ? e->pattern : "(null)");
+        CHECK(strcmp(err, e->err) == 0, "/%s/: error \"%s\", want \"%s\"",
+              e->pattern ? e->pattern : "(null)", err, e->err);
+        text_regex_free(re);
+    }
+}
+
+int main(void) {
+    test_matches();
+    test_errors();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("test_text_regex: ok\n");
+    return 0;
+}
@@ -6,17 +6,25 @@
 #include <string.h>
 #include <time.h>
 
+#define WIDE_COLS 64           // columns of the wide table
+#define WIDE_PROJECTED 10      // columns the projected wide scenario reads
+#define CHECKPOINT_STRIDE 1024 // as the seek view's Go to row index
+#define INGEST_SAMPLE_ROWS 4096
+#define MAX_RESULTS 128
+
 static long long now_ns(void) {
     struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
     return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
 }
 
-static long get_rss_kb(void) {
+// A "Vm...:" line of /proc/self/status in KB, or -1
+static long status_kb(const char *field) {
     FILE *f = fopen("/proc/self/status", "r");
     if (!f) return -1;
     char line[256]; long kb = -1;
+    size_t len = strlen(field);
     while (fgets(line, sizeof(line), f)) {
-        if (strncmp(line, "VmRSS:", 6) == 0) {
+        if (strncmp(line, field, len) == 0) {
             char *p = line; while (*p && (*p < '0' || *p > '9')) p++;
             kb = strtol(p, NULL, 10); break;
         }
@@ -24,122 +32,447 @@ static long get_rss_kb(void) {
     fclose(f); return kb;
 }
 
+// Restarts VmHWM from the current RSS (Linux 4.0+), so each scenario
+// reports its own peak; without it the peak covers the whole run
+static void reset_peak_rss(void) {
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (!f) return;
+    fputs("5", f);
+    fclose(f);
+}
+
+// One scenario under one tuning: latencies are per timed operation (a
+// window read, a jump, or INGEST_SAMPLE_ROWS appended rows)
 typedef struct {
-    int cols;
-    long delivered;
+    const char *scenario;
+    int page_size;      // 0 = SQLite's default
+    int mmap_mb;        // -1 off, 0 the mode's default
+    long long rows;     // rows read or loaded
+    int ops;
+    double setup_sec;   // view, index and reader setup before the first op
+    double sec;
+    double p50_us, p95_us, p99_us, max_us;
+    long rss_delta_kb;
+    long peak_rss_kb;
+} bench_result;
+
+static bench_result results[MAX_RESULTS];
+static int result_count;
+static FILE *text_out; // stderr when the JSON goes to stdout
+
+typedef struct {
+    long long *ns;
+    int n, cap;
+    long long rows;
+    double setup_sec;
+    long long t0;
+    long rss0;
+} bench_run;
+
+static void run_start(bench_run *r, double setup_sec) {
+    memset(r, 0, sizeof(*r));
+    r->setup_sec = setup_sec;
+    reset_peak_rss();
+    r->rss0 = status_kb("VmRSS:");
+    r->t0 = now_ns();
+}
+
+static int run_sample(bench_run *r, long long ns, long long rows) {
+    if (r->n == r->cap) {
+        int cap = r->cap ? r->cap * 2 : 1024;
+        long long *ns_new = realloc(r->ns, (size_t)cap * sizeof(*ns_new));
+        if (!ns_new) return -1;
+        r->ns = ns_new; r->cap = cap;
+    }
+    r->ns[r->n++] = ns;
+    r->rows += rows;
+    return 0;
+}
+
+static int cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of the sorted samples, in microseconds
+static double percentile_us(const long long *sorted, int n, int pct) {
+    if (n == 0) return 0;
+    int rank = (int)(((long long)pct * n + 99) / 100);
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1] / 1e3;
+}
+
+static const char *page_size_label(int page_size, char *buf, size_t buf_sz) {
+    if (page_size) snprintf(buf, buf_sz, "%d", page_size); else snprintf(buf, buf_sz, "default");
+    return buf;
+}
+
+static const char *mmap_label(int mmap_mb, char *buf, size_t buf_sz) {
+    if (mmap_mb > 0) snprintf(buf, buf_sz, "%dMB", mmap_mb);
+    else snprintf(buf, buf_sz, "%s", mmap_mb < 0 ? "off" : "default");
+    return buf;
+}
+
+// Stores and prints the result, then frees the samples
+static void run_finish(bench_run *r, const char *scenario, int page_size, int mmap_mb) {
+    long long t1 = now_ns();
+    long rss1 = status_kb("VmRSS:");
+    bench_result *res = &results[result_count < MAX_RESULTS ? result_count++ : MAX_RESULTS - 1];
+
+    qsort(r->ns, (size_t)r->n, sizeof(*r->ns), cmp_ll);
+    res->scenario = scenario;
+    res->page_size = page_size;
+    res->mmap_mb = mmap_mb;
+    res->rows = r->rows;
+    res->ops = r->n;
+    res->setup_sec = r->setup_sec;
+    res->sec = (t1 - r->t0) / 1e9;
+    res->p50_us = percentile_us(r->ns, r->n, 50);
+    res->p95_us = percentile_us(r->ns, r->n, 95);
+    res->p99_us = percentile_us(r->ns, r->n, 99);
+    res->max_us = r->n ? r->ns[r->n - 1] / 1e3 : 0;
+    res->rss_delta_kb = (rss1 >= 0 && r->rss0 >= 0) ? rss1 - r->rss0 : -1;
+    res->peak_rss_kb = status_kb("VmHWM:");
+    free(r->ns);
+    r->ns = NULL;
+
+    char ps[16], mm[16];
+    fprintf(text_out, "page_size=%-7s mmap=%-7s %-16s %6d ops %9lld rows %8.3fs %10.0f rows/s"
+            "  p50 %7.0fus p95 %7.0fus p99 %7.0fus  RSS %+ld KB peak %ld KB\n",
+            page_size_label(page_size, ps, sizeof(ps)), mmap_label(mmap_mb, mm, sizeof(mm)), scenario,
+            res->ops, res->rows, res->sec, res->sec > 0 ? res->rows / res->sec : 0,
+            res->p50_us, res->p95_us, res->p99_us, res->rss_delta_kb, res->peak_rss_kb);
+}
+
+static void write_json(FILE *f, long rows, int page, int jumps) {
+    fprintf(f, "{\n  \"bench\": \"seekdb\",\n  \"schema\": 1,\n  \"timestamp\": %lld,\n"
+            "  \"sqlite_version\": \"%s\",\n  \"rows\": %ld,\n  \"page\": %d,\n  \"jumps\": %d,\n"
+            "  \"results\": [\n", (long long)time(NULL), sqlite3_libversion(), rows, page, jumps);
+    for (int i = 0; i < result_count; ++i) {
+        const bench_result *r = &results[i];
+        fprintf(f, "    {\"scenario\": \"%s\", \"page_size\": %d, \"mmap_mb\": %d, \"rows\": %lld, \"ops\": %d, "
+                "\"setup_sec\": %.6f, \"sec\": %.6f, \"rows_per_sec\": %.1f, "
+                "\"p50_us\": %.1f, \"p95_us\": %.1f, \"p99_us\": %.1f, \"max_us\": %.1f, "
+                "\"rss_delta_kb\": %ld, \"peak_rss_kb\": %ld}%s\n",
+                r->scenario, r->page_size, r->mmap_mb, r->rows, r->ops,
+                r->setup_sec, r->sec, r->sec > 0 ? r->rows / r->sec : 0,
+                r->p50_us, r->p95_us, r->p99_us, r->max_us,
+                r->rss_delta_kb, r->peak_rss_kb, i + 1 < result_count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+// Keys of the first and last row of a window, in delivery order
+typedef struct {
+    int key_col;
+    int n;
+    long long first_id, last_id;
 } cb_ctx;
 
-static bool count_rows(void *user, sqlite3_stmt *row) {
-    (void)row;
+static bool track_row(void *user, sqlite3_stmt *row) {
     cb_ctx *ctx = (cb_ctx*)user;
-    ctx->delivered++;
+    long long id = sqlite3_column_int64(row, ctx->key_col);
+    if (ctx->n++ == 0) ctx->first_id = id;
+    ctx->last_id = id;
     return true; // deliver full window
 }
 
 static void usage(const char *argv0) {
-    fprintf(stderr, "Usage: %s [rows=200000] [page=200]\n", argv0);
+    fprintf(stderr, "Usage: %s [--json FILE|-] [--jumps N] [rows=200000] [page=200]\n", argv0);
 }
 
-int main(int argc, char **argv) {
-    long rows = 200000; // default 200k for quick run
-    int page = 200;     // default window size
-    if (argc > 1) rows = strtol(argv[1], NULL, 10);
-    if (argc > 2) page = (int)strtol(argv[2], NULL, 10);
-    if (rows <= 0 || page <= 0) { usage(argv[0]); return 2; }
+// Pages through the whole view (first window, then seek_after), timing
+// each window; *tail_id gets the key of the last row
+static int walk_forward(seekdb *s, int key_col, int page, bench_run *r, long long *tail_id,
+                        char *err, size_t errlen) {
+    cb_ctx ctx = { .key_col = key_col };
+    for (int first = 1;; first = 0) {
+        long long anchor = ctx.last_id;
+        ctx.n = 0;
+        long long t = now_ns();
+        int got = first ? seekdb_seek_first(s, page, track_row, &ctx, err, errlen)
+                        : seekdb_seek_after(s, anchor, page, track_row, &ctx, err, errlen);
+        long long ns = now_ns() - t;
+        if (got < 0) return -1;
+        if (got == 0) break;
+        if (run_sample(r, ns, got) != 0) { snprintf(err, errlen, "oom"); return -1; }
+        if (tail_id) *tail_id = ctx.last_id;
+        if (got < page) break;
+    }
+    return 0;
+}
 
-    char err[256] = {0};
-    seekdb *s = seekdb_open(NULL, SEEKDB_MODE_LOW_RAM, err, sizeof err);
-    if (!s) { fprintf(stderr, "open failed: %s\n", err); return 1; }
-
-    // Create simple table
-    if (seekdb_ensure_table(s, "t", "val INTEGER, name TEXT", err, sizeof err) != 0) {
-        fprintf(stderr, "ensure_table failed: %s\n", err); return 1;
-    }
-
-    // Bulk insert rows in a single transaction for speed
-    sqlite3 *db = NULL; // access internal db via header? Not exposed; prepare using sqlite3 API not available here.
-    // Work around by opening a new handle to the temp DB file is not exposed either; instead use a simple approach:
-    // Prepare insert with sqlite3_exec via multiple statements; slower but fine for smoke. For speed, keep <= 200k default.
-    {
-        // Create a temporary table to speed name generation
-        // Start transaction
-        if (seekdb_set_view(s, "t", "1=0", "_ttb_id", "_ttb_id", err, sizeof err) < 0) {
-            // ignore view error before key exists; proceed with inserts then key
-        }
-        // Use sqlite3_exec
-        // Begin
-        sqlite3 *conn = NULL;
-        // Ugly: reach internal by casting; documented for bench only.
-        conn = *(sqlite3**)((char*)s + 0); // relies on struct layout: first field sqlite3* db
-        if (!conn) { fprintf(stderr, "internal db missing\n"); return 1; }
-        char *emsg = NULL;
-        if (sqlite3_exec(conn, "BEGIN;", NULL, NULL, &emsg) != SQLITE_OK) {
-            fprintf(stderr, "BEGIN failed: %s\n", emsg?emsg:"err"); if (emsg) sqlite3_free(emsg); return 1;
-        }
-        sqlite3_stmt *st = NULL;
-        if (sqlite3_prepare_v2(conn, "INSERT INTO t(val, name) VALUES(?, ?);", -1, &st, NULL) != SQLITE_OK) {
-            fprintf(stderr, "prepare failed: %s\n", sqlite3_errmsg(conn)); return 1;
-        }
-        for (long i = 1; i <= rows; ++i) {
-            sqlite3_reset(st);
-            sqlite3_bind_int64(st, 1, (sqlite3_int64)i);
-            char buf[32]; snprintf(buf, sizeof(buf), "row%ld", i);
-            sqlite3_bind_text(st, 2, buf, -1, SQLITE_TRANSIENT);
-            if (sqlite3_step(st) != SQLITE_DONE) {
-                fprintf(stderr, "insert failed at %ld: %s\n", i, sqlite3_errmsg(conn)); return 1;
-            }
+// Pages from the row with key tail_id back to the start; seek_before
+// delivers nearest first, so the next anchor is the last row delivered
+static int walk_backward(seekdb *s, int key_col, long long tail_id, int page, bench_run *r,
+                         char *err, size_t errlen) {
+    cb_ctx ctx = { .key_col = key_col, .last_id = tail_id };
+    for (;;) {
+        long long anchor = ctx.last_id;
+        ctx.n = 0;
+        long long t = now_ns();
+        int got = seekdb_seek_before(s, anchor, page, track_row, &ctx, err, errlen);
+        long long ns = now_ns() - t;
+        if (got < 0) return -1;
+        if (got == 0) break;
+        if (run_sample(r, ns, got) != 0) { snprintf(err, errlen, "oom"); return -1; }
+        if (got < page) break;
+    }
+    return 0;
+}
+
+// Go to row: a random position resolved through the checkpoint index,
+// then the window at that row
+static int random_jumps(seekdb *s, const seekdb_checkpoints *cp, int key_col, int page, int jumps,
+                        bench_run *r, char *err, size_t errlen) {
+    long long total = seekdb_checkpoints_rows(cp);
+    unsigned long long x = 0x9E3779B97F4A7C15ULL; // fixed seed: the same jumps every run
+    cb_ctx ctx = { .key_col = key_col };
+
+    if (total <= 0) return 0;
+    for (int i = 0; i < jumps; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        long long pos = (long long)(x % (unsigned long long)total), id;
+        ctx.n = 0;
+        long long t = now_ns();
+        int found = seekdb_id_at_position(s, cp, pos, &id, err, errlen);
+        int got = found > 0 ? seekdb_seek_by_id(s, id, page, track_row, &ctx, err, errlen) : found;
+        long long ns = now_ns() - t;
+        if (got < 0) return -1;
+        if (run_sample(r, ns, got) != 0) { snprintf(err, errlen, "oom"); return -1; }
+    }
+    return 0;
+}
+
+// Bulk loads rows through the ingest API (the key index is built at
+// commit), timing every INGEST_SAMPLE_ROWS appended rows
+static int ingest(seekdb *s, const char *table, const char *const *cols, int count, long rows,
+                  void (*fill)(long i, char (*vals)[32], int count), const char **row,
+                  char (*vals)[32], bench_run *r, char *err, size_t errlen) {
+    if (seekdb_ingest_begin(s, table, cols, count, "_ttb_id", err, errlen) != 0) return -1;
+    long long t = now_ns();
+    for (long i = 1; i <= rows; ++i) {
+        fill(i, vals, count);
+        if (seekdb_ingest_append_row(s, row, err, errlen) != 0) { seekdb_ingest_abort(s); return -1; }
+        if (i % INGEST_SAMPLE_ROWS == 0 || i == rows) {
+            long long t1 = now_ns();
+            long long n = i % INGEST_SAMPLE_ROWS ? i % INGEST_SAMPLE_ROWS : INGEST_SAMPLE_ROWS;
+            if (run_sample(r, t1 - t, n) != 0) { seekdb_ingest_abort(s); snprintf(err, errlen, "oom"); return -1; }
+            t = t1;
         }
-        sqlite3_finalize(st);
-        if (sqlite3_exec(conn, "COMMIT;", NULL, NULL, &emsg) != SQLITE_OK) {
-            fprintf(stderr, "COMMIT failed: %s\n", emsg?emsg:"err"); if (emsg) sqlite3_free(emsg); return 1;
+    }
+    return seekdb_ingest_commit(s, err, errlen) == rows ? 0 : -1;
+}
+
+static void fill_narrow(long i, char (*vals)[32], int count) {
+    (void)count;
+    snprintf(vals[0], sizeof(vals[0]), "%ld", i);
+    snprintf(vals[1], sizeof(vals[1]), "row%ld", (i * 7919) % 1000003); // not in val order
+}
+
+// Integer, real and text columns in turn
+static void fill_wide(long i, char (*vals)[32], int count) {
+    for (int c = 0; c < count; ++c) {
+        switch (c % 3) {
+            case 0: snprintf(vals[c], sizeof(vals[c]), "%ld", i * (c + 1)); break;
+            case 1: snprintf(vals[c], sizeof(vals[c]), "%.3f", i / (double)(c + 1)); break;
+            default: snprintf(vals[c], sizeof(vals[c]), "c%d_%ld", c, i); break;
         }
-        if (emsg) sqlite3_free(emsg);
+    }
+}
+
+// Loads the narrow table "t" (rows) and the wide table "w" (rows / 4)
+// into a new spill database made with the given page size
+static seekdb *load_spill(long rows, int page_size, char *err, size_t errlen) {
+    seekdb_tuning tuning = {0};
+    tuning.page_size = page_size;
+    seekdb_set_tuning(&tuning);
+
+    seekdb *s = seekdb_open(NULL, SEEKDB_MODE_LOW_RAM, err, errlen);
+    if (!s) return NULL;
+
+    static const char *const narrow_cols[] = { "val", "name" };
+    static const char *const narrow_decls[] = { "INTEGER", "TEXT" };
+    char vals[WIDE_COLS][32];
+    const char *row[WIDE_COLS];
+    const char *wide_cols[WIDE_COLS], *wide_decls[WIDE_COLS];
+    char wide_names[WIDE_COLS][8];
+    bench_run r;
+
+    for (int c = 0; c < WIDE_COLS; ++c) {
+        snprintf(wide_names[c], sizeof(wide_names[c]), "c%d", c);
+        wide_cols[c] = wide_names[c];
+        wide_decls[c] = c % 3 == 0 ? "INTEGER" : (c % 3 == 1 ? "REAL" : "TEXT");
+        row[c] = vals[c];
+    }
+    if (seekdb_ensure_table_columns(s, "t", narrow_cols, narrow_decls, 2, err, errlen) != 0 ||
+        seekdb_ensure_table_columns(s, "w", wide_cols, wide_decls, WIDE_COLS, err, errlen) != 0) {
+        seekdb_close(s); return NULL;
     }
 
-    if (seekdb_ensure_stable_key(s, "t", "_ttb_id", err, sizeof err) != 0) {
-        fprintf(stderr, "ensure_key failed: %s\n", err); return 1;
+    run_start(&r, 0);
+    if (ingest(s, "t", narrow_cols, 2, rows, fill_narrow, row, vals, &r, err, errlen) != 0) {
+        free(r.ns); seekdb_close(s); return NULL;
     }
-    if (seekdb_set_view(s, "t", "1=1", "val ASC", "_ttb_id", err, sizeof err) != 0) {
-        fprintf(stderr, "set_view failed: %s\n", err); return 1;
+    run_finish(&r, "ingest", page_size, tuning.mmap_mb);
+
+    run_start(&r, 0);
+    if (ingest(s, "w", wide_cols, WIDE_COLS, rows / 4 ? rows / 4 : 1, fill_wide, row, vals, &r, err, errlen) != 0) {
+        free(r.ns); seekdb_close(s); return NULL;
     }
+    run_finish(&r, "ingest_wide", page_size, tuning.mmap_mb);
+    return s;
+}
 
-    cb_ctx ctx = {0};
-    long rss0 = get_rss_kb();
+// A view the read scenarios page through: set on the writer (which
+// creates its indexes), then copied to a fresh reader
+typedef struct {
+    const char *scenario;
+    const char *table;
+    seekdb_filter filter;  // column NULL for none
+    seekdb_sort sort;      // column NULL for key order
+    int projected;         // WIDE_PROJECTED leading columns plus the key
+} view_case;
 
-    long long t0 = now_ns();
-    // Simulate scroll down: first page then repeated after
-    ctx.delivered = 0;
-    long long last_id = 0;
-    int n = 0;
-    int got = 0;
-    // first page
-    got = seekdb_seek_first(s, page, count_rows, &ctx, err, sizeof err);
-    if (got < 0) { fprintf(stderr, "seek_first error: %s\n", err); return 1; }
-    n += got; last_id = page; // because val asc matches _ttb_id after backfill
+// Sets vc's view on s and opens a reader with it under mmap_mb; *key_col
+// gets the key's column in the reader's rows
+static seekdb *open_view(seekdb *s, const view_case *vc, int page_size, int mmap_mb, int *key_col,
+                         char *err, size_t errlen) {
+    seekdb_tuning tuning = {0};
+    int proj[WIDE_PROJECTED + 1];
 
-    while (n < rows) {
-        got = seekdb_seek_after(s, last_id, page, count_rows, &ctx, err, sizeof err);
-        if (got < 0) { fprintf(stderr, "seek_after error: %s\n", err); return 1; }
-        if (got == 0) break;
-        n += got;
-        last_id += got;
-        if (n >= rows) break;
+    if (seekdb_set_view_spec(s, vc->table, vc->filter.column ? &vc->filter : NULL,
+                             vc->sort.column ? &vc->sort : NULL, "_ttb_id", err, errlen) != 0) return NULL;
+    if ((*key_col = seekdb_view_key_column(s, err, errlen)) < 0) return NULL;
+    if (vc->projected) {
+        for (int i = 0; i < WIDE_PROJECTED; ++i) proj[i] = i;
+        proj[WIDE_PROJECTED] = *key_col;
+        *key_col = WIDE_PROJECTED;
     }
-    long long t1 = now_ns();
-    long rss1 = get_rss_kb();
+    if (seekdb_set_projection(s, proj, vc->projected ? WIDE_PROJECTED + 1 : 0, err, errlen) != 0) return NULL;
+
+    tuning.page_size = page_size;
+    tuning.mmap_mb = mmap_mb;
+    seekdb_set_tuning(&tuning);
+    return seekdb_open_reader(s, err, errlen);
+}
+
+// Forward cold (fresh connection, empty page cache) and warm (same
+// connection again), backward from the end, then random jumps
+static int bench_navigation(seekdb *s, long rows, int page, int jumps, int page_size, int mmap_mb,
+                            char *err, size_t errlen) {
+    static const view_case base = { "forward_cold", "t", { NULL, 0, NULL }, { "val", 0 }, 0 };
+    long long tail_id = 0;
+    int key_col;
+    bench_run r;
+
+    long long t = now_ns();
+    seekdb *rd = open_view(s, &base, page_size, mmap_mb, &key_col, err, errlen);
+    if (!rd) return -1;
+    double setup = (now_ns() - t) / 1e9;
 
-    double sec = (t1 - t0) / 1e9;
-    printf("Rows: %ld, Page: %d, Time: %.3fs, Throughput: %.1f rows/s\n", rows, page, sec, rows / sec);
-    printf("RSS start: %ld KB, RSS end: %ld KB, Delta: %ld KB\n", rss0, rss1, (rss1>=0&&rss0>=0)?(rss1-rss0):-1);
+    static const char *const passes[] = { "forward_cold", "forward_warm" };
+    for (int i = 0; i < 2; ++i) {
+        run_start(&r, i ? 0 : setup);
+        if (walk_forward(rd, key_col, page, &r, &tail_id, err, errlen) != 0) goto fail;
+        if (r.rows != rows) { snprintf(err, errlen, "%s read %lld of %ld rows", passes[i], r.rows, rows); goto fail; }
+        run_finish(&r, passes[i], page_size, mmap_mb);
+    }
+
+    run_start(&r, 0);
+    if (walk_backward(rd, key_col, tail_id, page, &r, err, errlen) != 0) goto fail;
+    run_finish(&r, "backward", page_size, mmap_mb);
+
+    t = now_ns();
+    seekdb_checkpoints *cp = seekdb_checkpoints_build(rd, CHECKPOINT_STRIDE, err, errlen);
+    if (!cp) goto fail;
+    run_start(&r, (now_ns() - t) / 1e9);
+    int rc = random_jumps(rd, cp, key_col, page, jumps, &r, err, errlen);
+    seekdb_checkpoints_free(cp);
+    if (rc != 0) goto fail;
+    run_finish(&r, "random_jump", page_size, mmap_mb);
+    seekdb_close(rd);
+    return 0;
+
+fail:
+    free(r.ns);
+    seekdb_close(rd);
+    return -1;
+}
 
-    // Quick upward paging smoke from near end
-    long long first_id = last_id;
-    ctx.delivered = 0;
-    got = seekdb_seek_before(s, first_id, page, count_rows, &ctx, err, sizeof err);
-    if (got < 0) { fprintf(stderr, "seek_before error: %s\n", err); return 1; }
-    printf("seek_before delivered: %d\n", got);
+// One forward pass over each filtered, sorted and wide view on a fresh
+// reader; setup includes building the view's index on first use
+static int bench_views(seekdb *s, long rows, int page, int page_size, int mmap_mb, char *err, size_t errlen) {
+    char half[32];
+    snprintf(half, sizeof(half), "%ld", rows / 2);
+    const view_case cases[] = {
+        { "filter_contains", "t", { "name", SEEKDB_FILTER_CONTAINS, "77" }, { NULL, 0 }, 0 },
+        { "filter_range", "t", { "val", SEEKDB_FILTER_GT, half }, { NULL, 0 }, 0 },
+        { "sorted_text", "t", { NULL, 0, NULL }, { "name", 1 }, 0 },
+        { "wide", "w", { NULL, 0, NULL }, { NULL, 0 }, 0 },
+        { "wide_projected", "w", { NULL, 0, NULL }, { NULL, 0 }, 1 },
+    };
 
-    seekdb_close(s);
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        int key_col;
+        bench_run r;
+        long long t = now_ns();
+        seekdb *rd = open_view(s, &cases[i], page_size, mmap_mb, &key_col, err, errlen);
+        if (!rd) return -1;
+        run_start(&r, (now_ns() - t) / 1e9);
+        if (walk_forward(rd, key_col, page, &r, NULL, err, errlen) != 0) {
+            free(r.ns); seekdb_close(rd); return -1;
+        }
+        run_finish(&r, cases[i].scenario, page_size, mmap_mb);
+        seekdb_close(rd);
+    }
     return 0;
 }
 
+int main(int argc, char **argv) {
+    long rows = 200000; // default 200k for quick run
+    int page = 200;     // default window size
+    int jumps = 500;
+    const char *json_path = NULL;
+    int pos = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) json_path = argv[++i];
+        else if (strcmp(argv[i], "--jumps") == 0 && i + 1 < argc) jumps = (int)strtol(argv[++i], NULL, 10);
+        else if (argv[i][0] == '-') { usage(argv[0]); return 2; }
+        else if (pos++ == 0) rows = strtol(argv[i], NULL, 10);
+        else page = (int)strtol(argv[i], NULL, 10);
+    }
+    if (rows <= 0 || page <= 0 || jumps < 0) { usage(argv[0]); return 2; }
+    text_out = json_path && strcmp(json_path, "-") == 0 ? stderr : stdout;
+
+    // Page sizes for new spill databases and mmap windows (MB, -1 = off)
+    // to compare; each database runs the read scenarios once per mmap
+    // setting through readers opened with it
+    static const int page_sizes[] = { 0, 16384 };
+    static const int mmap_mbs[] = { -1, 256 };
+    char err[256] = {0};
+
+    for (size_t p = 0; p < sizeof(page_sizes) / sizeof(page_sizes[0]); ++p) {
+        seekdb *s = load_spill(rows, page_sizes[p], err, sizeof err);
+        if (!s) { fprintf(stderr, "load failed: %s\n", err); return 1; }
+
+        for (size_t m = 0; m < sizeof(mmap_mbs) / sizeof(mmap_mbs[0]); ++m) {
+            if (bench_navigation(s, rows, page, jumps, page_sizes[p], mmap_mbs[m], err, sizeof err) != 0 ||
+                bench_views(s, rows, page, page_sizes[p], mmap_mbs[m], err, sizeof err) != 0) {
+                fprintf(stderr, "scan error: %s\n", err);
+                seekdb_close(s);
+                return 1;
+            }
+        }
+        seekdb_close(s);
+    }
+
+    if (json_path) {
+        FILE *f = strcmp(json_path, "-") == 0 ? stdout : fopen(json_path, "w");
+        if (!f) { perror(json_path); return 1; }
+        write_json(f, rows, page, jumps);
+        if (f != stdout && fclose(f) != 0) { perror(json_path); return 1; }
+    }
+    return 0;
+}